@@ -37,6 +37,7 @@
 #include "libslic3r/Config.hpp"
 #include "libslic3r/Geometry.hpp"
 #include "libslic3r/GCode/PostProcessor.hpp"
+#include "libslic3r/GCode/ThumbnailRenderer.hpp"
 #include "libslic3r/Model.hpp"
 #include "libslic3r/ModelArrange.hpp"
 #include "libslic3r/Platform.hpp"
@@ -1284,7 +1285,18 @@ int CLI::run(int argc, char **argv)
         }
         bool opengl_valid = opengl_mgr.init_gl();
         if (!opengl_valid) {
-            BOOST_LOG_TRIVIAL(error) << "init opengl failed! skip thumbnail generating" << std::endl;
+            // No display or GPU, e.g. on a slicing server. Render the plate thumbnails on the CPU instead.
+            BOOST_LOG_TRIVIAL(error) << "init opengl failed! render thumbnails in software" << std::endl;
+            Model &model = m_models[0];
+            for (int i = 0; i < partplate_list.get_plate_count(); i++) {
+                Slic3r::GUI::PartPlate *part_plate      = partplate_list.get_plate(i);
+                ThumbnailData *         thumbnail_data  = new ThumbnailData();
+                unsigned int thumbnail_width = 256, thumbnail_height = 256;
+                const ThumbnailsParams thumbnail_params = {{}, false, true, true, true, i};
+                render_thumbnail_software(*thumbnail_data, thumbnail_width, thumbnail_height, thumbnail_params,
+                    model.objects, part_plate->get_build_volume(), colors_out);
+                thumbnails.push_back(thumbnail_data);
+            }
         }
         else {
             BOOST_LOG_TRIVIAL(info) << "glewInit Sucess." << std::endl;
@@ -772,15 +772,37 @@ bool ClipperBase::AddPath(const Path &pg, PolyType PolyTyp, bool Closed)
     return false;
 
   // Allocate a new edge array.
-  std::vector<TEdge> edges(highI + 1);
+  std::vector<TEdge> edges = AllocateEdges(highI + 1);
   // Fill in the edge array.
   bool result = AddPathInternal(pg, highI, PolyTyp, Closed, edges.data());
   if (result)
     // Success, remember the edge array.
     m_edges.emplace_back(std::move(edges));
+  else
+    RecycleEdges(std::move(edges));
   return result;
 }
 
+std::vector<TEdge> ClipperBase::AllocateEdges(size_t num_edges)
+{
+  std::vector<TEdge> edges;
+  if (! m_edgesFree.empty()) {
+    edges = std::move(m_edgesFree.back());
+    m_edgesFree.pop_back();
+    m_edgesFreeSize -= edges.capacity();
+  }
+  edges.assign(num_edges, TEdge());
+  return edges;
+}
+
+void ClipperBase::RecycleEdges(std::vector<TEdge> &&edges)
+{
+  if (m_edgesFreeSize + edges.capacity() <= MaxRetainedEdges) {
+    m_edgesFreeSize += edges.capacity();
+    m_edgesFree.emplace_back(std::move(edges));
+  }
+}
+
 bool ClipperBase::AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, bool Closed, TEdge* edges)
 {
   CLIPPERLIB_PROFILE_FUNC();
@@ -963,6 +985,8 @@ void ClipperBase::Clear()
 {
   CLIPPERLIB_PROFILE_FUNC();
   m_MinimaList.clear();
+  for (std::vector<TEdge> &edges : m_edges)
+    RecycleEdges(std::move(edges));
   m_edges.clear();
 #ifndef CLIPPERLIB_INT32
   m_UseFullRange = false;
@@ -1047,6 +1071,7 @@ IntRect ClipperBase::GetBounds()
 
 Clipper::Clipper(int initOptions) : 
   ClipperBase(),
+  m_OutPtsChunk(0),
   m_OutPtsFree(nullptr),
   m_OutPtsChunkSize(32),
   m_OutPtsChunkLast(32),
@@ -1067,7 +1092,7 @@ void Clipper::Reset()
 {
   CLIPPERLIB_PROFILE_FUNC();
   ClipperBase::Reset();
-  m_Scanbeam = std::priority_queue<cInt>();
+  m_Scanbeam.clear();
   m_Maxima.clear();
   m_ActiveEdges = 0;
   m_SortedEdges = 0;
@@ -1188,11 +1213,16 @@ OutPt* Clipper::AllocateOutPt()
     pt = m_OutPtsFree;
     m_OutPtsFree = pt->Next;
   } else if (m_OutPtsChunkLast < m_OutPtsChunkSize) {
-    // Get a point from the last chunk.
-    pt = m_OutPts.back() + (m_OutPtsChunkLast ++);
+    // Get a point from the current chunk.
+    pt = m_OutPts[m_OutPtsChunk] + (m_OutPtsChunkLast ++);
+  } else if (m_OutPtsChunk + 1 < m_OutPts.size()) {
+    // The current chunk is full. Continue with a chunk retained from the previous Execute().
+    pt = m_OutPts[++ m_OutPtsChunk];
+    m_OutPtsChunkLast = 1;
   } else {
     // The last chunk is full. Allocate a new one.
     m_OutPts.push_back(new OutPt[m_OutPtsChunkSize]);
+    m_OutPtsChunk = m_OutPts.size() - 1;
     m_OutPtsChunkLast = 1;
     pt = m_OutPts.back();
   }
@@ -1201,14 +1231,28 @@ OutPt* Clipper::AllocateOutPt()
 
 void Clipper::DisposeAllOutRecs()
 {
-  for (OutPt *pts : m_OutPts)
-    delete[] pts;
   for (OutRec *rec : m_PolyOuts)
     delete rec;
+  m_PolyOuts.clear();
+  // Keep the output point chunks for the next Execute().
+  if (m_OutPts.size() > MaxRetainedOutPtChunks) {
+    for (size_t i = MaxRetainedOutPtChunks; i < m_OutPts.size(); ++ i)
+      delete[] m_OutPts[i];
+    m_OutPts.resize(MaxRetainedOutPtChunks);
+  }
+  m_OutPtsFree = nullptr;
+  m_OutPtsChunk = 0;
+  m_OutPtsChunkLast = m_OutPts.empty() ? m_OutPtsChunkSize : 0;
+}
+
+void Clipper::ReleaseOutPts()
+{
+  for (OutPt *pts : m_OutPts)
+    delete[] pts;
   m_OutPts.clear();
   m_OutPtsFree = nullptr;
+  m_OutPtsChunk = 0;
   m_OutPtsChunkLast = m_OutPtsChunkSize;
-  m_PolyOuts.clear();
 }
 //------------------------------------------------------------------------------
 
@@ -3439,7 +3483,9 @@ void ClipperOffset::Execute(Paths& solution, double delta)
   DoOffset(delta);
   
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.Clear();
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3460,6 +3506,8 @@ void ClipperOffset::Execute(Paths& solution, double delta)
     if (! solution.empty())
       solution.erase(solution.begin());
   }
+  // Release the input edges to the reuse pool.
+  clpr.Clear();
 }
 //------------------------------------------------------------------------------
 
@@ -3470,7 +3518,9 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
   DoOffset(delta);
 
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.Clear();
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3491,6 +3541,8 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
     //remove the outer PolyNode rectangle ...
     solution.RemoveOutermostPolygon();
   }
+  // Release the input edges to the reuse pool.
+  clpr.Clear();
 }
 //------------------------------------------------------------------------------
 
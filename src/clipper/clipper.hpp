@@ -298,6 +298,11 @@ public:
 #endif // CLIPPERLIB_INT32
     m_HasOpenPaths(false) {}
   ~ClipperBase() { Clear(); }
+  // Clear() keeps some of the edge arrays for the next AddPath() / AddPaths(),
+  // so that a Clipper instance reused for many small operations does not hit
+  // the allocator for each of them.
+  // Upper bound of the number of edges retained after Clear().
+  static constexpr size_t MaxRetainedEdges = 16384;
   bool AddPath(const Path &pg, PolyType PolyTyp, bool Closed);
 
   template<typename PathsProvider>
@@ -330,7 +335,7 @@ public:
       return false;
 
     // Allocate a new edge array.
-    std::vector<TEdge> edges(num_edges_total);
+    std::vector<TEdge> edges = AllocateEdges(num_edges_total);
     // Fill in the edge array.
     bool result = false;
     TEdge *p_edge = edges.data();
@@ -348,6 +353,8 @@ public:
     if (result)
       // At least some edges were generated. Remember the edge array.
       m_edges.emplace_back(std::move(edges));
+    else
+      RecycleEdges(std::move(edges));
     return result;
   }
 
@@ -359,6 +366,9 @@ public:
   void PreserveCollinear(bool value) {m_PreserveCollinear = value;};
 protected:
   bool AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, bool Closed, TEdge* edges);
+  // Returns a zero initialized edge array, recycled from m_edgesFree if possible.
+  std::vector<TEdge> AllocateEdges(size_t num_edges);
+  void RecycleEdges(std::vector<TEdge> &&edges);
   TEdge* AddBoundsToLML(TEdge *e, bool IsClosed);
   void Reset();
   TEdge* ProcessBound(TEdge* E, bool IsClockwise);
@@ -378,6 +388,9 @@ protected:
 
   // A vector of edges per each input path.
   std::vector<std::vector<TEdge>> m_edges;
+  // Edge arrays released by Clear() for reuse, holding m_edgesFreeSize edges in total.
+  std::vector<std::vector<TEdge>> m_edgesFree;
+  size_t           m_edgesFreeSize { 0 };
   // Don't remove intermediate vertices of a collinear sequence of points.
   bool             m_PreserveCollinear;
   // Is any of the paths inserted by AddPath() or AddPaths() open?
@@ -389,7 +402,7 @@ class Clipper : public ClipperBase
 {
 public:
   Clipper(int initOptions = 0);
-  ~Clipper() { Clear(); }
+  ~Clipper() { Clear(); ReleaseOutPts(); }
   void Clear() { ClipperBase::Clear(); DisposeAllOutRecs(); }
   bool Execute(ClipType clipType,
       Paths &solution,
@@ -423,7 +436,11 @@ private:
   // Output polygons.
   std::vector<OutRec*>  m_PolyOuts;
   // Output points, allocated by a continuous sets of m_OutPtsChunkSize.
+  // The chunks survive DisposeAllOutRecs() up to MaxRetainedOutPtChunks and they are reused by the next Execute().
   std::vector<OutPt*>   m_OutPts;
+  static constexpr size_t MaxRetainedOutPtChunks = 256;
+  // Index of the chunk m_OutPtsChunkLast points into.
+  size_t                m_OutPtsChunk;
   // List of free output points, to be used before taking a point from m_OutPts or allocating a new chunk.
   OutPt                *m_OutPtsFree;
   size_t                m_OutPtsChunkSize;
@@ -433,8 +450,12 @@ private:
   std::vector<Join>     m_GhostJoins;
   std::vector<IntersectNode> m_IntersectList;
   ClipType              m_ClipType;
-  // A priority queue (a binary heap) of Y coordinates.
-  std::priority_queue<cInt> m_Scanbeam;
+  // A priority queue (a binary heap) of Y coordinates. Unlike std::priority_queue, it could be cleared
+  // without releasing its storage.
+  struct Scanbeam : public std::priority_queue<cInt> {
+    void clear() { this->c.clear(); }
+  };
+  Scanbeam              m_Scanbeam;
   // Maxima are collected by ProcessEdgesAtTopOfScanbeam(), consumed by ProcessHorizontal().
   std::vector<cInt>     m_Maxima;
   TEdge                *m_ActiveEdges;
@@ -481,6 +502,7 @@ private:
   void DisposeOutPt(OutPt *pt) { pt->Next = m_OutPtsFree; m_OutPtsFree = pt; }
   void DisposeOutPts(OutPt*& pp) { if (pp != nullptr) { pp->Prev->Next = m_OutPtsFree; m_OutPtsFree = pp; } }
   void DisposeAllOutRecs();
+  void ReleaseOutPts();
   bool ProcessIntersections(const cInt topY);
   void BuildIntersectList(const cInt topY);
   void ProcessEdgesAtTopOfScanbeam(const cInt topY);
@@ -534,6 +556,8 @@ private:
   // y: index of the lowest point in the lowest contour
   IntPoint m_lowest;
   PolyNode m_polyNodes;
+  // Cleans up the offset contours, reused by the consecutive Execute() calls.
+  Clipper  m_clipper;
 
   void FixOrientations();
   void DoOffset(double delta);
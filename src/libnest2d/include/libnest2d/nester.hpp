@@ -62,9 +62,20 @@ class _Item {
     };
 
     mutable Convexity convexity_ = Convexity::UNCHECKED;
-    mutable VertexConstIterator rmt_;    // rightmost top vertex
-    mutable VertexConstIterator lmb_;    // leftmost bottom vertex
-    mutable bool rmt_valid_ = false, lmb_valid_ = false;
+
+    // A vertex of tr_cache_. It is invalidated when the item is copied,
+    // as the iterator of the copy would point into tr_cache_ of the source.
+    struct VertexCache {
+        VertexConstIterator it;
+        bool valid = false;
+        VertexCache() = default;
+        VertexCache(const VertexCache&) {}
+        VertexCache& operator=(const VertexCache&) { valid = false; return *this; }
+    };
+    mutable VertexCache rmt_;    // rightmost top vertex
+    mutable VertexCache lmb_;    // leftmost bottom vertex
+    mutable size_t shape_hash_ = 0;
+    mutable bool shape_hash_valid_ = false;
     mutable struct BBCache {
         Box bb; bool valid;
         BBCache(): valid(false) {}
@@ -333,7 +344,8 @@ public:
     {
         if(rotation_ != rot) {
             rotation_ = rot; has_rotation_ = true; tr_cache_valid_ = false;
-            rmt_valid_ = false; lmb_valid_ = false;
+            rmt_.valid = false; lmb_.valid = false;
+            shape_hash_valid_ = false;
             bb_cache_.valid = false;
         }
     }
@@ -354,7 +366,7 @@ public:
         if(has_rotation_) sl::rotate(cpy, rotation_);
         if(has_translation_) sl::translate(cpy, translation_);
         tr_cache_ = cpy; tr_cache_valid_ = true;
-        rmt_valid_ = false; lmb_valid_ = false;
+        rmt_.valid = false; lmb_.valid = false;
 
         return tr_cache_;
     }
@@ -397,21 +409,42 @@ public:
     }
 
     inline Vertex rightmostTopVertex() const {
-        if(!rmt_valid_ || !tr_cache_valid_) {  // find max x and max y vertex
+        if(!rmt_.valid || !tr_cache_valid_) {  // find max x and max y vertex
             auto& tsh = transformedShape();
-            rmt_ = std::max_element(sl::cbegin(tsh), sl::cend(tsh), vsort);
-            rmt_valid_ = true;
+            rmt_.it = std::max_element(sl::cbegin(tsh), sl::cend(tsh), vsort);
+            rmt_.valid = true;
         }
-        return *rmt_;
+        return *rmt_.it;
     }
 
     inline Vertex leftmostBottomVertex() const {
-        if(!lmb_valid_ || !tr_cache_valid_) {  // find min x and min y vertex
+        if(!lmb_.valid || !tr_cache_valid_) {  // find min x and min y vertex
+            auto& tsh = transformedShape();
+            lmb_.it = std::min_element(sl::cbegin(tsh), sl::cend(tsh), vsort);
+            lmb_.valid = true;
+        }
+        return *lmb_.it;
+    }
+
+    /**
+     * @brief Hash of the outer contour of the transformed shape taken relative
+     * to its leftmost bottom vertex. Items which differ only in their
+     * translation have the same hash, thus it can be used as a key for caching
+     * the no-fit polygons.
+     */
+    inline size_t shapeHash() const {
+        if(!shape_hash_valid_) {
             auto& tsh = transformedShape();
-            lmb_ = std::min_element(sl::cbegin(tsh), sl::cend(tsh), vsort);
-            lmb_valid_ = true;
+            Vertex ref = leftmostBottomVertex();
+            size_t h = sl::contourVertexCount(tsh);
+            for(auto it = sl::cbegin(tsh); it != sl::cend(tsh); ++it) {
+                hashCombine(h, size_t(getX(*it) - getX(ref)));
+                hashCombine(h, size_t(getY(*it) - getY(ref)));
+            }
+            shape_hash_ = h;
+            shape_hash_valid_ = true;
         }
-        return *lmb_;
+        return shape_hash_;
     }
 
     //Static methods:
@@ -445,13 +478,19 @@ private:
     inline void invalidateCache() const BP2D_NOEXCEPT
     {
         tr_cache_valid_ = false;
-        lmb_valid_ = false; rmt_valid_ = false;
+        lmb_.valid = false; rmt_.valid = false;
         area_cache_valid_ = false;
         inflate_cache_valid_ = false;
+        shape_hash_valid_ = false;
         bb_cache_.valid = false;
         convexity_ = Convexity::UNCHECKED;
     }
 
+    static inline void hashCombine(size_t& seed, size_t v)
+    {
+        seed ^= v + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+
     static inline bool vsort(const Vertex& v1, const Vertex& v2)
     {
         TCompute<Vertex> x1 = getX(v1), x2 = getX(v2);
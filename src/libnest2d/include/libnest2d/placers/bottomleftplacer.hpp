@@ -32,6 +32,9 @@ struct BLConfig {
     std::vector<_Item<RawShape> > m_excluded_regions;
     _ItemGroup<RawShape> m_excluded_items;
     std::vector < _Item<RawShape> > m_nonprefered_regions;
+    // see NfpPConfig
+    bool parallel_bins = false;
+    std::function<void(int bin_idx, BLConfig &config)> on_new_bin;
 };
 
 template<class RawShape>
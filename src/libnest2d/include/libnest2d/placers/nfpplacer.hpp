@@ -8,6 +8,9 @@
 #include <iterator>
 #include <future>
 #include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
 
 #ifndef NDEBUG
 #include <iostream>
@@ -26,6 +29,108 @@
 namespace libnest2d {
 namespace placers {
 
+/**
+ * @brief A thread safe cache of no-fit polygons between pairs of items.
+ *
+ * The key is made of the shape hashes of the stationary and the orbiting item
+ * (see _Item::shapeHash()), which cover the rotation and inflation but not the
+ * translation of the items. The no-fit polygons are stored relative to the
+ * reference vertex of the stationary item, so a cached polygon is valid for
+ * any position of the items. A single cache may be shared by subsequent
+ * arrangements of the same shapes.
+ *
+ * As the hashes may collide, every entry also keeps a fingerprint of both
+ * shapes, which has to match exactly for a hit.
+ */
+template<class RawShape>
+class NfpCache {
+public:
+    using Key = std::pair<size_t, size_t>;
+    using Vertex = TPoint<RawShape>;
+    using Coord = TCoord<Vertex>;
+
+    /// Translation independent properties of a transformed item.
+    struct Fingerprint {
+        size_t vertex_count = 0;
+        double area = 0.;
+        // Bounding box corners relative to the leftmost bottom vertex.
+        Coord minx = 0, miny = 0, maxx = 0, maxy = 0;
+
+        Fingerprint() = default;
+        explicit Fingerprint(const _Item<RawShape>& item)
+        {
+            auto bb = item.boundingBox();
+            Vertex ref = item.leftmostBottomVertex();
+            vertex_count = shapelike::contourVertexCount(item.transformedShape());
+            area = item.area();
+            minx = getX(bb.minCorner()) - getX(ref);
+            miny = getY(bb.minCorner()) - getY(ref);
+            maxx = getX(bb.maxCorner()) - getX(ref);
+            maxy = getY(bb.maxCorner()) - getY(ref);
+        }
+
+        bool operator==(const Fingerprint& o) const
+        {
+            return vertex_count == o.vertex_count && area == o.area &&
+                   minx == o.minx && miny == o.miny && maxx == o.maxx && maxy == o.maxy;
+        }
+    };
+
+    /// The cache is cleared once it grows over max_size polygons.
+    explicit NfpCache(size_t max_size = 10000): max_size_(max_size) {}
+
+    bool find(const Key& key, const Fingerprint& stationary,
+              const Fingerprint& orbiter, RawShape& nfp) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = nfps_.find(key);
+        if(it == nfps_.end() || !(it->second.stationary == stationary) ||
+           !(it->second.orbiter == orbiter))
+            return false;
+        nfp = it->second.nfp;
+        return true;
+    }
+
+    void insert(const Key& key, const Fingerprint& stationary,
+                const Fingerprint& orbiter, RawShape&& nfp)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if(nfps_.size() >= max_size_) nfps_.clear();
+        // On a collision the newer pair of shapes takes over the entry.
+        nfps_[key] = Entry{ stationary, orbiter, std::move(nfp) };
+    }
+
+    void clear()
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        nfps_.clear();
+    }
+
+    size_t size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return nfps_.size();
+    }
+
+private:
+    struct KeyHash {
+        size_t operator()(const Key& key) const
+        {
+            return key.first ^ (key.second + 0x9e3779b97f4a7c15ULL + (key.first << 6) + (key.first >> 2));
+        }
+    };
+
+    struct Entry {
+        Fingerprint stationary;
+        Fingerprint orbiter;
+        RawShape nfp;
+    };
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<Key, Entry, KeyHash> nfps_;
+    size_t max_size_;
+};
+
 template<class RawShape>
 struct NfpPConfig {
 
@@ -90,6 +195,14 @@ struct NfpPConfig {
      */
     bool parallel = true;
 
+    /**
+     * @brief If true, the selection tries the candidate item on all the open
+     * bins concurrently instead of one bin after another. The callbacks are
+     * then called concurrently from several placers, thus any state they keep
+     * has to be bound to a single bin through on_new_bin.
+     */
+    bool parallel_bins = false;
+
     /**
      * @brief before_packing Callback that is called just before a search for
      * a new item's position is started. You can use this to create various
@@ -120,6 +233,20 @@ struct NfpPConfig {
 
     std::function<void(const ItemGroup &, NfpPConfig &config)> on_preload;
 
+    /**
+     * @brief Called by the selection for the configuration of a newly opened
+     * bin before it is handed over to the bin's placer. Use it to bind the
+     * callbacks of the bin to a state owned by that bin.
+     */
+    std::function<void(int bin_idx, NfpPConfig &config)> on_new_bin;
+
+    /**
+     * @brief Optional cache of the no-fit polygons. If set, the no-fit
+     * polygons are looked up in it before being calculated and the calculated
+     * ones are stored into it. The cache may outlive the placer.
+     */
+    std::shared_ptr<NfpCache<RawShape>> nfp_cache;
+
     //BBS: sort function for selector
     std::function<bool(_Item<RawShape>& i1, _Item<RawShape>& i2)> sortfunc;
     //BBS: excluded region for V4 bed
@@ -575,27 +702,57 @@ private:
         // TODO: this is a workaround and should be solved in Item with mutexes
         // guarding the mutable members when writing them.
         // /////////////////////////////////////////////////////////////////////
+        NfpCache<RawShape> *cache = config_.nfp_cache.get();
+
         trsh.transformedShape();
         trsh.referenceVertex();
         trsh.rightmostTopVertex();
         trsh.leftmostBottomVertex();
+        using Fingerprint = typename NfpCache<RawShape>::Fingerprint;
+        Fingerprint trsh_fp;
+        std::vector<Fingerprint> fps;
+        if(cache) {
+            trsh.shapeHash();
+            trsh_fp = Fingerprint(trsh);
+            fps.reserve(items_.size());
+        }
 
         for(Item& itm : items_) {
             itm.transformedShape();
             itm.referenceVertex();
             itm.rightmostTopVertex();
             itm.leftmostBottomVertex();
+            if(cache) {
+                itm.shapeHash();
+                fps.emplace_back(itm);
+            }
         }
         // /////////////////////////////////////////////////////////////////////
 
         __parallel::enumerate(items_.begin(), items_.end(),
-                              [&nfps, &trsh](const Item& sh, size_t n)
+                              [&nfps, &trsh, &fps, &trsh_fp, cache](const Item& sh, size_t n)
         {
+            Vertex ref = sh.rightmostTopVertex();
+            typename NfpCache<RawShape>::Key key;
+            if(cache) {
+                key = { sh.shapeHash(), trsh.shapeHash() };
+                if(cache->find(key, fps[n], trsh_fp, nfps[n])) {
+                    shapelike::translate(nfps[n], ref);
+                    return;
+                }
+            }
+
             auto& fixedp = sh.transformedShape();
             auto& orbp = trsh.transformedShape();
             auto subnfp_r = noFitPolygon<NfpLevel::CONVEX_ONLY>(fixedp, orbp);
             correctNfpPosition(subnfp_r, sh, trsh);
             nfps[n] = subnfp_r.first;
+
+            if(cache) {
+                RawShape cached = nfps[n];
+                shapelike::translate(cached, Vertex(-getX(ref), -getY(ref)));
+                cache->insert(key, fps[n], trsh_fp, std::move(cached));
+            }
         });
 
         return nfp::merge(nfps);
@@ -2,6 +2,7 @@
 #define FIRSTFIT_HPP
 
 #include "selection_boilerplate.hpp"
+#include <libnest2d/parallel.hpp>
 
 namespace libnest2d { namespace selections {
 
@@ -108,8 +109,32 @@ public:
             typename Placer::PackResult result, result_best, result_firstfit;
             size_t j = 0;
             while(!was_packed && !cancelled()) {
+                // Try the item on the bins not tried yet.
+                size_t first_bin = j;
+                std::vector<typename Placer::PackResult> results(placers.size() - first_bin);
+                if (pconfig.parallel_bins && results.size() > 1) {
+                    // Each bin gets its own copy of the item, as the placer
+                    // moves the item around while looking for its position.
+                    std::vector<Item> items(results.size(), it->get());
+                    std::vector<Placer*> bins;
+                    bins.reserve(results.size());
+                    for (size_t k = first_bin; k < placers.size(); ++k)
+                        bins.emplace_back(&placers[k]);
+
+                    __parallel::enumerate(bins.begin(), bins.end(),
+                                          [this, &results, &items, &it](Placer *placer, size_t n)
+                    {
+                        if (this->stopcond_()) return;
+                        results[n] = placer->pack(items[n], rem(it, store_));
+                        if (results[n]) results[n].item_ptr_ = &it->get();
+                    });
+                } else {
+                    for (size_t n = 0; n < results.size() && !cancelled(); ++n)
+                        results[n] = placers[first_bin + n].pack(*it, rem(it, store_));
+                }
+
                 for(; j < placers.size() && !was_packed && !cancelled(); j++) {
-                    result = placers[j].pack(*it, rem(it, store_));
+                    result = results[j - first_bin];
                     score = result.score();
                     score_all_plates = std::accumulate(placers.begin(), placers.begin() + j, score,
                         [](double sum, const Placer& elem) { return sum + elem.score(); });
@@ -160,7 +185,12 @@ public:
 
                     placers.emplace_back(bin);
                     placers.back().plateID(placers.size() - 1);
-                    placers.back().configure(pconfig);
+                    if (pconfig.on_new_bin) {
+                        typename Placer::Config bin_config = pconfig;
+                        pconfig.on_new_bin(int(placers.size() - 1), bin_config);
+                        placers.back().configure(bin_config);
+                    } else
+                        placers.back().configure(pconfig);
                     if (fixed_bins.size() >= placers.size())
                         placers.back().preload(fixed_bins[placers.size() - 1]);
                     //placers.back().preload(pconfig.m_excluded_items);
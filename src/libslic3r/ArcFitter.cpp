@@ -24,7 +24,6 @@ void ArcFitter::do_arc_fitting(const Points& points, std::vector<PathFittingData
 #endif
 
     result.clear();
-    result.reserve(points.size() / 2);  //worst case size
     if (points.size() < 3) {
         PathFittingData data;
         data.start_point_index = 0;
@@ -34,21 +33,29 @@ void ArcFitter::do_arc_fitting(const Points& points, std::vector<PathFittingData
         return;
     }
 
+    // Scratch buffers reused by the calls on the same thread, the simplification of the layers runs in parallel.
+    static thread_local std::vector<PathFittingData> fitting;
+    static thread_local Points current_segment;
+    fitting.clear();
+    current_segment.clear();
+
     size_t front_index = 0;
     size_t back_index = 0;
     ArcSegment last_arc;
     bool can_fit = false;
-    Points current_segment;
-    current_segment.reserve(points.size());
+    // Length of current_segment, accumulated in the same order as Polyline::length().
+    double current_length = 0.;
     ArcSegment target_arc;
     for (size_t i = 0; i < points.size(); i++) {
         //BBS: point in stack is not enough, build stack first
         back_index = i;
+        if (! current_segment.empty())
+            current_length += (points[i] - current_segment.back()).cast<double>().norm();
         current_segment.push_back(points[i]);
         if (back_index - front_index < 2)
             continue;
 
-        can_fit = ArcSegment::try_create_arc(current_segment, target_arc, Polyline(current_segment).length(),
+        can_fit = ArcSegment::try_create_arc(current_segment, target_arc, current_length,
                                              DEFAULT_SCALED_MAX_RADIUS,
                                              tolerance,
                                              DEFAULT_ARC_LENGTH_PERCENT_TOLERANCE);
@@ -56,7 +63,7 @@ void ArcFitter::do_arc_fitting(const Points& points, std::vector<PathFittingData
             //BBS: can be fit as arc, then save arc data temperarily
             last_arc = target_arc;
             if (back_index == points.size() - 1) {
-                result.emplace_back(std::move(PathFittingData{ front_index,
+                fitting.emplace_back(std::move(PathFittingData{ front_index,
                                    back_index,
                                    last_arc.direction == ArcDirection::Arc_Dir_CCW ? EMovePathType::Arc_move_ccw : EMovePathType::Arc_move_cw,
                                    last_arc }));
@@ -66,31 +73,33 @@ void ArcFitter::do_arc_fitting(const Points& points, std::vector<PathFittingData
             if (back_index - front_index > 2) {
                 //BBS: althought current point_stack can't be fit as arc,
                 //but previous must can be fit if removing the top in stack, so save last arc
-                result.emplace_back(std::move(PathFittingData{ front_index,
+                fitting.emplace_back(std::move(PathFittingData{ front_index,
                                    back_index - 1,
                                    last_arc.direction == ArcDirection::Arc_Dir_CCW ? EMovePathType::Arc_move_ccw : EMovePathType::Arc_move_cw,
                                    last_arc }));
             } else {
                 //BBS: save the first segment as line move when 3 point-line can't be fit as arc move
-                if (result.empty() || result.back().path_type != EMovePathType::Linear_move)
-                    result.emplace_back(std::move(PathFittingData{front_index, front_index + 1, EMovePathType::Linear_move, ArcSegment()}));
-                else if(result.back().path_type == EMovePathType::Linear_move)
-                    result.back().end_point_index = front_index + 1;
+                if (fitting.empty() || fitting.back().path_type != EMovePathType::Linear_move)
+                    fitting.emplace_back(std::move(PathFittingData{front_index, front_index + 1, EMovePathType::Linear_move, ArcSegment()}));
+                else if(fitting.back().path_type == EMovePathType::Linear_move)
+                    fitting.back().end_point_index = front_index + 1;
             }
             front_index = back_index - 1;
             current_segment.clear();
             current_segment.push_back(points[front_index]);
             current_segment.push_back(points[front_index + 1]);
+            current_length = (points[front_index + 1] - points[front_index]).cast<double>().norm();
         }
     }
 	//BBS: handle the remain data
     if (front_index != back_index) {
-        if (result.empty() || result.back().path_type != EMovePathType::Linear_move)
-            result.emplace_back(std::move(PathFittingData{front_index, back_index, EMovePathType::Linear_move, ArcSegment()}));
-        else if (result.back().path_type == EMovePathType::Linear_move)
-            result.back().end_point_index = back_index;
+        if (fitting.empty() || fitting.back().path_type != EMovePathType::Linear_move)
+            fitting.emplace_back(std::move(PathFittingData{front_index, back_index, EMovePathType::Linear_move, ArcSegment()}));
+        else if (fitting.back().path_type == EMovePathType::Linear_move)
+            fitting.back().end_point_index = back_index;
     }
-    result.shrink_to_fit();
+    //BBS: copy out with the exact size, the fitting result is kept with the path
+    result.assign(fitting.begin(), fitting.end());
 }
 
 void ArcFitter::do_arc_fitting_and_simplify(Points& points, std::vector<PathFittingData>& result, double tolerance)
@@ -110,10 +119,12 @@ void ArcFitter::do_arc_fitting_and_simplify(Points& points, std::vector<PathFitt
         return;
     } else {
         //BBS: has both arc part and straight part, we should spilit the straight part out and do DP simplify
-        Points simplified_points;
-        simplified_points.reserve(points.size());
+        static thread_local Points simplified_points;
+        static thread_local Points straight_or_arc_part;
+        static thread_local std::vector<size_t> reduce_count;
+        simplified_points.clear();
         simplified_points.push_back(points[0]);
-        std::vector<size_t> reduce_count(result.size(), 0);
+        reduce_count.assign(result.size(), 0);
         for (size_t i = 0; i < result.size(); i++)
         {
             size_t start_index = result[i].start_point_index;
@@ -123,20 +134,15 @@ void ArcFitter::do_arc_fitting_and_simplify(Points& points, std::vector<PathFitt
             //For arc part, theoretically, we only need to keep the start and end point, and
             //delete all other point. But when considering wipe operation, we must keep the original
             //point data and shouldn't reduce too much by only saving start and end point.
-            Points straight_or_arc_part;
-            straight_or_arc_part.reserve(end_index - start_index + 1);
-            for (size_t j = start_index; j <= end_index; j++)
-                straight_or_arc_part.push_back(points[j]);
-            straight_or_arc_part = MultiPoint::_douglas_peucker(straight_or_arc_part, tolerance);
+            straight_or_arc_part.assign(points.begin() + start_index, points.begin() + end_index + 1);
+            const Points simplified_part = MultiPoint::_douglas_peucker(straight_or_arc_part, tolerance);
             //BBS: how many point has been reduced
-            reduce_count[i] = end_index - start_index + 1 - straight_or_arc_part.size();
+            reduce_count[i] = end_index - start_index + 1 - simplified_part.size();
             //BBS: save the simplified result
-            for (size_t j = 1; j < straight_or_arc_part.size(); j++) {
-                simplified_points.push_back(straight_or_arc_part[j]);
-            }
+            simplified_points.insert(simplified_points.end(), simplified_part.begin() + 1, simplified_part.end());
         }
         //BBS: save and will return the simplified_points
-        points = simplified_points;
+        points.assign(simplified_points.begin(), simplified_points.end());
         //BBS: modify the index in result because the point index must be changed to match the simplified points
         for (size_t j = 1; j < reduce_count.size(); j++)
             reduce_count[j] += reduce_count[j - 1];
@@ -9,6 +9,7 @@
 #include <libnest2d/utils/rotcalipers.hpp>
 
 #include <numeric>
+#include <deque>
 #include <ClipperUtils.hpp>
 
 #include <boost/geometry/index/rtree.hpp>
@@ -79,6 +80,15 @@ using ItemGroup = std::vector<std::reference_wrapper<Item>>;
 // A coefficient used in separating bigger items and smaller items.
 const double BIG_ITEM_TRESHOLD = 0.02;
 
+// No-fit polygons shared by all the arrangements of the session, so that
+// re-arranging the same shapes (fill bed, duplicates, arranging again after
+// a small edit) does not calculate them again.
+static std::shared_ptr<placers::NfpCache<ExPolygon>> session_nfp_cache()
+{
+    static auto cache = std::make_shared<placers::NfpCache<ExPolygon>>();
+    return cache;
+}
+
 // Fill in the placer algorithm configuration with values carefully chosen for
 // Slic3r.
 template<class PConf>
@@ -109,6 +119,9 @@ void fill_config(PConf& pcfg, const ArrangeParams &params) {
     
     // Allow parallel execution.
     pcfg.parallel = params.parallel;
+    pcfg.parallel_bins = params.parallel && params.parallel_beds;
+
+    pcfg.nfp_cache = session_nfp_cache();
 
     // BBS: excluded regions in BBS bed
     for (auto& poly : params.excluded_regions)
@@ -150,27 +163,33 @@ public:
     std::vector<Item> m_excluded_items_in_each_plate;   // for V4 bed there are excluded regions at bottom left corner
 
 protected:
-    Packer    m_pck;
-    PConfig   m_pconf; // Placement configuration
-    TBin      m_bin;
-    double    m_bin_area;
-
+    // State of a single bin, updated just before an item is tried to be packed into it.
+    // Each bin owns its state, so that the bins may be evaluated concurrently.
+    struct PileState {
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable: 4244)
 #pragma warning(disable: 4267)
 #endif
-    SpatIndex m_rtree; // spatial index for the normal (bigger) objects
-    SpatIndex m_smallsrtree;    // spatial index for only the smaller items
+        SpatIndex    rtree;       // spatial index for the normal (bigger) objects
+        SpatIndex    smallsrtree; // spatial index for only the smaller items
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
+        MultiPolygon merged_pile; // The already merged pile (vector of items)
+        Box          pilebb;      // The bounding box of the merged pile.
+        ItemGroup    remaining;   // Remaining items
+        ItemGroup    items;       // allready packed items
+    };
+
+    Packer    m_pck;
+    PConfig   m_pconf; // Placement configuration
+    TBin      m_bin;
+    double    m_bin_area;
 
     double    m_norm;           // A coefficient to scale distances
-    MultiPolygon m_merged_pile; // The already merged pile (vector of items)
-    Box          m_pilebb;      // The bounding box of the merged pile.
-    ItemGroup m_remaining;      // Remaining items
-    ItemGroup m_items;          // allready packed items
+    PileState m_pile;           // State of the bins not created by the selection (unpackable items test)
+    std::deque<PileState> m_bin_piles; // State of each bin created by the selection, indexed by the bin
     size_t    m_item_count = 0; // Number of all items to be packed
     ArrangeParams params;
     
@@ -200,11 +219,11 @@ protected:
     // as it possibly can be but at the same time, it has to provide
     // reasonable results.
     std::tuple<double /*score*/, Box /*farthest point from bin center*/>
-    objfunc(const Item &item, const ClipperLib::IntPoint &origin_pack)
+    objfunc(const PileState &pile, const Item &item, const ClipperLib::IntPoint &origin_pack)
     {
         const double bin_area = m_bin_area;
-        const SpatIndex& spatindex = m_rtree;
-        const SpatIndex& smalls_spatindex = m_smallsrtree;
+        const SpatIndex& spatindex = pile.rtree;
+        const SpatIndex& smalls_spatindex = pile.smallsrtree;
         
         // We will treat big items (compared to the print bed) differently
         auto isBig = [bin_area](double a) {
@@ -215,7 +234,7 @@ protected:
         auto ibb = item.boundingBox();
         
         // Calculate the full bounding box of the pile with the candidate item
-        auto fullbb = sl::boundingBox(m_pilebb, ibb);
+        auto fullbb = sl::boundingBox(pile.pilebb, ibb);
         
         // The bounding box of the big items (they will accumulate in the center
         // of the pile
@@ -246,8 +265,8 @@ protected:
         } compute_case;
         
         bool bigitems = isBig(item.area()) || spatindex.empty();
-        if(!params.is_seq_print && bigitems && !m_remaining.empty()) compute_case = BIG_ITEM;  // do not use so complicated logic for sequential printing
-        else if (bigitems && m_remaining.empty()) compute_case = LAST_BIG_ITEM;
+        if(!params.is_seq_print && bigitems && !pile.remaining.empty()) compute_case = BIG_ITEM;  // do not use so complicated logic for sequential printing
+        else if (bigitems && pile.remaining.empty()) compute_case = LAST_BIG_ITEM;
         else compute_case = SMALL_ITEM;
         
         switch (compute_case) {
@@ -300,7 +319,7 @@ protected:
                 // now get the score for the best alignment
                 for (auto& e : result) {
                     auto idx = e.second;
-                    Item& p = m_items[idx];
+                    Item& p = pile.items[idx];
                     auto parea = p.area();
                     if (std::abs(1.0 - parea / item.area()) < 1e-6) {
                         auto bb = sl::boundingBox(p.boundingBox(), ibb);
@@ -312,7 +331,7 @@ protected:
                     }
 
                 density = std::sqrt(norm(fullbb.width()) * norm(fullbb.height()));
-                double R = double(m_remaining.size()) / m_item_count;
+                double R = double(pile.remaining.size()) / m_item_count;
 
                 // The final mix of the score is the balance between the
                 // distance from the full pile center, the pack density and
@@ -332,8 +351,8 @@ protected:
             }
             else {
                 score = 0.5 * norm(pl::distance(ibb.center(), origin_pack));
-                if (m_pilebb.defined)
-                    score += 0.5 * norm(pl::distance(ibb.center(), m_pilebb.center()));
+                if (pile.pilebb.defined)
+                    score += 0.5 * norm(pl::distance(ibb.center(), pile.pilebb.center()));
             }
             break;
         }
@@ -366,8 +385,8 @@ protected:
             auto iy2 = item.boundingBox().maxCorner().y();
             auto ix1 = item.boundingBox().minCorner().x();
 
-            for (int i = 0; i < m_items.size(); i++) {
-                Item& p = m_items[i];
+            for (int i = 0; i < pile.items.size(); i++) {
+                Item& p = pile.items[i];
                 if (p.is_virt_object) continue;
                 auto px1 = p.boundingBox().minCorner().x();
                 auto py1 = p.boundingBox().minCorner().y();
@@ -385,16 +404,16 @@ protected:
 
             double lambda3 = LARGE_COST_TO_REJECT;
             double lambda4 = LARGE_COST_TO_REJECT;
-            for (int i = 0; i < m_items.size(); i++) {
-                Item& p = m_items[i];
+            for (int i = 0; i < pile.items.size(); i++) {
+                Item& p = pile.items[i];
                 if (p.is_virt_object) continue;
                 score += lambda3 * (item.bed_temp - p.vitrify_temp > 0);
             }
             score += lambda4 * hasRowHeightConflict + lambda4 * hasLidHeightConflict;
         }
         else {
-            for (int i = 0; i < m_items.size(); i++) {
-                Item& p = m_items[i];
+            for (int i = 0; i < pile.items.size(); i++) {
+                Item& p = pile.items[i];
                 if (p.is_virt_object) {
                     // Better not put items above wipe tower
                     if (p.is_wipe_tower)
@@ -407,8 +426,8 @@ protected:
         }
 
         std::set<int> extruder_ids;
-        for (int i = 0; i < m_items.size(); i++) {
-            Item& p = m_items[i];
+        for (int i = 0; i < pile.items.size(); i++) {
+            Item& p = pile.items[i];
             if (p.is_virt_object) continue;
             extruder_ids.insert(p.extrude_id);
             // add a large cost if not multi materials on same plate is not allowed 
@@ -424,41 +443,38 @@ protected:
         return std::make_tuple(score, fullbb);
     }
     
-    std::function<double(const Item&)> get_objfn();
-    
-public:
-    AutoArranger(const TBin &                  bin,
-                 const ArrangeParams           &params,
-                 std::function<void(unsigned,std::string)> progressind,
-                 std::function<bool(void)>     stopcond)
-        : m_pck(bin, params.min_obj_distance)
-        , m_bin(bin)
+    std::function<double(const Item&)> get_objfn(const PileState &pile);
+
+    PileState& bin_pile(size_t bin_idx)
     {
-        m_bin_area = abs(sl::area(bin));  // due to clockwise or anti-clockwise, the result of sl::area may be negative
-        m_norm = std::sqrt(m_bin_area);
-        fill_config(m_pconf, params);
-        this->params = params;
+        if (m_bin_piles.size() <= bin_idx)
+            m_bin_piles.resize(bin_idx + 1);
+        return m_bin_piles[bin_idx];
+    }
 
+    // Bind the callbacks of a placer configuration to the state of a single bin.
+    void bind_pile(PileState &pile, PConfig &pconf)
+    {
         // Set up a callback that is called just before arranging starts
         // This functionality is provided by the Nester class (m_pack).
-        m_pconf.before_packing =
-        [this](const MultiPolygon& merged_pile,            // merged pile
+        pconf.before_packing =
+        [this, &pile](const MultiPolygon& merged_pile,            // merged pile
                const ItemGroup& items,             // packed items
                const ItemGroup& remaining)         // future items to be packed
         {
-            m_items = items;
-            m_merged_pile = merged_pile;
-            m_remaining = remaining;
+            pile.items = items;
+            pile.merged_pile = merged_pile;
+            pile.remaining = remaining;
 
-            m_pilebb.defined = false;
+            pile.pilebb.defined = false;
             if (!merged_pile.empty())
             {
-                m_pilebb = sl::boundingBox(merged_pile);
-                m_pilebb.defined = true;
+                pile.pilebb = sl::boundingBox(merged_pile);
+                pile.pilebb.defined = true;
             }
 
-            m_rtree.clear();
-            m_smallsrtree.clear();
+            pile.rtree.clear();
+            pile.smallsrtree.clear();
             
             // We will treat big items (compared to the print bed) differently
             auto isBig = [this](double a) {
@@ -468,25 +484,14 @@ public:
             for(unsigned idx = 0; idx < items.size(); ++idx) {
                 Item& itm = items[idx];
                 if (itm.is_virt_object) continue;
-                if(isBig(itm.area())) m_rtree.insert({itm.boundingBox(), idx});
-                m_smallsrtree.insert({itm.boundingBox(), idx});
+                if(isBig(itm.area())) pile.rtree.insert({itm.boundingBox(), idx});
+                pile.smallsrtree.insert({itm.boundingBox(), idx});
             }
         };
         
-        m_pconf.object_function = get_objfn();
-
-        auto bbox2expoly = [](Box bb) {
-            ExPolygon bin_poly;
-            auto c0 = bb.minCorner();
-            auto c1 = bb.maxCorner();
-            bin_poly.contour.points.emplace_back(c0);
-            bin_poly.contour.points.emplace_back(c1.x(), c0.y());
-            bin_poly.contour.points.emplace_back(c1);
-            bin_poly.contour.points.emplace_back(c0.x(), c1.y());
-            return bin_poly;
-        };
+        pconf.object_function = get_objfn(pile);
 
-        m_pconf.on_preload = [this](const ItemGroup &items, PConfig &cfg) {
+        pconf.on_preload = [this, &pile](const ItemGroup &items, PConfig &cfg) {
             if (items.empty()) return;
 
             auto bb = sl::boundingBox(m_bin);
@@ -503,10 +508,40 @@ public:
                     break;
                 }
             }
-            cfg.object_function = [this, bb, starting_point](const Item& item) {
-                return fixed_overfit(objfunc(item, starting_point), bb);
+            cfg.object_function = [this, &pile, bb, starting_point](const Item& item) {
+                return fixed_overfit(objfunc(pile, item, starting_point), bb);
             };
         };
+    }
+    
+public:
+    AutoArranger(const TBin &                  bin,
+                 const ArrangeParams           &params,
+                 std::function<void(unsigned,std::string)> progressind,
+                 std::function<bool(void)>     stopcond)
+        : m_pck(bin, params.min_obj_distance)
+        , m_bin(bin)
+    {
+        m_bin_area = abs(sl::area(bin));  // due to clockwise or anti-clockwise, the result of sl::area may be negative
+        m_norm = std::sqrt(m_bin_area);
+        fill_config(m_pconf, params);
+        this->params = params;
+
+        bind_pile(m_pile, m_pconf);
+        m_pconf.on_new_bin = [this](int bin_idx, PConfig &cfg) {
+            bind_pile(bin_pile(size_t(bin_idx)), cfg);
+        };
+
+        auto bbox2expoly = [](Box bb) {
+            ExPolygon bin_poly;
+            auto c0 = bb.minCorner();
+            auto c1 = bb.maxCorner();
+            bin_poly.contour.points.emplace_back(c0);
+            bin_poly.contour.points.emplace_back(c1.x(), c0.y());
+            bin_poly.contour.points.emplace_back(c1);
+            bin_poly.contour.points.emplace_back(c0.x(), c1.y());
+            return bin_poly;
+        };
 
         auto on_packed = params.on_packed;
         
@@ -554,7 +589,8 @@ public:
     }
      
     template<class It> inline void operator()(It from, It to) {
-        m_rtree.clear();
+        m_pile = PileState();
+        m_bin_piles.clear();
         m_item_count += size_t(to - from);
         m_pck.execute(from, to);
         m_item_count = 0;
@@ -573,12 +609,12 @@ public:
     }
 };
 
-template<> std::function<double(const Item&)> AutoArranger<Box>::get_objfn()
+template<> std::function<double(const Item&)> AutoArranger<Box>::get_objfn(const PileState &pile)
 {
     auto origin_pack = m_pconf.starting_point == PConfig::Alignment::CENTER ? m_bin.center() : m_bin.minCorner();
 
-    return [this, origin_pack](const Item &itm) {
-        auto result = objfunc(itm, origin_pack);
+    return [this, &pile, origin_pack](const Item &itm) {
+        auto result = objfunc(pile, itm, origin_pack);
         
         double score = std::get<0>(result);
         auto& fullbb = std::get<1>(result);
@@ -599,13 +635,13 @@ template<> std::function<double(const Item&)> AutoArranger<Box>::get_objfn()
     };
 }
 
-template<> std::function<double(const Item&)> AutoArranger<Circle>::get_objfn()
+template<> std::function<double(const Item&)> AutoArranger<Circle>::get_objfn(const PileState &pile)
 {
     auto bb = sl::boundingBox(m_bin);
     auto origin_pack = m_pconf.starting_point == PConfig::Alignment::CENTER ? bb.center() : bb.minCorner();
-    return [this, origin_pack](const Item &item) {
+    return [this, &pile, origin_pack](const Item &item) {
         
-        auto result = objfunc(item, origin_pack);
+        auto result = objfunc(pile, item, origin_pack);
         
         double score = std::get<0>(result);
         
@@ -614,7 +650,7 @@ template<> std::function<double(const Item&)> AutoArranger<Circle>::get_objfn()
         };
         
         if(isBig(item)) {
-            auto mp = m_merged_pile;
+            auto mp = pile.merged_pile;
             mp.push_back(item.transformedShape());
             auto chull = sl::convexHull(mp);
             double miss = Placer::overfit(chull, m_bin);
@@ -629,16 +665,16 @@ template<> std::function<double(const Item&)> AutoArranger<Circle>::get_objfn()
 // Specialization for a generalized polygon.
 // Warning: this is much slower than with Box bed. Need further speedup.
 template<>
-std::function<double(const Item &)> AutoArranger<ExPolygon>::get_objfn()
+std::function<double(const Item &)> AutoArranger<ExPolygon>::get_objfn(const PileState &pile)
 {
     auto bb = sl::boundingBox(m_bin);
     auto origin_pack = m_pconf.starting_point == PConfig::Alignment::CENTER ? bb.center() : bb.minCorner();
-    return [this, origin_pack](const Item &itm) {
-        auto result = objfunc(itm, origin_pack);
+    return [this, &pile, origin_pack](const Item &itm) {
+        auto result = objfunc(pile, itm, origin_pack);
 
         double score = std::get<0>(result);
         
-        auto mp = m_merged_pile;
+        auto mp = pile.merged_pile;
         mp.emplace_back(itm.transformedShape());
         auto chull = sl::convexHull(mp);
         if (m_pconf.starting_point == PConfig::Alignment::BOTTOM_LEFT)
@@ -112,6 +112,10 @@ struct ArrangeParams {
     /// Allow parallel execution.
     bool parallel = true;
 
+    /// Try each item on all the open virtual beds concurrently (with parallel
+    /// execution allowed). Each bed then starts from the item's initial rotation.
+    bool parallel_beds = false;
+
     bool allow_rotations = false;
 
     //BBS: add specific arrange params
@@ -1,6 +1,7 @@
 #include "BridgeDetector.hpp"
 #include "ClipperUtils.hpp"
 #include "Geometry.hpp"
+#include "LayerSupportMap.hpp"
 #include <algorithm>
 
 namespace Slic3r {
@@ -32,6 +33,18 @@ BridgeDetector::BridgeDetector(
     initialize();
 }
 
+BridgeDetector::BridgeDetector(
+    const ExPolygons      &_expolygons,
+    const LayerSupportMap &_lower_support_map,
+    coord_t                _spacing) :
+    expolygons(_expolygons),
+    lower_slices(_lower_support_map.slices()),
+    lower_support_map(&_lower_support_map),
+    spacing(_spacing)
+{
+    initialize();
+}
+
 void BridgeDetector::initialize()
 {
     // 5 degrees stepping
@@ -46,10 +59,13 @@ void BridgeDetector::initialize()
     // Detect what edges lie on lower slices by turning bridge contour and holes
     // into polylines and then clipping them with each lower slice's contour.
     // Currently _edges are only used to set a candidate direction of the bridge (see bridge_direction_candidates()).
-	Polygons contours;
-	contours.reserve(this->lower_slices.size());
-	for (const ExPolygon &expoly : this->lower_slices)
-		contours.push_back(expoly.contour);
+	Polygons contours_local;
+	if (this->lower_support_map == nullptr) {
+		contours_local.reserve(this->lower_slices.size());
+		for (const ExPolygon &expoly : this->lower_slices)
+			contours_local.push_back(expoly.contour);
+	}
+	const Polygons &contours = this->lower_support_map ? this->lower_support_map->contours() : contours_local;
     this->_edges = intersection_pl(to_polylines(grown), contours);
     
     #ifdef SLIC3R_DEBUG
@@ -58,7 +74,9 @@ void BridgeDetector::initialize()
     
     // detect anchors as intersection between our bridge expolygon and the lower slices
     // safety offset required to avoid Clipper from detecting empty intersection while Boost actually found some edges
-    this->_anchor_regions = intersection_ex(grown, union_safety_offset(this->lower_slices));
+    this->_anchor_regions = this->lower_support_map ?
+        intersection_ex(grown, this->lower_support_map->safety_offset()) :
+        intersection_ex(grown, union_safety_offset(this->lower_slices));
     
     /*
     if (0) {
@@ -335,7 +353,10 @@ BridgeDetector::unsupported_edges(double angle, Polylines* unsupported) const
     if (angle == -1) angle = this->angle;
     if (angle == -1) return;
 
-    Polygons grown_lower = offset(this->lower_slices, float(this->spacing));
+    Polygons grown_lower_local;
+    if (this->lower_support_map == nullptr)
+        grown_lower_local = offset(this->lower_slices, float(this->spacing));
+    const Polygons &grown_lower = this->lower_support_map ? this->lower_support_map->grown(float(this->spacing)) : grown_lower_local;
 
     for (ExPolygons::const_iterator it_expoly = this->expolygons.begin(); it_expoly != this->expolygons.end(); ++ it_expoly) {    
         // get unsupported bridge edges (both contour and holes)
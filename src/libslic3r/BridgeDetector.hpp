@@ -7,6 +7,8 @@
 
 namespace Slic3r {
 
+class LayerSupportMap;
+
 // The bridge detector optimizes a direction of bridges over a region or a set of regions.
 // A bridge direction is considered optimal, if the length of the lines strang over the region is maximal.
 // This is optimal if the bridge is supported in a single direction only, but
@@ -21,6 +23,8 @@ public:
     ExPolygons                   expolygons_owned;
     // Lower slices, all regions.
     const ExPolygons   			&lower_slices;
+    // Optional cache of the polygons derived from lower_slices, shared with other queries of the same layer.
+    const LayerSupportMap       *lower_support_map { nullptr };
     // Scaled extrusion width of the infill.
     coord_t                      spacing;
     // Angle resolution for the brute force search of the best bridging angle.
@@ -30,6 +34,7 @@ public:
     
     BridgeDetector(ExPolygon _expolygon, const ExPolygons &_lower_slices, coord_t _extrusion_width);
     BridgeDetector(const ExPolygons &_expolygons, const ExPolygons &_lower_slices, coord_t _extrusion_width);
+    BridgeDetector(const ExPolygons &_expolygons, const LayerSupportMap &_lower_support_map, coord_t _extrusion_width);
     // If bridge_direction_override != 0, then the angle is used instead of auto-detect.
     bool detect_angle(double bridge_direction_override = 0.);
     // Coverage is currently only used by the unit tests. It is extremely slow and unreliable!
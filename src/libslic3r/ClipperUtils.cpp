@@ -2,6 +2,11 @@
 #include "Geometry.hpp"
 #include "ShortestPath.hpp"
 
+#include <numeric>
+#include <optional>
+
+#include <tbb/parallel_for.h>
+
 // #define CLIPPER_UTILS_DEBUG
 
 #ifdef CLIPPER_UTILS_DEBUG
@@ -161,23 +166,23 @@ bool has_duplicate_points(const ClipperLib::PolyTree &polytree)
 template<typename PathsProvider, ClipperLib::EndType endType = ClipperLib::etClosedPolygon>
 static ClipperLib::Paths raw_offset(PathsProvider &&paths, float offset, ClipperLib::JoinType joinType, double miterLimit)
 {
-    ClipperLib::ClipperOffset co;
+    ClipperUtils::CachedClipperOffset co;
     ClipperLib::Paths out;
     out.reserve(paths.size());
     ClipperLib::Paths out_this;
     if (joinType == jtRound)
-        co.ArcTolerance = miterLimit;
+        co->ArcTolerance = miterLimit;
     else
-        co.MiterLimit = miterLimit;
-    co.ShortestEdgeLength = double(std::abs(offset * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
+        co->MiterLimit = miterLimit;
+    co->ShortestEdgeLength = double(std::abs(offset * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
     for (const ClipperLib::Path &path : paths) {
-        co.Clear();
+        co->Clear();
         // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
         // contours will be CCW oriented even though the input paths are CW oriented.
         // Offset is applied after contour reorientation, thus the signum of the offset value is reversed.
-        co.AddPath(path, joinType, endType);
+        co->AddPath(path, joinType, endType);
         bool ccw = endType == ClipperLib::etClosedPolygon ? ClipperLib::Orientation(path) : true;
-        co.Execute(out_this, ccw ? offset : - offset);
+        co->Execute(out_this, ccw ? offset : - offset);
         if (! ccw) {
             // Reverse the resulting contours.
             for (ClipperLib::Path &path : out_this)
@@ -202,11 +207,11 @@ TResult clipper_do(
     TClip &&                       clip,
     const ClipperLib::PolyFillType fillType)
 {
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
-    clipper.AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
+    ClipperUtils::CachedClipper clipper;
+    clipper->AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+    clipper->AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
     TResult retval;
-    clipper.Execute(clipType, retval, fillType, fillType);
+    clipper->Execute(clipType, retval, fillType, fillType);
     return retval;
 }
 
@@ -231,10 +236,10 @@ TResult clipper_union(
     // fillType pftNonZero and pftPositive "should" produce the same result for "normalized with implicit union" set of polygons
     const ClipperLib::PolyFillType fillType = ClipperLib::pftNonZero)
 {
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+    ClipperUtils::CachedClipper clipper;
+    clipper->AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
     TResult retval;
-    clipper.Execute(ClipperLib::ctUnion, retval, fillType, fillType);
+    clipper->Execute(ClipperLib::ctUnion, retval, fillType, fillType);
     return retval;
 }
 
@@ -274,12 +279,12 @@ static TResult shrink_paths(PathsProvider &&paths, float offset, ClipperLib::Joi
     //assert(offset > 0);
     TResult out;
     if (auto raw = raw_offset(std::forward<PathsProvider>(paths), - offset, joinType, miterLimit); ! raw.empty()) {
-        ClipperLib::Clipper clipper;
-        clipper.AddPaths(raw, ClipperLib::ptSubject, true);
-        ClipperLib::IntRect r = clipper.GetBounds();
-        clipper.AddPath({ { r.left - 10, r.bottom + 10 }, { r.right + 10, r.bottom + 10 }, { r.right + 10, r.top - 10 }, { r.left - 10, r.top - 10 } }, ClipperLib::ptSubject, true);
-        clipper.ReverseSolution(true);
-        clipper.Execute(ClipperLib::ctUnion, out, ClipperLib::pftNegative, ClipperLib::pftNegative);
+        ClipperUtils::CachedClipper clipper;
+        clipper->AddPaths(raw, ClipperLib::ptSubject, true);
+        ClipperLib::IntRect r = clipper->GetBounds();
+        clipper->AddPath({ { r.left - 10, r.bottom + 10 }, { r.right + 10, r.bottom + 10 }, { r.right + 10, r.top - 10 }, { r.left - 10, r.top - 10 } }, ClipperLib::ptSubject, true);
+        clipper->ReverseSolution(true);
+        clipper->Execute(ClipperLib::ctUnion, out, ClipperLib::pftNegative, ClipperLib::pftNegative);
         remove_outermost_polygon(out);
     }
     return out;
@@ -315,14 +320,14 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
     // 1) Offset the outer contour.
     ClipperLib::Paths contours;
     {
-        ClipperLib::ClipperOffset co;
+        ClipperUtils::CachedClipperOffset co;
         if (joinType == jtRound)
-            co.ArcTolerance = miterLimit;
+            co->ArcTolerance = miterLimit;
         else
-            co.MiterLimit = miterLimit;
-        co.ShortestEdgeLength = double(std::abs(delta * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
-        co.AddPath(expoly.contour.points, joinType, ClipperLib::etClosedPolygon);
-        co.Execute(contours, delta);
+            co->MiterLimit = miterLimit;
+        co->ShortestEdgeLength = double(std::abs(delta * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
+        co->AddPath(expoly.contour.points, joinType, ClipperLib::etClosedPolygon);
+        co->Execute(contours, delta);
     }
     if (contours.empty())
         // No need to try to offset the holes.
@@ -336,18 +341,18 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
         ClipperLib::Paths holes;
         {
             for (const Polygon &hole : expoly.holes) {
-                ClipperLib::ClipperOffset co;
+                ClipperUtils::CachedClipperOffset co;
                 if (joinType == jtRound)
-                    co.ArcTolerance = miterLimit;
+                    co->ArcTolerance = miterLimit;
                 else
-                    co.MiterLimit = miterLimit;
-                co.ShortestEdgeLength = double(std::abs(delta * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
-                co.AddPath(hole.points, joinType, ClipperLib::etClosedPolygon);
+                    co->MiterLimit = miterLimit;
+                co->ShortestEdgeLength = double(std::abs(delta * CLIPPER_OFFSET_SHORTEST_EDGE_FACTOR));
+                co->AddPath(hole.points, joinType, ClipperLib::etClosedPolygon);
                 ClipperLib::Paths out2;
                 // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
                 // contours will be CCW oriented even though the input paths are CW oriented.
                 // Offset is applied after contour reorientation, thus the signum of the offset value is reversed.
-                co.Execute(out2, - delta);
+                co->Execute(out2, - delta);
                 append(holes, std::move(out2));
             }
         }
@@ -462,6 +467,31 @@ ExPolygons offset2_ex(const Surfaces &surfaces, const float delta1, const float
     return PolyTreeToExPolygons(offset_paths<ClipperLib::PolyTree>(expolygons_offset(surfaces, delta1, joinType, miterLimit), delta2, joinType, miterLimit));
 }
 
+std::vector<ExPolygons> offset_ex_batch(const ExPolygons &expolygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    std::vector<ExPolygons> out(expolygons.size());
+    // Reused by all the islands.
+    ClipperLib::Paths paths;
+    for (size_t i = 0; i < expolygons.size(); ++ i) {
+        paths.clear();
+        if (offset_expolygon_inner(expolygons[i], delta, joinType, miterLimit, paths))
+            out[i] = ClipperPaths_to_Slic3rExPolygons(paths);
+    }
+    return out;
+}
+
+std::vector<ExPolygons> offset2_ex_batch(const ExPolygons &expolygons, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
+{
+    std::vector<ExPolygons> out(expolygons.size());
+    ClipperLib::Paths paths;
+    for (size_t i = 0; i < expolygons.size(); ++ i) {
+        paths.clear();
+        if (offset_expolygon_inner(expolygons[i], delta1, joinType, miterLimit, paths))
+            out[i] = PolyTreeToExPolygons(offset_paths<ClipperLib::PolyTree>(paths, delta2, joinType, miterLimit));
+    }
+    return out;
+}
+
 // Offset outside, then inside produces morphological closing. All deltas should be positive.
 Slic3r::Polygons closing(const Slic3r::Polygons &polygons, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
 {
@@ -540,9 +570,207 @@ inline ClipperLib::PolyTree clipper_do_polytree(
         clipper_do_polytree(clipType, std::forward<PathProvider1>(subject), std::forward<PathProvider2>(clip), fillType);
 }
 
+// Bounding box prefiltering of the difference / intersection operations.
+// Layers with hundreds of islands are frequently clipped against polygons spread over the whole bed
+// (for example the brim loops against islands_area). A clip path, whose bounding box does not overlap
+// a subject island, does not change the winding numbers inside that island, thus it is culled before
+// it reaches the Clipper sweep. Subject paths are split into clusters with pairwise disjoint bounding boxes,
+// which are clipped independently and in parallel.
+namespace ClipperUtils {
+    class PathPtrsProvider {
+    public:
+        PathPtrsProvider(const std::vector<const Points*> &paths) : m_paths(paths) {}
+
+        struct iterator : public PathsProviderIteratorBase {
+        public:
+            explicit iterator(std::vector<const Points*>::const_iterator it) : m_it(it) {}
+            const Points& operator*() const { return **m_it; }
+            bool operator==(const iterator &rhs) const { return m_it == rhs.m_it; }
+            bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
+            const Points& operator++(int) { return **(m_it ++); }
+            iterator& operator++() { ++ m_it; return *this; }
+        private:
+            std::vector<const Points*>::const_iterator m_it;
+        };
+
+        iterator cbegin() const { return iterator(m_paths.begin()); }
+        iterator begin()  const { return this->cbegin(); }
+        iterator cend()   const { return iterator(m_paths.end()); }
+        iterator end()    const { return this->cend(); }
+        size_t   size()   const { return m_paths.size(); }
+
+    private:
+        const std::vector<const Points*> &m_paths;
+    };
+}
+
+// Prefiltering is only tried if there are at least that many input paths.
+static constexpr const size_t ClipperPrefilterMinPaths    = 16;
+// Clusters are clipped in parallel only if there are at least that many input points.
+static constexpr const size_t ClipperParallelMinPoints    = 20000;
+
+struct ClipperPathBBox {
+    const Points *path;
+    BoundingBox   bbox;
+};
+
+struct ClipperCluster {
+    std::vector<const Points*> subject;
+    std::vector<const Points*> clip;
+    BoundingBox                bbox;
+    size_t                     num_points { 0 };
+};
+
+template<typename PathsProvider>
+static std::vector<ClipperPathBBox> clipper_paths_bboxes(PathsProvider &&paths)
+{
+    std::vector<ClipperPathBBox> out;
+    out.reserve(paths.size());
+    for (const Points &path : paths)
+        if (! path.empty())
+            out.push_back({ &path, BoundingBox(path) });
+    return out;
+}
+
+// Split subject paths into clusters, so that bounding boxes of paths of different clusters do not overlap,
+// and assign to each cluster the clip paths overlapping the cluster bounding box.
+// Returns nothing if the prefiltering would neither cull anything nor split the subject.
+template<typename TSubj, typename TClip>
+static std::optional<std::vector<ClipperCluster>> clipper_clusters(ClipperLib::ClipType clipType, const TSubj &subject, const TClip &clip, ApplySafetyOffset do_safety_offset)
+{
+    if ((clipType != ClipperLib::ctDifference && clipType != ClipperLib::ctIntersection) || 
+        subject.size() + clip.size() < ClipperPrefilterMinPaths || clip.size() == 0)
+        return {};
+
+    std::vector<ClipperCluster> clusters;
+    std::vector<ClipperPathBBox> subject_bboxes = clipper_paths_bboxes(subject);
+    std::vector<ClipperPathBBox> clip_bboxes    = clipper_paths_bboxes(clip);
+
+    // Union-find of subject paths with overlapping bounding boxes, sweeping along the X axis.
+    std::sort(subject_bboxes.begin(), subject_bboxes.end(), [](const ClipperPathBBox &l, const ClipperPathBBox &r) { return l.bbox.min.x() < r.bbox.min.x(); });
+    std::vector<size_t> parent(subject_bboxes.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto root = [&parent](size_t i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    std::vector<size_t> active;
+    for (size_t i = 0; i < subject_bboxes.size(); ++ i) {
+        const BoundingBox &bbox = subject_bboxes[i].bbox;
+        active.erase(std::remove_if(active.begin(), active.end(), [&subject_bboxes, &bbox](size_t j) { return subject_bboxes[j].bbox.max.x() < bbox.min.x(); }), active.end());
+        for (size_t j : active)
+            if (const BoundingBox &bbox2 = subject_bboxes[j].bbox; bbox2.min.y() <= bbox.max.y() && bbox2.max.y() >= bbox.min.y())
+                if (size_t ri = root(i), rj = root(j); ri != rj)
+                    parent[rj] = ri;
+        active.emplace_back(i);
+    }
+
+    std::vector<size_t> cluster_idx(subject_bboxes.size(), std::numeric_limits<size_t>::max());
+    for (size_t i = 0; i < subject_bboxes.size(); ++ i) {
+        size_t &idx = cluster_idx[root(i)];
+        if (idx == std::numeric_limits<size_t>::max()) {
+            idx = clusters.size();
+            clusters.emplace_back();
+        }
+        ClipperCluster &cluster = clusters[idx];
+        cluster.subject.emplace_back(subject_bboxes[i].path);
+        cluster.bbox.merge(subject_bboxes[i].bbox);
+        cluster.num_points += subject_bboxes[i].path->size();
+    }
+
+    // The safety offset is applied to the clip paths after culling, account for the mitered corners.
+    const coord_t inflation = do_safety_offset == ApplySafetyOffset::Yes ? coord_t(std::ceil(ClipperSafetyOffset * DefaultMiterLimit)) + 1 : 0;
+    std::vector<BoundingBox> cluster_bboxes;
+    cluster_bboxes.reserve(clusters.size());
+    for (const ClipperCluster &cluster : clusters)
+        cluster_bboxes.emplace_back(cluster.bbox.inflated(inflation));
+
+    // Assign the clip paths to the clusters with overlapping bounding boxes, sweeping along the X axis over both.
+    std::vector<size_t> cluster_order(clusters.size());
+    std::iota(cluster_order.begin(), cluster_order.end(), 0);
+    std::sort(cluster_order.begin(), cluster_order.end(), [&cluster_bboxes](size_t l, size_t r) { return cluster_bboxes[l].min.x() < cluster_bboxes[r].min.x(); });
+    std::vector<size_t> clip_order(clip_bboxes.size());
+    std::iota(clip_order.begin(), clip_order.end(), 0);
+    std::sort(clip_order.begin(), clip_order.end(), [&clip_bboxes](size_t l, size_t r) { return clip_bboxes[l].bbox.min.x() < clip_bboxes[r].bbox.min.x(); });
+    std::vector<std::vector<size_t>> cluster_clips(clusters.size());
+    std::vector<size_t> active_clusters;
+    std::vector<size_t> active_clips;
+    for (size_t i = 0, j = 0; i < cluster_order.size() || j < clip_order.size();)
+        if (j == clip_order.size() || (i < cluster_order.size() && cluster_bboxes[cluster_order[i]].min.x() <= clip_bboxes[clip_order[j]].bbox.min.x())) {
+            size_t             icluster = cluster_order[i ++];
+            const BoundingBox &bbox     = cluster_bboxes[icluster];
+            active_clips.erase(std::remove_if(active_clips.begin(), active_clips.end(), [&clip_bboxes, &bbox](size_t k) { return clip_bboxes[k].bbox.max.x() < bbox.min.x(); }), active_clips.end());
+            for (size_t k : active_clips)
+                if (bbox.overlap(clip_bboxes[k].bbox))
+                    cluster_clips[icluster].emplace_back(k);
+            active_clusters.emplace_back(icluster);
+        } else {
+            size_t             iclip = clip_order[j ++];
+            const BoundingBox &bbox  = clip_bboxes[iclip].bbox;
+            active_clusters.erase(std::remove_if(active_clusters.begin(), active_clusters.end(), [&cluster_bboxes, &bbox](size_t k) { return cluster_bboxes[k].max.x() < bbox.min.x(); }), active_clusters.end());
+            for (size_t k : active_clusters)
+                if (bbox.overlap(cluster_bboxes[k]))
+                    cluster_clips[k].emplace_back(iclip);
+            active_clips.emplace_back(iclip);
+        }
+
+    size_t num_clip_assigned = 0;
+    for (size_t icluster = 0; icluster < clusters.size(); ++ icluster) {
+        ClipperCluster      &cluster = clusters[icluster];
+        std::vector<size_t> &clips   = cluster_clips[icluster];
+        // Keep the clip paths in their input order.
+        std::sort(clips.begin(), clips.end());
+        cluster.clip.reserve(clips.size());
+        for (size_t k : clips) {
+            cluster.clip.emplace_back(clip_bboxes[k].path);
+            cluster.num_points += clip_bboxes[k].path->size();
+        }
+        num_clip_assigned += clips.size();
+    }
+
+    if (clusters.size() == 1 && num_clip_assigned == clip_bboxes.size())
+        // Nothing was culled and there is nothing to parallelize.
+        return {};
+    if (clipType == ClipperLib::ctIntersection)
+        // Clusters not touching any clip path produce no intersection.
+        clusters.erase(std::remove_if(clusters.begin(), clusters.end(), [](const ClipperCluster &c) { return c.clip.empty(); }), clusters.end());
+    return std::make_optional(std::move(clusters));
+}
+
+// Clip each cluster, in parallel if the clusters are large enough.
+template<typename TOut, typename Fn>
+static std::vector<TOut> clipper_clusters_process(const std::vector<ClipperCluster> &clusters, Fn &&fn)
+{
+    std::vector<TOut> out(clusters.size());
+    size_t num_points = 0;
+    for (const ClipperCluster &c : clusters)
+        num_points += c.num_points;
+    if (clusters.size() > 1 && num_points >= ClipperParallelMinPoints)
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, clusters.size()), [&clusters, &out, &fn](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                out[i] = fn(clusters[i]);
+        });
+    else
+        for (size_t i = 0; i < clusters.size(); ++ i)
+            out[i] = fn(clusters[i]);
+    return out;
+}
+
 template<class TSubj, class TClip>
 static inline Polygons _clipper(ClipperLib::ClipType clipType, TSubj &&subject, TClip &&clip, ApplySafetyOffset do_safety_offset)
 {
+    if (std::optional<std::vector<ClipperCluster>> clusters = clipper_clusters(clipType, subject, clip, do_safety_offset); clusters) {
+        std::vector<ClipperLib::Paths> results = clipper_clusters_process<ClipperLib::Paths>(*clusters, [clipType, do_safety_offset](const ClipperCluster &c) {
+            return clipper_do<ClipperLib::Paths>(clipType, ClipperUtils::PathPtrsProvider(c.subject), ClipperUtils::PathPtrsProvider(c.clip), ClipperLib::pftNonZero, do_safety_offset);
+        });
+        Polygons out;
+        out.reserve(std::accumulate(results.begin(), results.end(), size_t(0), [](size_t acc, const ClipperLib::Paths &p) { return acc + p.size(); }));
+        for (ClipperLib::Paths &paths : results)
+            for (ClipperLib::Path &path : paths)
+                out.emplace_back(std::move(path));
+        return out;
+    }
     return to_polygons(clipper_do<ClipperLib::Paths>(clipType, std::forward<TSubj>(subject), std::forward<TClip>(clip), ClipperLib::pftNonZero, do_safety_offset));
 }
 
@@ -595,7 +823,21 @@ Slic3r::Polygons union_(const Slic3r::Polygons &subject, const Slic3r::Polygons
 
 template <typename TSubject, typename TClip>
 static ExPolygons _clipper_ex(ClipperLib::ClipType clipType, TSubject &&subject,  TClip &&clip, ApplySafetyOffset do_safety_offset, ClipperLib::PolyFillType fill_type = ClipperLib::pftNonZero)
-    { return PolyTreeToExPolygons(clipper_do_polytree(clipType, std::forward<TSubject>(subject), std::forward<TClip>(clip), fill_type, do_safety_offset)); }
+{
+    if (std::optional<std::vector<ClipperCluster>> clusters = clipper_clusters(clipType, subject, clip, do_safety_offset); clusters) {
+        // Clusters do not overlap and no cluster could be nested inside a hole of another cluster,
+        // thus the ExPolygons of the clusters are just concatenated.
+        std::vector<ExPolygons> results = clipper_clusters_process<ExPolygons>(*clusters, [clipType, fill_type, do_safety_offset](const ClipperCluster &c) {
+            return PolyTreeToExPolygons(clipper_do_polytree(clipType, ClipperUtils::PathPtrsProvider(c.subject), ClipperUtils::PathPtrsProvider(c.clip), fill_type, do_safety_offset));
+        });
+        ExPolygons out;
+        out.reserve(std::accumulate(results.begin(), results.end(), size_t(0), [](size_t acc, const ExPolygons &e) { return acc + e.size(); }));
+        for (ExPolygons &expolys : results)
+            append(out, std::move(expolys));
+        return out;
+    }
+    return PolyTreeToExPolygons(clipper_do_polytree(clipType, std::forward<TSubject>(subject), std::forward<TClip>(clip), fill_type, do_safety_offset));
+}
 
 Slic3r::ExPolygons diff_ex(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
     { return _clipper_ex(ClipperLib::ctDifference, ClipperUtils::PolygonsProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset); }
@@ -677,11 +919,11 @@ Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons& poly1, const Slic3r::ExPol
 template<typename PathsProvider1, typename PathsProvider2>
 Polylines _clipper_pl_open(ClipperLib::ClipType clipType, PathsProvider1 &&subject, PathsProvider2 &&clip)
 {
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<PathsProvider1>(subject), ClipperLib::ptSubject, false);
-    clipper.AddPaths(std::forward<PathsProvider2>(clip), ClipperLib::ptClip, true);
+    ClipperUtils::CachedClipper clipper;
+    clipper->AddPaths(std::forward<PathsProvider1>(subject), ClipperLib::ptSubject, false);
+    clipper->AddPaths(std::forward<PathsProvider2>(clip), ClipperLib::ptClip, true);
     ClipperLib::PolyTree retval;
-    clipper.Execute(clipType, retval, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    clipper->Execute(clipType, retval, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     return PolyTreeToPolylines(std::move(retval));
 }
 
@@ -854,11 +1096,11 @@ Polygons simplify_polygons(const Polygons &subject, bool preserve_collinear)
 {
     ClipperLib::Paths output;
     if (preserve_collinear) {
-        ClipperLib::Clipper c;
-        c.PreserveCollinear(true);
-        c.StrictlySimple(true);
-        c.AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
-        c.Execute(ClipperLib::ctUnion, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        ClipperUtils::CachedClipper c;
+        c->PreserveCollinear(true);
+        c->StrictlySimple(true);
+        c->AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
+        c->Execute(ClipperLib::ctUnion, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     } else {
         output = ClipperLib::SimplifyPolygons(ClipperUtils::PolygonsProvider(subject), ClipperLib::pftNonZero);
     }
@@ -873,11 +1115,11 @@ ExPolygons simplify_polygons_ex(const Polygons &subject, bool preserve_collinear
         return union_ex(simplify_polygons(subject, false));
 
     ClipperLib::PolyTree polytree;    
-    ClipperLib::Clipper c;
-    c.PreserveCollinear(true);
-    c.StrictlySimple(true);
-    c.AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
-    c.Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    ClipperUtils::CachedClipper c;
+    c->PreserveCollinear(true);
+    c->StrictlySimple(true);
+    c->AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
+    c->Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     
     // convert into ExPolygons
     return PolyTreeToExPolygons(std::move(polytree));
@@ -886,12 +1128,12 @@ ExPolygons simplify_polygons_ex(const Polygons &subject, bool preserve_collinear
 Polygons top_level_islands(const Slic3r::Polygons &polygons)
 {
     // init Clipper
-    ClipperLib::Clipper clipper;
-    clipper.Clear();
+    ClipperUtils::CachedClipper clipper;
+    clipper->Clear();
     // perform union
-    clipper.AddPaths(ClipperUtils::PolygonsProvider(polygons), ClipperLib::ptSubject, true);
+    clipper->AddPaths(ClipperUtils::PolygonsProvider(polygons), ClipperLib::ptSubject, true);
     ClipperLib::PolyTree polytree;
-    clipper.Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd); 
+    clipper->Execute(ClipperLib::ctUnion, polytree, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd); 
     // Convert only the top level islands to the output.
     Polygons out;
     out.reserve(polytree.ChildCount());
@@ -910,10 +1152,10 @@ ClipperLib::Paths fix_after_outer_offset(
 {
   	ClipperLib::Paths solution;
   	if (! input.empty()) {
-		ClipperLib::Clipper clipper;
-	  	clipper.AddPath(input, ClipperLib::ptSubject, true);
-		clipper.ReverseSolution(reverse_result);
-		clipper.Execute(ClipperLib::ctUnion, solution, filltype, filltype);
+		ClipperUtils::CachedClipper clipper;
+	  	clipper->AddPath(input, ClipperLib::ptSubject, true);
+		clipper->ReverseSolution(reverse_result);
+		clipper->Execute(ClipperLib::ctUnion, solution, filltype, filltype);
 	}
     return solution;
 }
@@ -928,16 +1170,16 @@ ClipperLib::Paths fix_after_inner_offset(
 {
   	ClipperLib::Paths solution;
   	if (! input.empty()) {
-		ClipperLib::Clipper clipper;
-		clipper.AddPath(input, ClipperLib::ptSubject, true);
-		ClipperLib::IntRect r = clipper.GetBounds();
+		ClipperUtils::CachedClipper clipper;
+		clipper->AddPath(input, ClipperLib::ptSubject, true);
+		ClipperLib::IntRect r = clipper->GetBounds();
 		r.left -= 10; r.top -= 10; r.right += 10; r.bottom += 10;
 		if (filltype == ClipperLib::pftPositive)
-			clipper.AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.left, r.top), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.right, r.bottom) }, ClipperLib::ptSubject, true);
+			clipper->AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.left, r.top), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.right, r.bottom) }, ClipperLib::ptSubject, true);
 		else
-			clipper.AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.right, r.bottom), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.left, r.top) }, ClipperLib::ptSubject, true);
-		clipper.ReverseSolution(reverse_result);
-		clipper.Execute(ClipperLib::ctUnion, solution, filltype, filltype);
+			clipper->AddPath({ ClipperLib::IntPoint(r.left, r.bottom), ClipperLib::IntPoint(r.right, r.bottom), ClipperLib::IntPoint(r.right, r.top), ClipperLib::IntPoint(r.left, r.top) }, ClipperLib::ptSubject, true);
+		clipper->ReverseSolution(reverse_result);
+		clipper->Execute(ClipperLib::ctUnion, solution, filltype, filltype);
 		if (! solution.empty())
 			solution.erase(solution.begin());
 	}
@@ -1116,11 +1358,11 @@ Polygons variable_offset_inner(const ExPolygon &expoly, const std::vector<std::v
 	if (holes.empty())
 		output = std::move(contours);
 	else {
-		ClipperLib::Clipper clipper;
-		clipper.Clear();
-		clipper.AddPaths(contours, ClipperLib::ptSubject, true);
-		clipper.AddPaths(holes, ClipperLib::ptClip, true);
-		clipper.Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+		ClipperUtils::CachedClipper clipper;
+		clipper->Clear();
+		clipper->AddPaths(contours, ClipperLib::ptSubject, true);
+		clipper->AddPaths(holes, ClipperLib::ptClip, true);
+		clipper->Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
 	}
 
 	return to_polygons(std::move(output));
@@ -1158,11 +1400,11 @@ for (const std::vector<float>& ds : deltas)
 	if (holes.empty())
 		output = std::move(contours);
 	else {
-		ClipperLib::Clipper clipper;
-		clipper.Clear();
-		clipper.AddPaths(contours, ClipperLib::ptSubject, true);
-		clipper.AddPaths(holes, ClipperLib::ptClip, true);
-		clipper.Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+		ClipperUtils::CachedClipper clipper;
+		clipper->Clear();
+		clipper->AddPaths(contours, ClipperLib::ptSubject, true);
+		clipper->AddPaths(holes, ClipperLib::ptClip, true);
+		clipper->Execute(ClipperLib::ctDifference, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
 	}
 
 	return to_polygons(std::move(output));
@@ -1202,11 +1444,11 @@ for (const std::vector<float>& ds : deltas)
 		for (ClipperLib::Path &path : contours) 
 			output.emplace_back(std::move(path));
 	} else {
-		ClipperLib::Clipper clipper;
-		clipper.AddPaths(contours, ClipperLib::ptSubject, true);
-		clipper.AddPaths(holes, ClipperLib::ptClip, true);
+		ClipperUtils::CachedClipper clipper;
+		clipper->AddPaths(contours, ClipperLib::ptSubject, true);
+		clipper->AddPaths(holes, ClipperLib::ptClip, true);
 	    ClipperLib::PolyTree polytree;
-		clipper.Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+		clipper->Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
 	    output = PolyTreeToExPolygons(std::move(polytree));
 	}
 
@@ -1248,11 +1490,11 @@ ExPolygons variable_offset_inner_ex(const ExPolygon &expoly, const std::vector<s
 		for (ClipperLib::Path &path : contours) 
 			output.emplace_back(std::move(path));
 	} else {
-		ClipperLib::Clipper clipper;
-		clipper.AddPaths(contours, ClipperLib::ptSubject, true);
-		clipper.AddPaths(holes, ClipperLib::ptClip, true);
+		ClipperUtils::CachedClipper clipper;
+		clipper->AddPaths(contours, ClipperLib::ptSubject, true);
+		clipper->AddPaths(holes, ClipperLib::ptClip, true);
 	    ClipperLib::PolyTree polytree;
-		clipper.Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+		clipper->Execute(ClipperLib::ctDifference, polytree, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
 	    output = PolyTreeToExPolygons(std::move(polytree));
 	}
 
@@ -296,6 +296,67 @@ namespace ClipperUtils {
         const SurfacesPtr &m_surfaces;
         size_t             m_size;
     };
+
+    // Clipper / ClipperOffset instance cached per thread. Both engines keep their edge, output point and scanbeam
+    // buffers when reused, thus leasing the cached instance instead of constructing a new one saves most of
+    // the allocator traffic of the many small boolean operations performed per layer.
+    // The engine is handed out cleared and with default options. A nested lease of the same engine type
+    // gets a temporary instance.
+    template<class Engine>
+    class ThreadLocalEngine {
+    public:
+        ThreadLocalEngine() {
+            Slot &slot = ThreadLocalEngine::slot();
+            if (slot.busy) {
+                m_temp   = std::make_unique<Engine>();
+                m_engine = m_temp.get();
+            } else {
+                slot.busy = true;
+                m_slot    = &slot;
+                m_engine  = &slot.engine;
+                reset(*m_engine);
+            }
+        }
+        ~ThreadLocalEngine() {
+            if (m_slot) {
+                // Release the input paths, keep the buffers.
+                m_engine->Clear();
+                m_slot->busy = false;
+            }
+        }
+        ThreadLocalEngine(const ThreadLocalEngine &) = delete;
+        ThreadLocalEngine& operator=(const ThreadLocalEngine &) = delete;
+
+        Engine& operator*()  const { return *m_engine; }
+        Engine* operator->() const { return m_engine; }
+
+    private:
+        struct Slot {
+            Engine engine;
+            bool   busy { false };
+        };
+        static Slot& slot() { static thread_local Slot s; return s; }
+
+        static void reset(ClipperLib::Clipper &clipper) {
+            clipper.Clear();
+            clipper.ReverseSolution(false);
+            clipper.StrictlySimple(false);
+            clipper.PreserveCollinear(false);
+        }
+        static void reset(ClipperLib::ClipperOffset &co) {
+            co.Clear();
+            co.MiterLimit         = 2.;
+            co.ArcTolerance       = 0.25;
+            co.ShortestEdgeLength = 0.;
+        }
+
+        Slot                   *m_slot { nullptr };
+        std::unique_ptr<Engine> m_temp;
+        Engine                 *m_engine { nullptr };
+    };
+
+    using CachedClipper       = ThreadLocalEngine<ClipperLib::Clipper>;
+    using CachedClipperOffset = ThreadLocalEngine<ClipperLib::ClipperOffset>;
 }
 
 // Perform union of input polygons using the non-zero rule, convert to ExPolygons.
@@ -357,6 +418,12 @@ Slic3r::Polygons   offset2(const Slic3r::ExPolygons &expolygons, const float del
 Slic3r::ExPolygons offset2_ex(const Slic3r::ExPolygons &expolygons, const float delta1, const float delta2, ClipperLib::JoinType joinType = DefaultJoinType, double miterLimit = DefaultMiterLimit);
 Slic3r::ExPolygons offset2_ex(const Slic3r::Surfaces &surfaces, const float delta1, const float delta2, ClipperLib::JoinType joinType = DefaultJoinType, double miterLimit = DefaultMiterLimit);
 
+// Batched variants for many small islands: each ExPolygon is offsetted on its own without any union between
+// the islands, the result at index i belongs to expolygons[i]. Same as calling offset_ex() / offset2_ex()
+// on each island, but the intermediate buffers are shared by the whole batch.
+std::vector<Slic3r::ExPolygons> offset_ex_batch(const Slic3r::ExPolygons &expolygons, const float delta, ClipperLib::JoinType joinType = DefaultJoinType, double miterLimit = DefaultMiterLimit);
+std::vector<Slic3r::ExPolygons> offset2_ex_batch(const Slic3r::ExPolygons &expolygons, const float delta1, const float delta2, ClipperLib::JoinType joinType = DefaultJoinType, double miterLimit = DefaultMiterLimit);
+
 // BBS
 Slic3r::ExPolygons _clipper_ex(ClipperLib::ClipType clipType,
     const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, bool safety_offset_ = false);
@@ -370,10 +370,13 @@ void export_group_fills_to_svg(const char *path, const std::vector<SurfaceFill>
 #endif
 
 // friend to Layer
-void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive::Octree* support_fill_octree)
+void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive::Octree* support_fill_octree, FillPatternCache* pattern_cache)
 {
-	for (LayerRegion *layerm : m_regions)
+	for (LayerRegion *layerm : m_regions) {
 		layerm->fills.clear();
+		layerm->m_fills_simplified = false;
+	}
+	m_fills_ironed = false;
 
 
 #ifdef SLIC3R_DEBUG_SLICE_PROCESSING
@@ -399,6 +402,7 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
         f->z 		= this->print_z;
         f->angle 	= surface_fill.params.angle;
         f->adapt_fill_octree = (surface_fill.params.pattern == ipSupportCubic) ? support_fill_octree : adaptive_fill_octree;
+        f->pattern_cache = pattern_cache;
 
         // calculate flow spacing for infill pattern generation
         bool using_internal_flow = ! surface_fill.surface.is_solid() && ! surface_fill.params.bridge;
@@ -466,6 +470,11 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
 // Create ironing extrusions over top surfaces.
 void Layer::make_ironing()
 {
+	// The ironing extrusions were already added to the fills, which were kept by PrintObject::infill().
+	if (m_fills_ironed)
+		return;
+	m_fills_ironed = true;
+
 	// LayerRegion::slices contains surfaces marked with SurfaceType.
 	// Here we want to collect top surfaces extruded with the same extruder.
 	// A surface will be ironed with the same extruder to not contaminate the print with another material leaking from the nozzle.
@@ -656,6 +665,7 @@ void Layer::make_ironing()
 		        // Save into layer.
 				ExtrusionEntityCollection *eec = nullptr;
 		        ironing_params.layerm->fills.entities.push_back(eec = new ExtrusionEntityCollection());
+		        ironing_params.layerm->m_fills_simplified = false;
 		        // Don't sort the ironing infill lines as they are monotonicly ordered.
 				eec->no_sort = true;
 		        extrusion_entities_append_paths(
@@ -150,13 +150,31 @@ void Fill3DHoneycomb::_fill_surface_single(
     bb.merge(align_to_grid(bb.min, Point(2*distance, 2*distance)));
     
     // generate pattern
+    size_t      curve_type = ((this->layer_id/thickness_layers) % 2) + 1;
     Polylines   polylines = makeGrid(
         scale_(this->z),
         distance,
         ceil(bb.size()(0) / distance) + 1,
         ceil(bb.size()(1) / distance) + 1,
-        ((this->layer_id/thickness_layers) % 2) + 1);
-    
+        curve_type);
+
+    // keep just the parts of the lines overlapping the expolygon, a line i oscillates around i * distance by less than distance / 2
+    {
+        bool     columns = curve_type == 1;
+        Polygons boundary = to_polygons(expolygon);
+        for (Polygon &polygon : boundary) {
+            polygon.translate(- bb.min);
+            if (columns)
+                for (Point &pt : polygon.points)
+                    std::swap(pt.x(), pt.y());
+        }
+        std::vector<Spans> spans = _band_spans(boundary, - distance / 2, distance, distance, polylines.size(), distance);
+        Polylines cropped;
+        for (size_t i = 0; i < polylines.size(); ++ i)
+            _crop_to_spans(polylines[i], spans[i], columns, cropped);
+        polylines = std::move(cropped);
+    }
+
     // move pattern in place
 	for (Polyline &pl : polylines)
 		pl.translate(bb.min);
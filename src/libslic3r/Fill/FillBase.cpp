@@ -164,6 +164,113 @@ coord_t Fill::_adjust_solid_spacing(const coord_t width, const coord_t distance)
     return distance_new;
 }
 
+std::shared_ptr<const FillPatternCache::Pattern> FillPatternCache::get(const Key &key, const std::function<Pattern()> &create)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (auto it = m_patterns.find(key); it != m_patterns.end())
+            return it->second;
+    }
+    // Generate outside of the lock, another thread may have cached the same pattern in the meantime.
+    auto pattern = std::make_shared<const Pattern>(create());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_patterns.emplace(key, std::move(pattern)).first->second;
+}
+
+std::vector<Fill::Spans> Fill::_band_spans(const Polygons &polygons, coord_t y_min, coord_t step, coord_t height, size_t num_bands, coord_t min_gap)
+{
+    assert(step > 0);
+    assert(height >= 0);
+    std::vector<Spans> out(num_bands);
+    if (num_bands == 0)
+        return out;
+    // The projection of the part of a polygon inside a band is covered by the projections of the edge segments inside the band
+    // and of the intervals of the band bottom and top lines inside the polygon. The latter are delimited by the edge crossings.
+    std::vector<std::vector<coord_t>> crossings_bottom(num_bands);
+    std::vector<std::vector<coord_t>> crossings_top(num_bands);
+    auto crossing = [](const Point &a, const Point &b, coord_t y) {
+        return coord_t(floor(double(a.x()) + double(b.x() - a.x()) * double(y - a.y()) / double(b.y() - a.y()) + 0.5));
+    };
+    for (const Polygon &polygon : polygons)
+        for (size_t i = 0; i < polygon.points.size(); ++ i) {
+            const Point &a   = polygon.points[i];
+            const Point &b   = polygon.points[i + 1 == polygon.points.size() ? 0 : i + 1];
+            coord_t      ey0 = std::min(a.y(), b.y());
+            coord_t      ey1 = std::max(a.y(), b.y());
+            // Bands overlapping the edge.
+            int64_t ifirst = std::max<int64_t>(0, int64_t(ceil(double(ey0 - height - y_min) / double(step))));
+            int64_t ilast  = std::min<int64_t>(int64_t(num_bands) - 1, int64_t(floor(double(ey1 - y_min) / double(step))));
+            for (int64_t iband = ifirst; iband <= ilast; ++ iband) {
+                coord_t lo = y_min + coord_t(iband) * step;
+                coord_t hi = lo + height;
+                coord_t x0 = std::min(a.x(), b.x());
+                coord_t x1 = std::max(a.x(), b.x());
+                if (a.y() != b.y()) {
+                    // Clip the edge to the band.
+                    if (ey0 < lo || ey1 > hi) {
+                        double t0 = std::clamp(double(lo - a.y()) / double(b.y() - a.y()), 0., 1.);
+                        double t1 = std::clamp(double(hi - a.y()) / double(b.y() - a.y()), 0., 1.);
+                        double xa = double(a.x()) + double(b.x() - a.x()) * t0;
+                        double xb = double(a.x()) + double(b.x() - a.x()) * t1;
+                        x0 = coord_t(floor(std::min(xa, xb)));
+                        x1 = coord_t(ceil(std::max(xa, xb)));
+                    }
+                    // Crossings with the bottom and top lines, half open to count each vertex once.
+                    if ((a.y() <= lo) != (b.y() <= lo))
+                        crossings_bottom[iband].emplace_back(crossing(a, b, lo));
+                    if ((a.y() <= hi) != (b.y() <= hi))
+                        crossings_top[iband].emplace_back(crossing(a, b, hi));
+                }
+                out[iband].emplace_back(x0, x1);
+            }
+        }
+
+    for (size_t iband = 0; iband < num_bands; ++ iband) {
+        Spans &spans = out[iband];
+        for (std::vector<coord_t> *crossings : { &crossings_bottom[iband], &crossings_top[iband] }) {
+            assert(crossings->size() % 2 == 0);
+            std::sort(crossings->begin(), crossings->end());
+            for (size_t i = 0; i + 1 < crossings->size(); i += 2)
+                spans.emplace_back((*crossings)[i], (*crossings)[i + 1]);
+        }
+        if (spans.empty())
+            continue;
+        std::sort(spans.begin(), spans.end());
+        size_t j = 0;
+        for (size_t i = 1; i < spans.size(); ++ i)
+            if (spans[i].first <= spans[j].second + min_gap)
+                spans[j].second = std::max(spans[j].second, spans[i].second);
+            else
+                spans[++ j] = spans[i];
+        spans.erase(spans.begin() + j + 1, spans.end());
+    }
+    return out;
+}
+
+void Fill::_crop_to_spans(const Polyline &polyline, const Spans &spans, bool along_y, Polylines &out)
+{
+    const int axis = along_y ? 1 : 0;
+    auto overlaps = [&spans](coord_t lo, coord_t hi) {
+        // First span not ending before lo.
+        auto it = std::lower_bound(spans.begin(), spans.end(), lo, [](const std::pair<coord_t, coord_t> &span, coord_t v) { return span.second < v; });
+        return it != spans.end() && it->first <= hi;
+    };
+    bool open = false;
+    for (size_t i = 1; i < polyline.points.size(); ++ i) {
+        const Point &a = polyline.points[i - 1];
+        const Point &b = polyline.points[i];
+        if (overlaps(std::min(a(axis), b(axis)), std::max(a(axis), b(axis)))) {
+            if (! open) {
+                out.emplace_back();
+                out.back().points.emplace_back(a);
+                open = true;
+            }
+            out.back().points.emplace_back(b);
+        } else
+            open = false;
+    }
+}
+
 // Returns orientation of the infill and the reference point of the infill pattern.
 // For a normal print, the reference point is the center of a bounding box of the STL.
 std::pair<float, Point> Fill::_infill_direction(const Surface *surface) const
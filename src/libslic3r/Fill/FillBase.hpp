@@ -7,6 +7,10 @@
 #include <stdint.h>
 #include <stdexcept>
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <type_traits>
 
 #include "../libslic3r.h"
@@ -29,6 +33,41 @@ namespace FillAdaptive {
     struct Octree;
 };
 
+// Unclipped infill patterns shared by all the layers of an object.
+// A periodic pattern depends on its angle, spacing, density and phase only, thus it is generated once
+// over the bounding box of the object and reused by all the layers with the same key, leaving just the clipping to each layer.
+// Thread safe, the layers are filled in parallel.
+class FillPatternCache
+{
+public:
+    struct Key
+    {
+        InfillPattern   pattern;
+        float           angle;
+        coordf_t        spacing;
+        float           density;
+        // Phase of a pattern, which is not constant along z.
+        int             phase { 0 };
+
+        bool operator<(const Key &rhs) const 
+            { return std::tie(pattern, angle, spacing, density, phase) < std::tie(rhs.pattern, rhs.angle, rhs.spacing, rhs.density, rhs.phase); }
+    };
+
+    struct Pattern
+    {
+        // Area covered by the pattern, in the coordinate system of the pattern.
+        BoundingBox     bbox;
+        Polylines       polylines;
+    };
+
+    // Return the pattern stored for key, create it first if it is not cached yet.
+    std::shared_ptr<const Pattern> get(const Key &key, const std::function<Pattern()> &create);
+
+private:
+    std::mutex                                      m_mutex;
+    std::map<Key, std::shared_ptr<const Pattern>>   m_patterns;
+};
+
 // Infill shall never fail, therefore the error is classified as RuntimeError, not SlicingError.
 class InfillFailedException : public Slic3r::RuntimeError {
 public:
@@ -96,6 +135,8 @@ public:
 
     // Octree builds on mesh for usage in the adaptive cubic infill
     FillAdaptive::Octree* adapt_fill_octree = nullptr;
+    // Patterns shared by the layers of the object, optional.
+    FillPatternCache*   pattern_cache = nullptr;
 
     // BBS: all no overlap expolygons in same layer
     ExPolygons  no_overlap_expolygons;
@@ -162,6 +203,16 @@ public:
     static void connect_base_support(Polylines &&infill_ordered, const Polygons &boundary_src, const BoundingBox &bbox, Polylines &polylines_out, const double spacing, const FillParams &params);
 
     static coord_t  _adjust_solid_spacing(const coord_t width, const coord_t distance);
+
+    // Sorted disjoint intervals <min, max> along a line.
+    using Spans = std::vector<std::pair<coord_t, coord_t>>;
+    // For each of num_bands horizontal bands <y_min + i * step, y_min + i * step + height>, calculate the x intervals
+    // covered by the parts of polygons inside the band. Intervals closer than min_gap are merged.
+    // Used by the pattern generators to emit the pattern only where it may overlap the region to be filled
+    // instead of over its whole bounding box, which is expensive for small or thin islands.
+    static std::vector<Spans> _band_spans(const Polygons &polygons, coord_t y_min, coord_t step, coord_t height, size_t num_bands, coord_t min_gap);
+    // Append the runs of segments of polyline overlapping spans along the x axis (y axis if along_y) to out.
+    static void     _crop_to_spans(const Polyline &polyline, const Spans &spans, bool along_y, Polylines &out);
 };
 
 } // namespace Slic3r
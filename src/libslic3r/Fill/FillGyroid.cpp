@@ -4,6 +4,7 @@
 #include <cmath>
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
 #include "FillGyroid.hpp"
 
@@ -29,24 +30,38 @@ static inline double f(double x, double z_sin, double z_cos, bool vertical, bool
     }
 }
 
+// Make a wave from the periodic one_period, limited to <x_min, x_max> extended by a single point to each side.
 static inline Polyline make_wave(
     const std::vector<Vec2d>& one_period, double width, double height, double offset, double scaleFactor,
-    double z_cos, double z_sin, bool vertical, bool flip)
+    double z_cos, double z_sin, bool vertical, bool flip, double x_min = 0., double x_max = std::numeric_limits<double>::max())
 {
-    std::vector<Vec2d> points = one_period;
-    double period = points.back()(0);
+    std::vector<Vec2d> points;
+    double period = one_period.back()(0);
     if (width != period) // do not extend if already truncated
     {
-        points.reserve(one_period.size() * size_t(floor(width / period)));
-        points.pop_back();
-
-        size_t n = points.size();
+        // Index of the last point of one_period at or before x_min, the last point of one_period is the first point of the next period.
+        size_t n = one_period.size() - 1;
+        double k = 0.;
+        size_t i = 0;
+        if (x_min > 0.) {
+            k = floor(x_min / period);
+            i = size_t(std::upper_bound(one_period.begin(), one_period.begin() + n, x_min - k * period,
+                [](double x, const Vec2d &pt) { return x < pt.x(); }) - one_period.begin()) - 1;
+        }
+        double x;
         do {
-            points.emplace_back(points[points.size()-n].x() + period, points[points.size()-n].y());
-        } while (points.back()(0) < width - EPSILON);
+            x = k * period + one_period[i].x();
+            points.emplace_back(x, one_period[i].y());
+            if (++ i == n) {
+                i = 0;
+                k += 1.;
+            }
+        } while (x < width - EPSILON && x < x_max);
 
-        points.emplace_back(Vec2d(width, f(width, z_sin, z_cos, vertical, flip)));
-    }
+        if (x >= width - EPSILON)
+            points.emplace_back(Vec2d(width, f(width, z_sin, z_cos, vertical, flip)));
+    } else
+        points = one_period;
 
     // and construct the final polyline to return:
     Polyline polyline;
@@ -102,7 +117,8 @@ static std::vector<Vec2d> make_one_period(double width, double scaleFactor, doub
     return points;
 }
 
-static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height)
+// Generate the waves only over the spans of their bands overlapping the boundary, provided in the pattern coordinate system.
+static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height, const Polygons &boundary)
 {
     const double scaleFactor = scale_(line_spacing) / density_adjusted;
 
@@ -132,13 +148,34 @@ static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double
     std::vector<Vec2d> one_period_even = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance);
     Polylines result;
 
-    for (double y0 = lower_bound; y0 < upper_bound + EPSILON; y0 += M_PI) {
-        // creates odd polylines
-        result.emplace_back(make_wave(one_period_odd, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
-        // creates even polylines
-        y0 += M_PI;
-        if (y0 < upper_bound + EPSILON) {
-            result.emplace_back(make_wave(one_period_even, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
+    // Spans of the boundary inside the band of each wave. A wave spans <-0.5 PI, 2 PI> around its offset.
+    size_t num_waves = 0;
+    for (double y0 = lower_bound; y0 < upper_bound + EPSILON; y0 += M_PI)
+        ++ num_waves;
+    std::vector<Fill::Spans> spans;
+    {
+        Polygons boundary_pattern = boundary;
+        if (vertical)
+            for (Polygon &polygon : boundary_pattern)
+                for (Point &pt : polygon.points)
+                    std::swap(pt.x(), pt.y());
+        spans = Fill::_band_spans(boundary_pattern, coord_t((lower_bound - 0.5 * M_PI) * scaleFactor), coord_t(M_PI * scaleFactor),
+            coord_t(2.5 * M_PI * scaleFactor) + 1, num_waves, coord_t(M_PI * scaleFactor));
+    }
+
+    for (size_t iwave = 0; iwave < num_waves; ++ iwave) {
+        // odd and even polylines alternate
+        double y0 = lower_bound + double(iwave) * M_PI;
+        const std::vector<Vec2d> &one_period = (iwave & 1) ? one_period_even : one_period_odd;
+        if (one_period.back().x() == width) {
+            // A single period covers the whole width and make_wave() does not crop it to a span,
+            // thus emit the wave just once for all the spans of the band.
+            if (! spans[iwave].empty())
+                result.emplace_back(make_wave(one_period, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
+        } else {
+            for (const std::pair<coord_t, coord_t> &span : spans[iwave])
+                result.emplace_back(make_wave(one_period, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip,
+                    double(span.first) / scaleFactor, double(span.second) / scaleFactor));
         }
     }
 
@@ -168,13 +205,17 @@ void FillGyroid::_fill_surface_single(
     // align bounding box to a multiple of our grid module
     bb.merge(align_to_grid(bb.min, Point(2*M_PI*distance, 2*M_PI*distance)));
 
-    // generate pattern
+    // generate pattern where it overlaps the expolygon
+    Polygons boundary = to_polygons(expolygon);
+    for (Polygon &polygon : boundary)
+        polygon.translate(- bb.min);
     Polylines polylines = make_gyroid_waves(
         scale_(this->z),
         density_adjusted,
         this->spacing,
         ceil(bb.size()(0) / distance) + 1.,
-        ceil(bb.size()(1) / distance) + 1.);
+        ceil(bb.size()(1) / distance) + 1.,
+        boundary);
 
 	// shift the polyline to the grid origin
 	for (Polyline &pl : polylines)
@@ -32,24 +32,24 @@ void FillHoneycomb::_fill_surface_single(
     }
     CacheData &m = it_m->second;
 
-    Polylines all_polylines;
-    {
-        // adjust actual bounding box to the nearest multiple of our hex pattern
-        // and align it so that it matches across layers
-        
-        BoundingBox bounding_box = expolygon.contour.bounding_box();
-        {
-            // rotate bounding box according to infill direction
-            Polygon bb_polygon = bounding_box.polygon();
-            bb_polygon.rotate(direction.first, m.hex_center);
-            bounding_box = bb_polygon.bounding_box();
-            
-            // extend bounding box so that our pattern will be aligned with other layers
-            // $bounding_box->[X1] and [Y1] represent the displacement between new bounding box offset and old one
-            // The infill is not aligned to the object bounding box, but to a world coordinate system. Supposedly good enough.
-            bounding_box.merge(align_to_grid(bounding_box.min, Point(m.hex_width, m.pattern_height)));
-        }
+    // adjust actual bounding box to the nearest multiple of our hex pattern
+    // and align it so that it matches across layers
+    auto align_bounding_box = [&m, &direction](BoundingBox bounding_box) {
+        // rotate bounding box according to infill direction
+        Polygon bb_polygon = bounding_box.polygon();
+        bb_polygon.rotate(direction.first, m.hex_center);
+        bounding_box = bb_polygon.bounding_box();
+
+        // extend bounding box so that our pattern will be aligned with other layers
+        // $bounding_box->[X1] and [Y1] represent the displacement between new bounding box offset and old one
+        // The infill is not aligned to the object bounding box, but to a world coordinate system. Supposedly good enough.
+        bounding_box.merge(align_to_grid(bounding_box.min, Point(m.hex_width, m.pattern_height)));
+        return bounding_box;
+    };
 
+    // generate the columns of the pattern covering the bounding box, not rotated yet
+    auto make_columns = [&m](const BoundingBox &bounding_box) {
+        Polylines columns;
         coord_t x = bounding_box.min(0);
         while (x <= bounding_box.max(0)) {
             Polyline p;
@@ -68,8 +68,54 @@ void FillHoneycomb::_fill_surface_single(
                 std::swap(ax[0], ax[1]); // draw symmetrical pattern
                 x += m.distance;
             }
-            p.rotate(-direction.first, m.hex_center);
-            all_polylines.push_back(p);
+            columns.emplace_back(std::move(p));
+        }
+        return columns;
+    };
+
+    Polylines all_polylines;
+    {
+        BoundingBox bounding_box = align_bounding_box(expolygon.contour.bounding_box());
+
+        // The pattern depends on the direction, density and spacing only: reuse the columns covering the whole object
+        // generated by the first layer with the same parameters.
+        std::shared_ptr<const FillPatternCache::Pattern> pattern;
+        if (this->pattern_cache != nullptr && this->bounding_box.defined) {
+            pattern = this->pattern_cache->get({ ipHoneycomb, direction.first, this->spacing, params.density }, [this, &align_bounding_box, &make_columns]() {
+                FillPatternCache::Pattern out;
+                out.bbox      = align_bounding_box(this->bounding_box);
+                out.polylines = make_columns(out.bbox);
+                return out;
+            });
+            if (! pattern->bbox.contains(bounding_box.min) || ! pattern->bbox.contains(bounding_box.max))
+                pattern.reset();
+        }
+        if (! pattern) {
+            auto local = std::make_shared<FillPatternCache::Pattern>();
+            local->bbox      = bounding_box;
+            local->polylines = make_columns(bounding_box);
+            pattern = std::move(local);
+        }
+
+        // spans of the expolygon along each column of the pattern, to emit only the parts of the columns overlapping the expolygon
+        size_t             first_column = size_t((bounding_box.min(0) - pattern->bbox.min(0)) / m.hex_width);
+        size_t             num_columns  = std::min(size_t((bounding_box.max(0) - bounding_box.min(0)) / m.hex_width) + 1, pattern->polylines.size() - first_column);
+        std::vector<Spans> column_spans;
+        {
+            Polygons boundary = to_polygons(expolygon);
+            for (Polygon &polygon : boundary) {
+                polygon.rotate(direction.first, m.hex_center);
+                for (Point &pt : polygon.points)
+                    std::swap(pt.x(), pt.y());
+            }
+            column_spans = _band_spans(boundary, bounding_box.min(0), m.hex_width, m.hex_width, num_columns, m.hex_side);
+        }
+
+        for (size_t column = 0; column < num_columns; ++ column) {
+            size_t first_cropped = all_polylines.size();
+            _crop_to_spans(pattern->polylines[first_column + column], column_spans[column], true, all_polylines);
+            for (auto it = all_polylines.begin() + first_cropped; it != all_polylines.end(); ++ it)
+                it->rotate(-direction.first, m.hex_center);
         }
     }
     
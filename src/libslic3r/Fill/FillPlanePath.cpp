@@ -35,14 +35,28 @@ void FillPlanePath::_fill_surface_single(
         params.resolution);
 
     if (pts.size() >= 2) {
-        // Convert points to a polyline, upscale.
-        Polylines polylines(1, Polyline());
-        Polyline &polyline = polylines.front();
-        polyline.points.reserve(pts.size());
-        for (const Vec2d &pt : pts)
-            polyline.points.emplace_back(
-                coord_t(floor(pt.x() * distance_between_lines + 0.5)),
-                coord_t(floor(pt.y() * distance_between_lines + 0.5)));
+        // Convert points to polylines, upscale. The curve covers the whole object, keep just its runs
+        // crossing the bounding box of this expolygon to not clip the whole curve with a possibly small island.
+        BoundingBox bbox_expolygon = get_extents(expolygon);
+        bbox_expolygon.offset(distance_between_lines);
+        auto scaled_point = [&pts, distance_between_lines](size_t i) {
+            return Point(coord_t(floor(pts[i].x() * distance_between_lines + 0.5)), coord_t(floor(pts[i].y() * distance_between_lines + 0.5)));
+        };
+        Polylines polylines;
+        bool      open = false;
+        for (size_t i = 1; i < pts.size(); ++ i) {
+            const Point prev = scaled_point(i - 1);
+            const Point pt   = scaled_point(i);
+            if (bbox_expolygon.overlap(BoundingBox(Point(prev.cwiseMin(pt)), Point(prev.cwiseMax(pt))))) {
+                if (! open) {
+                    polylines.emplace_back();
+                    polylines.back().points.emplace_back(prev);
+                    open = true;
+                }
+                polylines.back().points.emplace_back(pt);
+            } else
+                open = false;
+        }
         polylines = intersection_pl(polylines, expolygon);
         Polylines chained;
         if (params.dont_connect() || params.density > 0.5 || polylines.size() <= 1)
@@ -470,7 +470,7 @@ std::unique_ptr<sla::RasterBase> SL1Archive::create_raster() const
 
     double gamma = m_cfg.gamma_correction.getFloat();
 
-    return sla::create_raster_grayscale_aa(res, pxdim, gamma, tr);
+    return sla::create_raster_grayscale_aa_rle(res, pxdim, gamma, tr);
 }
 
 sla::RasterEncoder SL1Archive::get_encoder() const
@@ -478,6 +478,11 @@ sla::RasterEncoder SL1Archive::get_encoder() const
     return sla::PNGRasterEncoder{};
 }
 
+sla::RasterRowEncoder SL1Archive::get_row_encoder() const
+{
+    return sla::PNGRasterEncoder{};
+}
+
 void SL1Archive::export_print(Zipper& zipper,
                               const SLAPrint &print,
                               const std::string &prjname)
@@ -14,6 +14,7 @@ class SL1Archive: public SLAArchive {
 protected:
     std::unique_ptr<sla::RasterBase> create_raster() const override;
     sla::RasterEncoder get_encoder() const override;
+    sla::RasterRowEncoder get_row_encoder() const override;
 
 public:
     
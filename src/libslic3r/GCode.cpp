@@ -239,7 +239,7 @@ bool GCode::gcode_label_objects = false;
         return Point(scale_(wipe_tower_pt.x() - gcodegen.origin()(0)), scale_(wipe_tower_pt.y() - gcodegen.origin()(1)));
     }
 
-    std::string WipeTowerIntegration::append_tcr(GCode& gcodegen, const WipeTower::ToolChangeResult& tcr, int new_extruder_id, double z) const
+    std::string WipeTowerIntegration::append_tcr(GCode& gcodegen, const WipeTower::ToolChangeResult& tcr, int new_extruder_id, double z, const std::string *tcr_rotated_gcode) const
     {
         if (new_extruder_id != -1 && new_extruder_id != tcr.new_tool)
             throw Slic3r::InvalidArgument("Error: WipeTowerIntegration::append_tcr was asked to do a toolchange it didn't expect.");
@@ -263,10 +263,13 @@ bool GCode::gcode_label_objects = false;
             end_pos = transform_wt_pt(end_pos);
         }
 
-        Vec2f wipe_tower_offset = tcr.priming ? Vec2f::Zero() : m_wipe_tower_pos;
-        float wipe_tower_rotation = tcr.priming ? 0.f : alpha;
-
-        std::string tcr_rotated_gcode = post_process_wipe_tower_moves(tcr, wipe_tower_offset, wipe_tower_rotation);
+        std::string tcr_rotated_gcode_local;
+        if (tcr_rotated_gcode == nullptr) {
+            Vec2f wipe_tower_offset = tcr.priming ? Vec2f::Zero() : m_wipe_tower_pos;
+            float wipe_tower_rotation = tcr.priming ? 0.f : alpha;
+            tcr_rotated_gcode_local = post_process_wipe_tower_moves(tcr, wipe_tower_offset, wipe_tower_rotation);
+            tcr_rotated_gcode = &tcr_rotated_gcode_local;
+        }
 
         // BBS: add partplate logic
         Vec2f plate_origin_2d(m_plate_origin(0), m_plate_origin(1));
@@ -428,7 +431,7 @@ bool GCode::gcode_label_objects = false;
         config.set_key_value("filament_end_gcode", new ConfigOptionString(end_filament_gcode_str));
         config.set_key_value("change_filament_gcode", new ConfigOptionString(toolchange_gcode_str));
         config.set_key_value("filament_start_gcode", new ConfigOptionString(start_filament_gcode_str));
-        std::string tcr_gcode, tcr_escaped_gcode = gcodegen.placeholder_parser_process("tcr_rotated_gcode", tcr_rotated_gcode, new_extruder_id, &config);
+        std::string tcr_gcode, tcr_escaped_gcode = gcodegen.placeholder_parser_process("tcr_rotated_gcode", *tcr_rotated_gcode, new_extruder_id, &config);
         unescape_string_cstyle(tcr_escaped_gcode, tcr_gcode);
         gcode += tcr_gcode;
         check_add_eol(toolchange_gcode_str);
@@ -535,6 +538,20 @@ bool GCode::gcode_label_objects = false;
         return gcode_out;
     }
 
+    void WipeTowerIntegration::init_tool_changes_gcode()
+    {
+        const float alpha = m_wipe_tower_rotation / 180.f * float(M_PI);
+        m_tool_changes_gcode.assign(m_tool_changes.size(), {});
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_tool_changes.size()), [this, alpha](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+                const std::vector<WipeTower::ToolChangeResult> &tool_changes = m_tool_changes[layer_idx];
+                std::vector<std::string>                       &gcodes       = m_tool_changes_gcode[layer_idx];
+                gcodes.reserve(tool_changes.size());
+                for (const WipeTower::ToolChangeResult &tcr : tool_changes)
+                    gcodes.emplace_back(post_process_wipe_tower_moves(tcr, tcr.priming ? Vec2f::Zero() : m_wipe_tower_pos, tcr.priming ? 0.f : alpha));
+            }
+        });
+    }
 
     std::string WipeTowerIntegration::prime(GCode& gcodegen)
     {
@@ -569,7 +586,8 @@ bool GCode::gcode_label_objects = false;
                 }
 
                 if (!ignore_sparse) {
-                    gcode += append_tcr(gcodegen, m_tool_changes[m_layer_idx][m_tool_change_idx++], extruder_id, wipe_tower_z);
+                    gcode += append_tcr(gcodegen, m_tool_changes[m_layer_idx][m_tool_change_idx], extruder_id, wipe_tower_z, &m_tool_changes_gcode[m_layer_idx][m_tool_change_idx]);
+                    ++ m_tool_change_idx;
                     m_last_wipe_tower_print_z = wipe_tower_z;
                 }
             }
@@ -1803,6 +1821,50 @@ void GCode::check_placeholder_parser_failed()
     }
 }
 
+// Layer to be processed by the G-code export pipeline together with the data precomputed for it by a parallel stage:
+// The travel boundaries of its object and support layers and the distance fields over the lower layers for seam placement.
+// Passed through the pipeline by a shared pointer, as the pipeline tokens have to be copyable.
+struct LayerToProcess
+{
+    size_t                                        idx { 0 };
+    AvoidCrossingPerimeters::LayerBoundariesPtrs  travel_boundaries;
+    std::vector<std::unique_ptr<EdgeGrid::Grid>>  lower_layer_edge_grids;
+};
+
+static std::unique_ptr<EdgeGrid::Grid> calculate_layer_edge_grid(const Layer& layer);
+
+// Calculate the distance fields over the lower layers of the object layers with perimeters, as they are needed for
+// seam placement by GCode::extrude_perimeters(). Indexed the same as layers_to_print.
+static std::vector<std::unique_ptr<EdgeGrid::Grid>> precompute_lower_layer_edge_grids(const std::vector<GCode::LayerToPrint> &layers_to_print)
+{
+    std::vector<std::unique_ptr<EdgeGrid::Grid>> out(layers_to_print.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, layers_to_print.size()), [&layers_to_print, &out](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            if (const Layer *layer = layers_to_print[i].object_layer; layer != nullptr && layer->lower_layer != nullptr &&
+                std::any_of(layer->regions().begin(), layer->regions().end(), [](const LayerRegion *layerm) { return ! layerm->perimeters.entities.empty(); }))
+                out[i] = calculate_layer_edge_grid(*layer->lower_layer);
+    });
+    return out;
+}
+
+// Calculate the internal travel boundaries of the layers printed at a single print_z in parallel. Called from a parallel stage
+// of the G-code export pipeline, so the boundaries of at most the pipeline token count of print_z are held in memory.
+// The external boundary is calculated by AvoidCrossingPerimeters on demand, once per print_z.
+static AvoidCrossingPerimeters::LayerBoundariesPtrs precompute_travel_boundaries(const std::vector<GCode::LayerToPrint> &layers_to_print)
+{
+    std::vector<const Layer*> layers;
+    for (const GCode::LayerToPrint &layer_to_print : layers_to_print)
+        for (const Layer *layer : { layer_to_print.object_layer, static_cast<const Layer*>(layer_to_print.support_layer), static_cast<const Layer*>(layer_to_print.tree_support_layer) })
+            if (layer != nullptr)
+                layers.emplace_back(layer);
+    AvoidCrossingPerimeters::LayerBoundariesPtrs out(layers.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()), [&layers, &out](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            out[i] = AvoidCrossingPerimeters::precompute_layer(*layers[i]);
+    });
+    return out;
+}
+
 // Process all layers of all objects (non-sequential mode) with a parallel pipeline:
 // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
 // and export G-code into file.
@@ -1815,22 +1877,37 @@ void GCode::process_layers(
 {
     // The pipeline is variable: The vase mode filter is optional.
     size_t layer_to_print_idx = 0;
-    const auto generator = tbb::make_filter<void, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &tool_ordering, &print_object_instances_ordering, &layers_to_print, &layer_to_print_idx](tbb::flow_control& fc) -> GCode::LayerResult {
+    const auto generator = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [&layers_to_print, &layer_to_print_idx](tbb::flow_control& fc) -> size_t {
             if (layer_to_print_idx == layers_to_print.size()) {
                 fc.stop();
-                return {};
-            } else {
-                const std::pair<coordf_t, std::vector<LayerToPrint>>& layer = layers_to_print[layer_to_print_idx++];
-                const LayerTools& layer_tools = tool_ordering.tools_for_layer(layer.first);
-                print.set_status(80, Slic3r::format(_(L("Generating G-code: layer %1%")), std::to_string(layer_to_print_idx)));
-                if (m_wipe_tower && layer_tools.has_wipe_tower)
-                    m_wipe_tower->next_layer();
-                //BBS
-                check_placeholder_parser_failed();
-                print.throw_if_canceled();
-                return this->process_layer(print, layer.second, layer_tools, &layer == &layers_to_print.back(), &print_object_instances_ordering, size_t(-1));
-            }
+                return 0;
+            } else
+                return layer_to_print_idx ++;
+        });
+    const bool reduce_crossing_wall = m_config.reduce_crossing_wall.value;
+    const auto precompute = tbb::make_filter<size_t, std::shared_ptr<LayerToProcess>>(slic3r_tbb_filtermode::parallel,
+        [&layers_to_print, reduce_crossing_wall](size_t idx) -> std::shared_ptr<LayerToProcess> {
+            const std::vector<LayerToPrint> &layers = layers_to_print[idx].second;
+            auto out = std::make_shared<LayerToProcess>();
+            out->idx = idx;
+            if (reduce_crossing_wall)
+                out->travel_boundaries = precompute_travel_boundaries(layers);
+            out->lower_layer_edge_grids = precompute_lower_layer_edge_grids(layers);
+            return out;
+        });
+    const auto process = tbb::make_filter<std::shared_ptr<LayerToProcess>, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &print, &tool_ordering, &print_object_instances_ordering, &layers_to_print](std::shared_ptr<LayerToProcess> in) -> GCode::LayerResult {
+            const std::pair<coordf_t, std::vector<LayerToPrint>>& layer = layers_to_print[in->idx];
+            const LayerTools& layer_tools = tool_ordering.tools_for_layer(layer.first);
+            print.set_status(80, Slic3r::format(_(L("Generating G-code: layer %1%")), std::to_string(in->idx + 1)));
+            if (m_wipe_tower && layer_tools.has_wipe_tower)
+                m_wipe_tower->next_layer();
+            //BBS
+            check_placeholder_parser_failed();
+            print.throw_if_canceled();
+            m_avoid_crossing_perimeters.set_precomputed_layers(std::move(in->travel_boundaries));
+            return this->process_layer(print, layer.second, layer_tools, &layer == &layers_to_print.back(), &print_object_instances_ordering, std::move(in->lower_layer_edge_grids), size_t(-1));
         });
     const auto spiral_mode = tbb::make_filter<GCode::LayerResult, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
         [&spiral_mode = *this->m_spiral_vase.get()](GCode::LayerResult in) -> GCode::LayerResult {
@@ -1847,9 +1924,11 @@ void GCode::process_layers(
 
     // The pipeline elements are joined using const references, thus no copying is performed.
     if (m_spiral_vase)
-        tbb::parallel_pipeline(12, generator & spiral_mode & cooling & output);
+        tbb::parallel_pipeline(12, generator & precompute & process & spiral_mode & cooling & output);
     else
-        tbb::parallel_pipeline(12, generator & cooling & output);
+        tbb::parallel_pipeline(12, generator & precompute & process & cooling & output);
+    // Release the travel boundaries of the last layer.
+    m_avoid_crossing_perimeters.set_precomputed_layers({});
 }
 
 // Process all layers of a single object instance (sequential mode) with a parallel pipeline:
@@ -1866,19 +1945,34 @@ void GCode::process_layers(
 {
     // The pipeline is variable: The vase mode filter is optional.
     size_t layer_to_print_idx = 0;
-    const auto generator = tbb::make_filter<void, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &tool_ordering, &layers_to_print, &layer_to_print_idx, single_object_idx, prime_extruder](tbb::flow_control& fc) -> GCode::LayerResult {
+    const auto generator = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [&layers_to_print, &layer_to_print_idx](tbb::flow_control& fc) -> size_t {
             if (layer_to_print_idx == layers_to_print.size()) {
                 fc.stop();
-                return {};
-            } else {
-                LayerToPrint &layer = layers_to_print[layer_to_print_idx ++];
-                print.set_status(80, Slic3r::format(_(L("Generating G-code: layer %1%")), std::to_string(layer_to_print_idx)));
-                //BBS
-                check_placeholder_parser_failed();
-                print.throw_if_canceled();
-                return this->process_layer(print, { std::move(layer) }, tool_ordering.tools_for_layer(layer.print_z()), &layer == &layers_to_print.back(), nullptr, single_object_idx, prime_extruder);
-            }
+                return 0;
+            } else
+                return layer_to_print_idx ++;
+        });
+    const bool reduce_crossing_wall = m_config.reduce_crossing_wall.value;
+    const auto precompute = tbb::make_filter<size_t, std::shared_ptr<LayerToProcess>>(slic3r_tbb_filtermode::parallel,
+        [&layers_to_print, reduce_crossing_wall](size_t idx) -> std::shared_ptr<LayerToProcess> {
+            const std::vector<LayerToPrint> layers { layers_to_print[idx] };
+            auto out = std::make_shared<LayerToProcess>();
+            out->idx = idx;
+            if (reduce_crossing_wall)
+                out->travel_boundaries = precompute_travel_boundaries(layers);
+            out->lower_layer_edge_grids = precompute_lower_layer_edge_grids(layers);
+            return out;
+        });
+    const auto process = tbb::make_filter<std::shared_ptr<LayerToProcess>, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &print, &tool_ordering, &layers_to_print, single_object_idx, prime_extruder](std::shared_ptr<LayerToProcess> in) -> GCode::LayerResult {
+            LayerToPrint &layer = layers_to_print[in->idx];
+            print.set_status(80, Slic3r::format(_(L("Generating G-code: layer %1%")), std::to_string(in->idx + 1)));
+            //BBS
+            check_placeholder_parser_failed();
+            print.throw_if_canceled();
+            m_avoid_crossing_perimeters.set_precomputed_layers(std::move(in->travel_boundaries));
+            return this->process_layer(print, { std::move(layer) }, tool_ordering.tools_for_layer(layer.print_z()), &layer == &layers_to_print.back(), nullptr, std::move(in->lower_layer_edge_grids), single_object_idx, prime_extruder);
         });
     const auto spiral_mode = tbb::make_filter<GCode::LayerResult, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
         [&spiral_mode = *this->m_spiral_vase.get()](GCode::LayerResult in)->GCode::LayerResult {
@@ -1895,9 +1989,11 @@ void GCode::process_layers(
 
     // The pipeline elements are joined using const references, thus no copying is performed.
     if (m_spiral_vase)
-        tbb::parallel_pipeline(12, generator & spiral_mode & cooling & output);
+        tbb::parallel_pipeline(12, generator & precompute & process & spiral_mode & cooling & output);
     else
-        tbb::parallel_pipeline(12, generator & cooling & output);
+        tbb::parallel_pipeline(12, generator & precompute & process & cooling & output);
+    // Release the travel boundaries of the last layer.
+    m_avoid_crossing_perimeters.set_precomputed_layers({});
 }
 
 std::string GCode::placeholder_parser_process(const std::string &name, const std::string &templ, unsigned int current_extruder_id, const DynamicConfig *config_override)
@@ -2346,6 +2442,8 @@ GCode::LayerResult GCode::process_layer(
     const bool                               last_layer,
     // Pairs of PrintObject index and its instance index.
     const std::vector<const PrintInstance*> *ordering,
+    // Distance fields over the lower layers of layers for seam placement, calculated on demand where missing.
+    std::vector<std::unique_ptr<EdgeGrid::Grid>> lower_layer_edge_grids,
     // If set to size_t(-1), then print all copies of all objects.
     // Otherwise print a single copy of a single object.
     const size_t                     		 single_object_instance_idx,
@@ -2753,7 +2851,7 @@ GCode::LayerResult GCode::process_layer(
     } // for objects
 
     // Extrude the skirt, brim, support, perimeters, infill ordered by the extruders.
-    std::vector<std::unique_ptr<EdgeGrid::Grid>> lower_layer_edge_grids(layers.size());
+    lower_layer_edge_grids.resize(layers.size());
     for (unsigned int extruder_id : layer_tools.extruders)
     {
         gcode += (layer_tools.has_wipe_tower && m_wipe_tower) ?
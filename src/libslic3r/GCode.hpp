@@ -83,7 +83,9 @@ public:
         m_tool_change_idx(0),
         m_plate_origin(plate_origin),
         m_single_extruder_multi_material(print_config.single_extruder_multi_material)
-    {}
+    {
+        this->init_tool_changes_gcode();
+    }
 
     std::string prime(GCode &gcodegen);
     void next_layer() { ++ m_layer_idx; m_tool_change_idx = 0; }
@@ -93,10 +95,13 @@ public:
 
 private:
     WipeTowerIntegration& operator=(const WipeTowerIntegration&);
-    std::string append_tcr(GCode &gcodegen, const WipeTower::ToolChangeResult &tcr, int new_extruder_id, double z = -1.) const;
+    // tcr_rotated_gcode is the G-code of tcr already postprocessed by post_process_wipe_tower_moves(), if available.
+    std::string append_tcr(GCode &gcodegen, const WipeTower::ToolChangeResult &tcr, int new_extruder_id, double z = -1., const std::string *tcr_rotated_gcode = nullptr) const;
 
     // Postprocesses gcode: rotates and moves G1 extrusions and returns result
     std::string post_process_wipe_tower_moves(const WipeTower::ToolChangeResult& tcr, const Vec2f& translation, float angle) const;
+    // Postprocess the G-code of all m_tool_changes in parallel, so that the layers are not waiting for it while exporting G-code.
+    void        init_tool_changes_gcode();
 
     // Left / right edges of the wipe tower, for the planning of wipe moves.
     const float                                                  m_left;
@@ -109,6 +114,8 @@ private:
     const std::vector<WipeTower::ToolChangeResult>              &m_priming;
     const std::vector<std::vector<WipeTower::ToolChangeResult>> &m_tool_changes;
     const WipeTower::ToolChangeResult                           &m_final_purge;
+    // G-code of m_tool_changes rotated and moved to the wipe tower position.
+    std::vector<std::vector<std::string>>                        m_tool_changes_gcode;
     // Current layer index.
     int                                                          m_layer_idx;
     int                                                          m_tool_change_idx;
@@ -281,6 +288,8 @@ private:
         const bool                       last_layer,
 		// Pairs of PrintObject index and its instance index.
 		const std::vector<const PrintInstance*> *ordering,
+        // Distance fields over the lower layers of layers for seam placement, calculated on demand where missing.
+        std::vector<std::unique_ptr<EdgeGrid::Grid>> lower_layer_edge_grids,
         // If set to size_t(-1), then print all copies of all objects.
         // Otherwise print a single copy of a single object.
         const size_t                     single_object_idx = size_t(-1),
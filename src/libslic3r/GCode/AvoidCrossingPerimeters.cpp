@@ -1039,9 +1039,8 @@ static ExPolygons get_boundary(const Layer &layer)
 }
 
 // called by AvoidCrossingPerimeters::travel_to()
-static Polygons get_boundary_external(const Layer &layer)
+static Polygons get_boundary_external(const Layer &layer, const float perimeter_spacing)
 {
-    const float perimeter_spacing = get_perimeter_spacing_external(layer);
     const float perimeter_offset  = perimeter_spacing / 2.f;
     auto const *support_layer     = dynamic_cast<const SupportLayer *>(&layer);
     Polygons    boundary;
@@ -1137,25 +1136,44 @@ Polyline AvoidCrossingPerimeters::travel_to(const GCode &gcodegen, const Point &
     const std::vector<BoundingBox> &lslices_bboxes   = gcodegen.layer()->lslices_bboxes;
     bool                            is_support_layer = (dynamic_cast<const SupportLayer *>(gcodegen.layer()) != nullptr) ||
                                                        (dynamic_cast<const TreeSupportLayer *>(gcodegen.layer()) != nullptr);
-    if (!use_external && (is_support_layer || (!lslices.empty() && !any_expolygon_contains(lslices, lslices_bboxes, m_grid_lslice, travel)))) {
+    if (!use_external && (is_support_layer || (!lslices.empty() && !any_expolygon_contains(lslices, lslices_bboxes, *m_grid_lslice, travel)))) {
         // Initialize m_internal only when it is necessary.
-        if (m_internal.boundaries.empty())
-            init_boundary(&m_internal, to_polygons(get_boundary(*gcodegen.layer())));
+        if (! m_internal) {
+            if (LayerBoundariesPtr precomputed = this->find_precomputed_layer(gcodegen.layer()); precomputed != nullptr)
+                m_internal = std::shared_ptr<const Boundary>(precomputed, &precomputed->internal);
+            else {
+                auto internal = std::make_shared<Boundary>();
+                init_boundary(internal.get(), to_polygons(get_boundary(*gcodegen.layer())));
+                m_internal = std::move(internal);
+            }
+        }
+        const Boundary &internal = *m_internal;
 
         // Trim the travel line by the bounding box.
-        if (!m_internal.boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, m_internal.bbox)) {
-            travel_intersection_count = avoid_perimeters(m_internal, startf.cast<coord_t>(), endf.cast<coord_t>(), *gcodegen.layer(), result_pl);
+        if (!internal.boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, internal.bbox)) {
+            travel_intersection_count = avoid_perimeters(internal, startf.cast<coord_t>(), endf.cast<coord_t>(), *gcodegen.layer(), result_pl);
             result_pl.points.front()  = start;
             result_pl.points.back()   = end;
         }
     } else if(use_external) {
         // Initialize m_external only when exist any external travel for the current layer.
-        if (m_external.boundaries.empty())
-            init_boundary(&m_external, get_boundary_external(*gcodegen.layer()));
+        // Reuse the boundary of another layer printed at the same print_z if possible.
+        if (! m_external) {
+            auto it = std::find_if(m_external_cache.begin(), m_external_cache.end(),
+                [this](const auto &cached) { return cached.first == m_external_key; });
+            if (it == m_external_cache.end()) {
+                auto external = std::make_shared<Boundary>();
+                init_boundary(external.get(), get_boundary_external(*gcodegen.layer(), m_external_key.perimeter_spacing));
+                m_external_cache.emplace_back(m_external_key, std::move(external));
+                it = std::prev(m_external_cache.end());
+            }
+            m_external = it->second;
+        }
+        const Boundary &external = *m_external;
 
         // Trim the travel line by the bounding box.
-        if (!m_external.boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, m_external.bbox)) {
-            travel_intersection_count = avoid_perimeters(m_external, startf.cast<coord_t>(), endf.cast<coord_t>(), *gcodegen.layer(), result_pl);
+        if (!external.boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, external.bbox)) {
+            travel_intersection_count = avoid_perimeters(external, startf.cast<coord_t>(), endf.cast<coord_t>(), *gcodegen.layer(), result_pl);
             result_pl.points.front()  = start;
             result_pl.points.back()   = end;
         }
@@ -1185,24 +1203,56 @@ Polyline AvoidCrossingPerimeters::travel_to(const GCode &gcodegen, const Point &
     } else if (max_detour_length_exceeded) {
         *could_be_wipe_disabled = false;
     } else
-        *could_be_wipe_disabled = !need_wipe(gcodegen, m_grid_lslice, travel, result_pl, travel_intersection_count);
+        *could_be_wipe_disabled = !need_wipe(gcodegen, *m_grid_lslice, travel, result_pl, travel_intersection_count);
 
     return result_pl;
 }
 
 // ************************************* AvoidCrossingPerimeters::init_layer() *****************************************
 
-void AvoidCrossingPerimeters::init_layer(const Layer &layer)
+static void init_grid_lslice(EdgeGrid::Grid &grid_lslice, const Layer &layer)
 {
-    m_internal.clear();
-    m_external.clear();
-
     BoundingBox bbox_slice(get_extents(layer.lslices));
     bbox_slice.offset(SCALED_EPSILON);
 
-    m_grid_lslice.set_bbox(bbox_slice);
+    grid_lslice.set_bbox(bbox_slice);
     //FIXME 1mm grid?
-    m_grid_lslice.create(layer.lslices, coord_t(scale_(1.)));
+    grid_lslice.create(layer.lslices, coord_t(scale_(1.)));
+}
+
+void AvoidCrossingPerimeters::init_layer(const Layer &layer)
+{
+    // Internal and external boundaries are initialized on demand by travel_to() from the layer active at that time.
+    m_internal.reset();
+    m_external.reset();
+
+    ExternalBoundaryKey external_key { layer.print_z, dynamic_cast<const SupportLayer*>(&layer) != nullptr, get_perimeter_spacing_external(layer) };
+    if (external_key.print_z != m_external_key.print_z)
+        m_external_cache.clear();
+    m_external_key = external_key;
+
+    if (LayerBoundariesPtr precomputed = this->find_precomputed_layer(&layer); precomputed != nullptr)
+        m_grid_lslice = std::shared_ptr<const EdgeGrid::Grid>(precomputed, &precomputed->grid_lslice);
+    else {
+        auto grid_lslice = std::make_shared<EdgeGrid::Grid>();
+        init_grid_lslice(*grid_lslice, layer);
+        m_grid_lslice = std::move(grid_lslice);
+    }
+}
+
+AvoidCrossingPerimeters::LayerBoundariesPtr AvoidCrossingPerimeters::precompute_layer(const Layer &layer)
+{
+    auto out = std::make_shared<LayerBoundaries>();
+    out->layer = &layer;
+    init_grid_lslice(out->grid_lslice, layer);
+    init_boundary(&out->internal, to_polygons(get_boundary(layer)));
+    return out;
+}
+
+AvoidCrossingPerimeters::LayerBoundariesPtr AvoidCrossingPerimeters::find_precomputed_layer(const Layer *layer) const
+{
+    auto it = std::find_if(m_precomputed_layers.begin(), m_precomputed_layers.end(), [layer](const LayerBoundariesPtr &l) { return l->layer == layer; });
+    return it == m_precomputed_layers.end() ? LayerBoundariesPtr() : *it;
 }
 
 #if 0
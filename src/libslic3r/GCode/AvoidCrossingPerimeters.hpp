@@ -5,6 +5,9 @@
 #include "../ExPolygon.hpp"
 #include "../EdgeGrid.hpp"
 
+#include <memory>
+#include <vector>
+
 namespace Slic3r {
 
 // Forward declarations.
@@ -23,6 +26,7 @@ public:
     bool        disabled_once() const   { return m_disabled_once; }
     void        reset_once_modifiers()  { m_use_external_mp_once = false; m_disabled_once = false; }
 
+    // Boundaries of the layer are taken from the precomputed ones if available, otherwise they are calculated on demand.
     void        init_layer(const Layer &layer);
 
     Polyline    travel_to(const GCode& gcodegen, const Point& point)
@@ -50,7 +54,28 @@ public:
         }
     };
 
+    // Travel boundaries of a single layer, calculated ahead of the G-code generation.
+    // The external boundary is shared by all layers of a print_z, thus it is calculated on demand once per print_z.
+    struct LayerBoundaries {
+        // Layer the boundaries were calculated for.
+        const Layer    *layer { nullptr };
+        // Used for detection of line or polyline is inside of any polygon.
+        EdgeGrid::Grid  grid_lslice;
+        // Travels inside object
+        Boundary        internal;
+    };
+    using LayerBoundariesPtr  = std::shared_ptr<const LayerBoundaries>;
+    using LayerBoundariesPtrs = std::vector<LayerBoundariesPtr>;
+
+    // Calculate the lslice grid and the internal travel boundary of a single layer. Thread safe, the G-code generator calls it
+    // from a parallel stage of its pipeline for the layers to be printed next.
+    static LayerBoundariesPtr precompute_layer(const Layer &layer);
+    // Boundaries precomputed for the layers printed next, replacing the previously set ones.
+    void        set_precomputed_layers(LayerBoundariesPtrs &&layers) { m_precomputed_layers = std::move(layers); }
+
 private:
+    LayerBoundariesPtr find_precomputed_layer(const Layer *layer) const;
+
     bool           m_use_external_mp { false };
     // just for the next travel move
     bool           m_use_external_mp_once { false };
@@ -58,12 +83,28 @@ private:
     // we enable it by default for the first travel move in print
     bool           m_disabled_once { true };
 
+    // Boundaries of the active layer are either owned by a precomputed LayerBoundaries (aliasing shared_ptr),
+    // or calculated on demand. Null if not initialized yet for the active layer.
     // Used for detection of line or polyline is inside of any polygon.
-    EdgeGrid::Grid m_grid_lslice;
+    std::shared_ptr<const EdgeGrid::Grid> m_grid_lslice { std::make_shared<EdgeGrid::Grid>() };
     // Store all needed data for travels inside object
-    Boundary m_internal;
+    std::shared_ptr<const Boundary>       m_internal;
     // Store all needed data for travels outside object
-    Boundary m_external;
+    std::shared_ptr<const Boundary>       m_external;
+    // The external boundary only depends on print_z, on whether the layer is a support layer and on the perimeter spacing.
+    struct ExternalBoundaryKey {
+        double  print_z { -1. };
+        bool    support { false };
+        float   perimeter_spacing { 0.f };
+        bool operator==(const ExternalBoundaryKey &rhs) const
+            { return print_z == rhs.print_z && support == rhs.support && perimeter_spacing == rhs.perimeter_spacing; }
+    };
+    // Key of the external boundary of the active layer.
+    ExternalBoundaryKey                   m_external_key;
+    // External boundaries calculated for the active print_z, shared by the layers of all objects printed at that print_z.
+    std::vector<std::pair<ExternalBoundaryKey, std::shared_ptr<const Boundary>>> m_external_cache;
+    // Boundaries precomputed for the layers printed next.
+    LayerBoundariesPtrs                   m_precomputed_layers;
 };
 
 } // namespace Slic3r
@@ -8,6 +8,8 @@
 #include "libslic3r/SVG.hpp"
 #include "libslic3r/Layer.hpp"
 
+#include <tbb/parallel_for.h>
+
 namespace Slic3r {
 
 // This penalty is added to all points inside custom blockers (subtracted from pts inside enforcers).
@@ -198,96 +200,101 @@ void SeamPlacer::init(const Print& print)
     const std::vector<double>& nozzle_dmrs = print.config().nozzle_diameter.values;
     float max_nozzle_dmr = *std::max_element(nozzle_dmrs.begin(), nozzle_dmrs.end());
 
+    // Remember the PrintObjects and initialize a store of enforcers and blockers for each of them.
+    m_po_list.assign(print.objects().begin(), print.objects().end());
+    m_enforcers.assign(m_po_list.size(), {});
+    m_blockers.assign(m_po_list.size(), {});
+
+    // The enforcers and blockers of the PrintObjects are projected and indexed independently of each other.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_po_list.size()), [this, max_nozzle_dmr](const tbb::blocked_range<size_t> &range) {
+        std::vector<ExPolygons> temp_enf;
+        std::vector<ExPolygons> temp_blk;
+        std::vector<Polygons>   temp_polygons;
+
+        for (size_t po_idx = range.begin(); po_idx < range.end(); ++ po_idx) {
+            const PrintObject *po = m_po_list[po_idx];
+
+            auto merge_and_offset = [po, &temp_polygons, max_nozzle_dmr](EnforcerBlockerType type, std::vector<ExPolygons>& out) {
+                // Offset the triangles out slightly.
+                auto offset_out = [](Polygon& input, float offset) -> ExPolygons {
+                    ClipperLib::Paths out(1);
+                    std::vector<float>  deltas(input.points.size(), offset);
+                    input.make_counter_clockwise();
+                    out.front() = mittered_offset_path_scaled(input.points, deltas, 3.);
+                    return ClipperPaths_to_Slic3rExPolygons(out, true); // perform union
+                };
+
+
+                temp_polygons.clear();
+                po->project_and_append_custom_facets(true, type, temp_polygons);
+                out.clear();
+                out.reserve(temp_polygons.size());
+                float offset = scale_(max_nozzle_dmr + po->config().elefant_foot_compensation);
+                for (Polygons &src : temp_polygons) {
+                    out.emplace_back(ExPolygons());
+                    for (Polygon& plg : src) {
+                        ExPolygons offset_explg = offset_out(plg, offset);
+                        if (! offset_explg.empty())
+                            out.back().emplace_back(std::move(offset_explg.front()));
+                    }
 
-    std::vector<ExPolygons> temp_enf;
-    std::vector<ExPolygons> temp_blk;
-    std::vector<Polygons>   temp_polygons;
-
-    for (const PrintObject* po : print.objects()) {
-
-        auto merge_and_offset = [po, &temp_polygons, max_nozzle_dmr](EnforcerBlockerType type, std::vector<ExPolygons>& out) {
-            // Offset the triangles out slightly.
-            auto offset_out = [](Polygon& input, float offset) -> ExPolygons {
-                ClipperLib::Paths out(1);
-                std::vector<float>  deltas(input.points.size(), offset);
-                input.make_counter_clockwise();
-                out.front() = mittered_offset_path_scaled(input.points, deltas, 3.);
-                return ClipperPaths_to_Slic3rExPolygons(out, true); // perform union
-            };
-
-
-            temp_polygons.clear();
-            po->project_and_append_custom_facets(true, type, temp_polygons);
-            out.clear();
-            out.reserve(temp_polygons.size());
-            float offset = scale_(max_nozzle_dmr + po->config().elefant_foot_compensation);
-            for (Polygons &src : temp_polygons) {
-                out.emplace_back(ExPolygons());
-                for (Polygon& plg : src) {
-                    ExPolygons offset_explg = offset_out(plg, offset);
-                    if (! offset_explg.empty())
-                        out.back().emplace_back(std::move(offset_explg.front()));
+                    offset = scale_(max_nozzle_dmr);
                 }
+            };
+            merge_and_offset(EnforcerBlockerType::BLOCKER, temp_blk);
+            merge_and_offset(EnforcerBlockerType::ENFORCER, temp_enf);
+
+            m_enforcers[po_idx].assign(temp_enf.size(), CustomTrianglesPerLayer());
+            m_blockers[po_idx].assign(temp_blk.size(), CustomTrianglesPerLayer());
+
+            // A helper class to store data to build the AABB tree from.
+            class CustomTriangleRef {
+            public:
+                CustomTriangleRef(size_t idx,
+                                  Point&& centroid,
+                                  BoundingBox&& bb)
+                    : m_idx{idx}, m_centroid{centroid},
+                      m_bbox{AlignedBoxType(bb.min, bb.max)}
+                {}
+                size_t idx() const              { return m_idx;      }
+                const Point& centroid() const   { return m_centroid; }
+                const TreeType::BoundingBox& bbox() const { return m_bbox; }
+
+            private:
+                size_t m_idx;
+                Point m_centroid;
+                AlignedBoxType m_bbox;
+            };
 
-                offset = scale_(max_nozzle_dmr);
-            }
-        };
-        merge_and_offset(EnforcerBlockerType::BLOCKER, temp_blk);
-        merge_and_offset(EnforcerBlockerType::ENFORCER, temp_enf);
-
-        // Remember this PrintObject and initialize a store of enforcers and blockers for it.
-        m_po_list.push_back(po);
-        size_t po_idx = m_po_list.size() - 1;
-        m_enforcers.emplace_back(std::vector<CustomTrianglesPerLayer>(temp_enf.size()));
-        m_blockers.emplace_back(std::vector<CustomTrianglesPerLayer>(temp_blk.size()));
-
-        // A helper class to store data to build the AABB tree from.
-        class CustomTriangleRef {
-        public:
-            CustomTriangleRef(size_t idx,
-                              Point&& centroid,
-                              BoundingBox&& bb)
-                : m_idx{idx}, m_centroid{centroid},
-                  m_bbox{AlignedBoxType(bb.min, bb.max)}
-            {}
-            size_t idx() const              { return m_idx;      }
-            const Point& centroid() const   { return m_centroid; }
-            const TreeType::BoundingBox& bbox() const { return m_bbox; }
-
-        private:
-            size_t m_idx;
-            Point m_centroid;
-            AlignedBoxType m_bbox;
-        };
-
-        // A lambda to extract the ExPolygons and save them into the member AABB tree.
-        // Will be called for enforcers and blockers separately.
-        auto add_custom = [](std::vector<ExPolygons>& src, std::vector<CustomTrianglesPerLayer>& dest) {
-            // Go layer by layer, and append all the ExPolygons into the AABB tree.
-            size_t layer_idx = 0;
-            for (ExPolygons& expolys_on_layer : src) {
-                CustomTrianglesPerLayer& layer_data = dest[layer_idx];
-                std::vector<CustomTriangleRef> triangles_data;
-                layer_data.polys.reserve(expolys_on_layer.size());
-                triangles_data.reserve(expolys_on_layer.size());
-
-                for (ExPolygon& expoly : expolys_on_layer) {
-                    if (expoly.empty())
-                        continue;
-                    layer_data.polys.emplace_back(std::move(expoly));
-                    triangles_data.emplace_back(layer_data.polys.size() - 1,
-                                                layer_data.polys.back().centroid(),
-                                                layer_data.polys.back().bounding_box());
+            // A lambda to extract the ExPolygons and save them into the member AABB tree.
+            // Will be called for enforcers and blockers separately.
+            auto add_custom = [](std::vector<ExPolygons>& src, std::vector<CustomTrianglesPerLayer>& dest) {
+                // Go layer by layer, and append all the ExPolygons into the AABB tree.
+                size_t layer_idx = 0;
+                for (ExPolygons& expolys_on_layer : src) {
+                    CustomTrianglesPerLayer& layer_data = dest[layer_idx];
+                    std::vector<CustomTriangleRef> triangles_data;
+                    layer_data.polys.reserve(expolys_on_layer.size());
+                    triangles_data.reserve(expolys_on_layer.size());
+
+                    for (ExPolygon& expoly : expolys_on_layer) {
+                        if (expoly.empty())
+                            continue;
+                        layer_data.polys.emplace_back(std::move(expoly));
+                        triangles_data.emplace_back(layer_data.polys.size() - 1,
+                                                    layer_data.polys.back().centroid(),
+                                                    layer_data.polys.back().bounding_box());
+                    }
+                    // All polygons are saved, build the AABB tree for them.
+                    layer_data.tree.build(std::move(triangles_data));
+                    ++layer_idx;
                 }
-                // All polygons are saved, build the AABB tree for them.
-                layer_data.tree.build(std::move(triangles_data));
-                ++layer_idx;
-            }
-        };
+            };
 
-        add_custom(temp_enf, m_enforcers.at(po_idx));
-        add_custom(temp_blk, m_blockers.at(po_idx));
-    }
+            add_custom(temp_enf, m_enforcers[po_idx]);
+            add_custom(temp_blk, m_blockers[po_idx]);
+        }
+    });
 }
 
 
@@ -0,0 +1,254 @@
+#include "ThumbnailRenderer.hpp"
+
+#include "libslic3r/BuildVolume.hpp"
+#include "libslic3r/Model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <boost/format.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <tbb/parallel_for.h>
+
+namespace Slic3r {
+
+namespace {
+
+// Lighting of the gouraud_light shader, directions in camera space.
+static const Vec3f LIGHT_TOP_DIR(-0.4574957f, 0.4574957f, 0.7624929f);
+static constexpr float INTENSITY_CORRECTION = 0.6f;
+static constexpr float LIGHT_TOP_DIFFUSE    = 0.8f * INTENSITY_CORRECTION;
+static constexpr float LIGHT_TOP_SPECULAR   = 0.125f * INTENSITY_CORRECTION;
+static constexpr float LIGHT_TOP_SHININESS  = 20.f;
+static const Vec3f LIGHT_FRONT_DIR(0.6985074f, 0.1397015f, 0.6985074f);
+static constexpr float LIGHT_FRONT_DIFFUSE  = 0.3f * INTENSITY_CORRECTION;
+static constexpr float INTENSITY_AMBIENT    = 0.3f;
+
+// Background of the thumbnails rendered by GLCanvas3D.
+static constexpr float BACKGROUND_COLOR     = 0.906f;
+
+// Each pixel of the thumbnail is averaged from SUPERSAMPLING x SUPERSAMPLING samples.
+static constexpr int SUPERSAMPLING          = 2;
+// Size of the square tiles of samples rasterized in parallel.
+static constexpr int TILE_SIZE              = 32;
+
+// Triangle projected to the sample raster, flat shaded.
+struct RasterTriangle
+{
+    Vec2f                         pts[3];
+    float                         depth[3];
+    float                         inv_area;
+    std::array<float, 4>          color;
+};
+
+// Orthographic camera looking at the target from the front top, see GLCanvas3D::render_thumbnail_internal().
+struct ThumbnailCamera
+{
+    Vec3d right;
+    Vec3d up;
+    Vec3d forward;
+
+    ThumbnailCamera() {
+        forward = Vec3d(0., 0.707, -0.3).normalized();
+        right   = forward.cross(Vec3d::UnitY() + Vec3d::UnitZ()).normalized();
+        up      = right.cross(forward);
+    }
+
+    // x, y in the image plane, z as distance from the eye.
+    Vec3d project(const Vec3d &pt) const { return { right.dot(pt), up.dot(pt), forward.dot(pt) }; }
+    // Direction in the OpenGL camera space, looking along -z.
+    Vec3f to_eye(const Vec3d &dir) const { return Vec3f(float(right.dot(dir)), float(up.dot(dir)), float(- forward.dot(dir))); }
+};
+
+struct VisibleVolume
+{
+    const indexed_triangle_set *its;
+    Transform3d                 trafo;
+    std::array<float, 4>        color;
+};
+
+static std::array<float, 4> shade(const Vec3f &normal, const std::array<float, 4> &color)
+{
+    float n_dot_l   = std::max(normal.dot(LIGHT_TOP_DIR), 0.f);
+    float intensity = INTENSITY_AMBIENT + n_dot_l * LIGHT_TOP_DIFFUSE;
+    // Orthographic camera, the direction to the eye is constant.
+    Vec3f reflected = 2.f * normal.dot(LIGHT_TOP_DIR) * normal - LIGHT_TOP_DIR;
+    float specular  = LIGHT_TOP_SPECULAR * std::pow(std::max(reflected.z(), 0.f), LIGHT_TOP_SHININESS);
+    intensity += std::max(normal.dot(LIGHT_FRONT_DIR), 0.f) * LIGHT_FRONT_DIFFUSE;
+    return { std::min(specular + color[0] * intensity, 1.f), std::min(specular + color[1] * intensity, 1.f), std::min(specular + color[2] * intensity, 1.f), color[3] };
+}
+
+} // namespace
+
+void render_thumbnail_software(ThumbnailData &thumbnail_data, unsigned int w, unsigned int h, const ThumbnailsParams &thumbnail_params,
+                               const ModelObjectPtrs &model_objects, const BoundingBoxf3 &plate_volume,
+                               const std::vector<std::array<float, 4>> &extruder_colors)
+{
+    thumbnail_data.set(w, h);
+    if (! thumbnail_data.is_valid())
+        return;
+
+    BoundingBoxf3 plate_build_volume = plate_volume;
+    plate_build_volume.min -= BuildVolume::SceneEpsilon * Vec3d::Ones();
+    plate_build_volume.max += BuildVolume::SceneEpsilon * Vec3d::Ones();
+
+    // Collect the model parts of the printable instances placed on the plate.
+    std::vector<VisibleVolume> visible_volumes;
+    BoundingBoxf3              volumes_box;
+    for (const ModelObject *model_object : model_objects) {
+        if (! model_object->printable)
+            continue;
+        for (const ModelInstance *model_instance : model_object->instances) {
+            if (! model_instance->printable)
+                continue;
+            for (const ModelVolume *model_volume : model_object->volumes) {
+                if (! model_volume->is_model_part())
+                    continue;
+                Transform3d   trafo = model_instance->get_matrix() * model_volume->get_matrix();
+                BoundingBoxf3 bbox  = model_volume->mesh().transformed_bounding_box(trafo);
+                if (thumbnail_params.plate_id >= 0 && ! plate_build_volume.contains(bbox))
+                    continue;
+                int                  extruder_id = std::max(model_volume->extruder_id(), 1);
+                std::array<float, 4> color       = extruder_colors.empty() ? std::array<float, 4>{ 1.f, 1.f, 1.f, 1.f } :
+                    extruder_colors[std::min<size_t>(extruder_id - 1, extruder_colors.size() - 1)];
+                visible_volumes.push_back({ &model_volume->mesh().its, trafo, color });
+                volumes_box.merge(bbox);
+            }
+        }
+    }
+    BOOST_LOG_TRIVIAL(info) << boost::format("render_thumbnail_software: plate_idx %1% volumes size %2%") % thumbnail_params.plate_id % visible_volumes.size();
+
+    const int   width      = int(w) * SUPERSAMPLING;
+    const int   height     = int(h) * SUPERSAMPLING;
+    const float background = BACKGROUND_COLOR;
+    std::vector<std::array<float, 4>> samples(size_t(width) * size_t(height), { background, background, background, 1.f });
+
+    if (! visible_volumes.empty()) {
+        // Leave a margin of a quarter of the volumes size around them, fit the projection of the box into the image.
+        Vec3d size = volumes_box.size();
+        volumes_box.min -= 0.25 * size;
+        volumes_box.max += 0.25 * size;
+        ThumbnailCamera camera;
+        Vec3d           center = volumes_box.center();
+        BoundingBoxf    image_box;
+        for (int i = 0; i < 8; ++ i) {
+            Vec3d corner((i & 1) ? volumes_box.max.x() : volumes_box.min.x(), (i & 2) ? volumes_box.max.y() : volumes_box.min.y(), (i & 4) ? volumes_box.max.z() : volumes_box.min.z());
+            image_box.merge(Vec2d(camera.project(corner - center).head<2>()));
+        }
+        Vec2d  image_size = image_box.size();
+        double scale      = std::min(double(width) / std::max(image_size.x(), EPSILON), double(height) / std::max(image_size.y(), EPSILON));
+        Vec2d  offset     = 0.5 * Vec2d(width, height) - scale * image_box.center();
+
+        // Project and shade the triangles.
+        std::vector<std::vector<RasterTriangle>> volume_triangles(visible_volumes.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, visible_volumes.size()), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t volume_idx = range.begin(); volume_idx < range.end(); ++ volume_idx) {
+                const VisibleVolume         &volume = visible_volumes[volume_idx];
+                std::vector<RasterTriangle> &out    = volume_triangles[volume_idx];
+                std::vector<Vec3f>           projected;
+                projected.reserve(volume.its->vertices.size());
+                for (const stl_vertex &v : volume.its->vertices) {
+                    Vec3d pt = camera.project(volume.trafo * v.cast<double>() - center);
+                    projected.emplace_back(Vec3f(float(scale * pt.x() + offset.x()), float(scale * pt.y() + offset.y()), float(pt.z())));
+                }
+                out.reserve(volume.its->indices.size());
+                for (const stl_triangle_vertex_indices &face : volume.its->indices) {
+                    RasterTriangle tri;
+                    for (int i = 0; i < 3; ++ i) {
+                        tri.pts[i]   = projected[face(i)].head<2>();
+                        tri.depth[i] = projected[face(i)].z();
+                    }
+                    float area = cross2(Vec2f(tri.pts[1] - tri.pts[0]), Vec2f(tri.pts[2] - tri.pts[0]));
+                    if (std::abs(area) < 1e-6f)
+                        continue;
+                    if (area < 0.f) {
+                        std::swap(tri.pts[1], tri.pts[2]);
+                        std::swap(tri.depth[1], tri.depth[2]);
+                        area = - area;
+                    }
+                    tri.inv_area = 1.f / area;
+                    Vec3d normal = (volume.trafo * volume.its->vertices[face(1)].cast<double>() - volume.trafo * volume.its->vertices[face(0)].cast<double>()).cross(
+                                    volume.trafo * volume.its->vertices[face(2)].cast<double>() - volume.trafo * volume.its->vertices[face(0)].cast<double>());
+                    tri.color    = shade(camera.to_eye(normal.normalized()), volume.color);
+                    out.emplace_back(tri);
+                }
+            }
+        });
+
+        // Bin the triangles into the tiles they overlap.
+        const int tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+        const int tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+        std::vector<std::vector<const RasterTriangle*>> tiles(size_t(tiles_x) * size_t(tiles_y));
+        for (const std::vector<RasterTriangle> &triangles : volume_triangles)
+            for (const RasterTriangle &tri : triangles) {
+                float min_x = std::min({ tri.pts[0].x(), tri.pts[1].x(), tri.pts[2].x() });
+                float max_x = std::max({ tri.pts[0].x(), tri.pts[1].x(), tri.pts[2].x() });
+                float min_y = std::min({ tri.pts[0].y(), tri.pts[1].y(), tri.pts[2].y() });
+                float max_y = std::max({ tri.pts[0].y(), tri.pts[1].y(), tri.pts[2].y() });
+                int   tx0   = std::clamp(int(std::floor(min_x)) / TILE_SIZE, 0, tiles_x - 1);
+                int   tx1   = std::clamp(int(std::floor(max_x)) / TILE_SIZE, 0, tiles_x - 1);
+                int   ty0   = std::clamp(int(std::floor(min_y)) / TILE_SIZE, 0, tiles_y - 1);
+                int   ty1   = std::clamp(int(std::floor(max_y)) / TILE_SIZE, 0, tiles_y - 1);
+                for (int ty = ty0; ty <= ty1; ++ ty)
+                    for (int tx = tx0; tx <= tx1; ++ tx)
+                        tiles[size_t(ty) * tiles_x + tx].emplace_back(&tri);
+            }
+
+        // Rasterize the tiles in parallel, each with its own depth buffer.
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, tiles.size()), [&](const tbb::blocked_range<size_t> &range) {
+            std::vector<float> depth_buffer(TILE_SIZE * TILE_SIZE);
+            for (size_t tile_idx = range.begin(); tile_idx < range.end(); ++ tile_idx) {
+                const int x0 = int(tile_idx % tiles_x) * TILE_SIZE;
+                const int y0 = int(tile_idx / tiles_x) * TILE_SIZE;
+                const int x1 = std::min(x0 + TILE_SIZE, width);
+                const int y1 = std::min(y0 + TILE_SIZE, height);
+                std::fill(depth_buffer.begin(), depth_buffer.end(), std::numeric_limits<float>::max());
+                for (const RasterTriangle *tri : tiles[tile_idx]) {
+                    const Vec2f *p = tri->pts;
+                    int min_x = std::max(x0, int(std::floor(std::min({ p[0].x(), p[1].x(), p[2].x() }))));
+                    int max_x = std::min(x1 - 1, int(std::ceil(std::max({ p[0].x(), p[1].x(), p[2].x() }))));
+                    int min_y = std::max(y0, int(std::floor(std::min({ p[0].y(), p[1].y(), p[2].y() }))));
+                    int max_y = std::min(y1 - 1, int(std::ceil(std::max({ p[0].y(), p[1].y(), p[2].y() }))));
+                    for (int y = min_y; y <= max_y; ++ y)
+                        for (int x = min_x; x <= max_x; ++ x) {
+                            // Barycentric coordinates of the sample at the pixel center.
+                            Vec2f s(float(x) + 0.5f, float(y) + 0.5f);
+                            float w0 = cross2(Vec2f(p[2] - p[1]), Vec2f(s - p[1]));
+                            float w1 = cross2(Vec2f(p[0] - p[2]), Vec2f(s - p[2]));
+                            float w2 = cross2(Vec2f(p[1] - p[0]), Vec2f(s - p[0]));
+                            if (w0 < 0.f || w1 < 0.f || w2 < 0.f)
+                                continue;
+                            float  depth = (w0 * tri->depth[0] + w1 * tri->depth[1] + w2 * tri->depth[2]) * tri->inv_area;
+                            float &z     = depth_buffer[(y - y0) * TILE_SIZE + x - x0];
+                            if (depth < z) {
+                                z = depth;
+                                samples[size_t(y) * width + x] = tri->color;
+                            }
+                        }
+                }
+            }
+        });
+    }
+
+    // Average the samples into the thumbnail pixels.
+    const float inv_samples = 1.f / float(SUPERSAMPLING * SUPERSAMPLING);
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, h), [&](const tbb::blocked_range<unsigned int> &range) {
+        for (unsigned int row = range.begin(); row < range.end(); ++ row)
+            for (unsigned int col = 0; col < w; ++ col) {
+                std::array<float, 4> sum { 0.f, 0.f, 0.f, 0.f };
+                for (int sy = 0; sy < SUPERSAMPLING; ++ sy)
+                    for (int sx = 0; sx < SUPERSAMPLING; ++ sx) {
+                        const std::array<float, 4> &sample = samples[size_t(row * SUPERSAMPLING + sy) * width + col * SUPERSAMPLING + sx];
+                        for (size_t i = 0; i < 4; ++ i)
+                            sum[i] += sample[i];
+                    }
+                unsigned char *pixel = thumbnail_data.pixels.data() + 4 * (size_t(row) * w + col);
+                for (size_t i = 0; i < 4; ++ i)
+                    pixel[i] = (unsigned char)std::lround(255.f * std::clamp(sum[i] * inv_samples, 0.f, 1.f));
+            }
+    });
+}
+
+} // namespace Slic3r
@@ -0,0 +1,26 @@
+#ifndef slic3r_ThumbnailRenderer_hpp_
+#define slic3r_ThumbnailRenderer_hpp_
+
+#include <array>
+#include <vector>
+
+#include "libslic3r/BoundingBox.hpp"
+#include "ThumbnailData.hpp"
+
+namespace Slic3r {
+
+class ModelObject;
+using ModelObjectPtrs = std::vector<ModelObject*>;
+
+// Renders the thumbnail of a plate on the CPU, without an OpenGL context, so that it may be called
+// from a background thread or from the command line slicer running on a machine without a display.
+// The model parts of the printable instances inside plate_volume are rendered with the camera and the lighting
+// of GLCanvas3D::render_thumbnail_internal(), colored by the extruder colors (RGBA in <0, 1>).
+// The pixels are stored bottom row first, as read by glReadPixels().
+void render_thumbnail_software(ThumbnailData &thumbnail_data, unsigned int w, unsigned int h, const ThumbnailsParams &thumbnail_params,
+                               const ModelObjectPtrs &model_objects, const BoundingBoxf3 &plate_volume,
+                               const std::vector<std::array<float, 4>> &extruder_colors);
+
+} // namespace Slic3r
+
+#endif // slic3r_ThumbnailRenderer_hpp_
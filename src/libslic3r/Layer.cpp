@@ -50,6 +50,7 @@ void Layer::make_slices()
     
     this->lslices.clear();
     this->lslices.reserve(slices.size());
+    this->clear_support_map();
     
     // prepare ordering points
     Points ordering_points;
@@ -114,6 +115,15 @@ void Layer::restore_untyped_slices_no_extra_perimeters()
     }
 }
 
+// Revert the fill surfaces classified and split by PrintObject::prepare_infill() to the stInternal fill surfaces
+// generated by Layer::make_perimeters(), which are kept as fill_expolygons.
+// Used for the layers, whose perimeters are not regenerated, before re-running prepare_infill().
+void Layer::restore_untyped_fill_surfaces()
+{
+    for (LayerRegion *layerm : m_regions)
+        layerm->fill_surfaces.set(layerm->fill_expolygons, stInternal);
+}
+
 ExPolygons Layer::merged(float offset_scaled) const
 {
 	assert(offset_scaled >= 0.f);
@@ -222,6 +232,12 @@ void Layer::make_perimeters()
 	                    (*l)->fill_expolygons = expp;
 	                    (*l)->fill_surfaces.set(std::move(expp), fill_surfaces.surfaces.front());
 	                }
+	            } else {
+	                // No infill left, drop the fill surfaces of a previous run, so that they are not restored.
+	                for (LayerRegion *l : layerms) {
+	                    l->fill_expolygons.clear();
+	                    l->fill_surfaces.clear();
+	                }
 	            }
 	        }
 	    }
@@ -292,7 +308,7 @@ void Layer::simplify_support_entity_collection(ExtrusionEntityCollection* entity
 //BBS: method to simplify support path
 void Layer::simplify_support_path(ExtrusionPath * path)
 {
-    const auto print_config = this->object()->print()->config();
+    const auto &print_config = this->object()->print()->config();
     const bool spiral_mode = print_config.spiral_mode;
     const bool enable_arc_fitting = print_config.enable_arc_fitting;
     const auto scaled_resolution = scaled<double>(print_config.resolution.value);
@@ -307,7 +323,7 @@ void Layer::simplify_support_path(ExtrusionPath * path)
 //BBS: method to simplify support path
 void Layer::simplify_support_multi_path(ExtrusionMultiPath* multipath)
 {
-    const auto print_config = this->object()->print()->config();
+    const auto &print_config = this->object()->print()->config();
     const bool spiral_mode = print_config.spiral_mode;
     const bool enable_arc_fitting = print_config.enable_arc_fitting;
     const auto scaled_resolution = scaled<double>(print_config.resolution.value);
@@ -324,7 +340,7 @@ void Layer::simplify_support_multi_path(ExtrusionMultiPath* multipath)
 //BBS: method to simplify support path
 void Layer::simplify_support_loop(ExtrusionLoop* loop)
 {
-    const auto print_config = this->object()->print()->config();
+    const auto &print_config = this->object()->print()->config();
     const bool spiral_mode = print_config.spiral_mode;
     const bool enable_arc_fitting = print_config.enable_arc_fitting;
     const auto scaled_resolution = scaled<double>(print_config.resolution.value);
@@ -6,6 +6,7 @@
 #include "SurfaceCollection.hpp"
 #include "ExtrusionEntityCollection.hpp"
 #include "ExPolygonCollection.hpp"
+#include "LayerSupportMap.hpp"
 
 namespace Slic3r {
 class Layer;
@@ -19,6 +20,8 @@ namespace FillAdaptive {
     struct Octree;
 };
 
+class FillPatternCache;
+
 class LayerRegion
 {
 public:
@@ -103,6 +106,10 @@ protected:
 private:
     Layer             *m_layer;
     const PrintRegion *m_region;
+    // Were the perimeters / fills simplified since they were generated? The extrusions of a layer,
+    // which are reused by PrintObject::make_perimeters() or PrintObject::infill(), are not simplified again.
+    bool               m_perimeters_simplified { false };
+    bool               m_fills_simplified { false };
 };
 
 class Layer 
@@ -136,6 +143,10 @@ public:
     // that the 1st lslice is not compensated by the Elephant foot compensation algorithm.
     ExPolygons 				 lslices;
     std::vector<BoundingBox> lslices_bboxes;
+    // Lazily calculated offsets and contours of lslices, queried by the layer above.
+    const LayerSupportMap&   support_map() const { return m_support_map; }
+    // To be called whenever lslices change.
+    void                     clear_support_map() { m_support_map.clear(); }
 
     size_t                  region_count() const { return m_regions.size(); }
     const LayerRegion*      get_region(int idx) const { return m_regions[idx]; }
@@ -151,6 +162,8 @@ public:
     void                    restore_untyped_slices();
     // To improve robustness of detect_surfaces_type() when reslicing (working with typed slices), see GH issue #7442.
     void                    restore_untyped_slices_no_extra_perimeters();
+    // Restore the untyped fill surfaces generated by the perimeter generator from fill_expolygons.
+    void                    restore_untyped_fill_surfaces();
     // Slices merged into islands, to be used by the elephant foot compensation to trim the individual surfaces with the shrunk merged slices.
     ExPolygons              merged(float offset) const;
     template <class T> bool any_internal_region_slice_contains(const T &item) const {
@@ -164,7 +177,8 @@ public:
     void                    make_perimeters();
     // Phony version of make_fills() without parameters for Perl integration only.
     void                    make_fills() { this->make_fills(nullptr, nullptr); }
-    void                    make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive::Octree* support_fill_octree);
+    // pattern_cache: optional infill patterns shared by the layers of the object.
+    void                    make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive::Octree* support_fill_octree, FillPatternCache* pattern_cache = nullptr);
     void 					make_ironing();
 
     void                    export_region_slices_to_svg(const char *path) const;
@@ -187,7 +201,7 @@ protected:
     Layer(size_t id, PrintObject *object, coordf_t height, coordf_t print_z, coordf_t slice_z) :
         upper_layer(nullptr), lower_layer(nullptr), slicing_errors(false),
         slice_z(slice_z), print_z(print_z), height(height),
-        m_id(id), m_object(object) {}
+        m_id(id), m_object(object), m_support_map(lslices) {}
     virtual ~Layer();
 
 //BBS: method to simplify support path
@@ -201,6 +215,16 @@ private:
     size_t              m_id;
     PrintObject        *m_object;
     LayerRegionPtrs     m_regions;
+    LayerSupportMap     m_support_map;
+    // Fingerprints of the inputs, from which the perimeters and the fills of this layer were generated,
+    // zero if not generated yet. PrintObject::make_perimeters() and PrintObject::infill() keep the extrusions of a layer
+    // if the fingerprint of its inputs did not change.
+    // The fingerprints are 64bit boost::hash_combine() chains and the inputs are not stored to compare them on a match,
+    // thus a hash collision keeps stale extrusions silently. The chance is low, but it is not zero.
+    size_t              m_perimeters_fingerprint { 0 };
+    size_t              m_fills_fingerprint { 0 };
+    // Were the ironing extrusions added to the fills since they were generated?
+    bool                m_fills_ironed { false };
 };
 
 class SupportLayer : public Layer 
@@ -67,6 +67,7 @@ void LayerRegion::make_perimeters(const SurfaceCollection &slices, SurfaceCollec
 {
     this->perimeters.clear();
     this->thin_fills.clear();
+    m_perimeters_simplified = false;
 
     const PrintConfig       &print_config  = this->layer()->object()->print()->config();
     const PrintRegionConfig &region_config = this->region().config();
@@ -92,9 +93,11 @@ void LayerRegion::make_perimeters(const SurfaceCollection &slices, SurfaceCollec
         fill_surfaces
     );
     
-    if (this->layer()->lower_layer != nullptr)
+    if (this->layer()->lower_layer != nullptr) {
         // Cummulative sum of polygons over all the regions.
-        g.lower_slices = &this->layer()->lower_layer->lslices;
+        g.lower_slices      = &this->layer()->lower_layer->lslices;
+        g.lower_support_map = &this->layer()->lower_layer->support_map();
+    }
     if (this->layer()->upper_layer != NULL)
         g.upper_slices = &this->layer()->upper_layer->lslices;
     
@@ -134,7 +137,6 @@ void LayerRegion::process_external_surfaces(const Layer *lower_layer, const Poly
     Surfaces                    internal;
     // Areas, where an infill of various types (top, bottom, bottom bride, sparse, void) could be placed.
     Polygons                    fill_boundaries = to_polygons(this->fill_expolygons);
-    Polygons  					lower_layer_covered_tmp;
 
     // Collect top surfaces and internal surfaces.
     // Collect fill_boundaries: If we're slicing with no infill, we can't extend external surfaces over non-existent infill.
@@ -164,10 +166,8 @@ void LayerRegion::process_external_surfaces(const Layer *lower_layer, const Poly
         }
         if (! has_infill && lower_layer != nullptr && ! voids.empty()) {
         	// Remove voids from fill_boundaries, that are not supported by the layer below.
-            if (lower_layer_covered == nullptr) {
-            	lower_layer_covered = &lower_layer_covered_tmp;
-            	lower_layer_covered_tmp = to_polygons(lower_layer->lslices);
-            }
+            if (lower_layer_covered == nullptr)
+            	lower_layer_covered = &lower_layer->support_map().polygons();
             if (! lower_layer_covered->empty())
             	voids = diff(voids, *lower_layer_covered);
             fill_boundaries = diff(fill_boundaries, voids);
@@ -285,7 +285,7 @@ void LayerRegion::process_external_surfaces(const Layer *lower_layer, const Poly
                 // would get merged into a single one while they need different directions
                 // also, supply the original expolygon instead of the grown one, because in case
                 // of very thin (but still working) anchors, the grown expolygon would go beyond them
-                BridgeDetector bd(initial, lower_layer->lslices, this->bridging_flow(frInfill, g_config_thick_bridges).scaled_width());
+                BridgeDetector bd(initial, lower_layer->support_map(), this->bridging_flow(frInfill, g_config_thick_bridges).scaled_width());
                 #ifdef SLIC3R_DEBUG
                 printf("Processing bridge at layer %zu:\n", this->layer()->id());
                 #endif
@@ -500,8 +500,15 @@ void LayerRegion::export_region_fill_surfaces_to_svg_debug(const char *name) con
 //BBS
 void LayerRegion::simplify_extrusion_entity()
 {
-    simplify_entity_collection(&perimeters);
-    simplify_entity_collection(&fills);
+    // Extrusions kept from the previous run of the perimeter or infill generator are not simplified twice.
+    if (! m_perimeters_simplified) {
+        simplify_entity_collection(&perimeters);
+        m_perimeters_simplified = true;
+    }
+    if (! m_fills_simplified) {
+        simplify_entity_collection(&fills);
+        m_fills_simplified = true;
+    }
 }
 
 void LayerRegion::simplify_entity_collection(ExtrusionEntityCollection* entity_collection)
@@ -522,7 +529,7 @@ void LayerRegion::simplify_entity_collection(ExtrusionEntityCollection* entity_c
 
 void LayerRegion::simplify_path(ExtrusionPath* path)
 {
-    const auto print_config = this->layer()->object()->print()->config();
+    const auto &print_config = this->layer()->object()->print()->config();
     const bool spiral_mode = print_config.spiral_mode;
     const bool enable_arc_fitting = print_config.enable_arc_fitting;
     const auto scaled_resolution = scaled<double>(print_config.resolution.value);
@@ -540,7 +547,7 @@ void LayerRegion::simplify_path(ExtrusionPath* path)
 
 void LayerRegion::simplify_multi_path(ExtrusionMultiPath* multipath)
 {
-    const auto print_config = this->layer()->object()->print()->config();
+    const auto &print_config = this->layer()->object()->print()->config();
     const bool spiral_mode = print_config.spiral_mode;
     const bool enable_arc_fitting = print_config.enable_arc_fitting;
     const auto scaled_resolution = scaled<double>(print_config.resolution.value);
@@ -560,7 +567,7 @@ void LayerRegion::simplify_multi_path(ExtrusionMultiPath* multipath)
 
 void LayerRegion::simplify_loop(ExtrusionLoop* loop)
 {
-    const auto print_config = this->layer()->object()->print()->config();
+    const auto &print_config = this->layer()->object()->print()->config();
     const bool spiral_mode = print_config.spiral_mode;
     const bool enable_arc_fitting = print_config.enable_arc_fitting;
     const auto scaled_resolution = scaled<double>(print_config.resolution.value);
@@ -0,0 +1,46 @@
+#include "LayerSupportMap.hpp"
+
+namespace Slic3r {
+
+LayerSupportMap::LayerSupportMap(const ExPolygons &slices) : m_slices(slices), m_data(std::make_unique<Data>()) {}
+
+LayerSupportMap::~LayerSupportMap() = default;
+
+const Polygons& LayerSupportMap::polygons() const
+{
+    std::call_once(m_data->polygons_once, [this]() { m_data->polygons = to_polygons(m_slices); });
+    return m_data->polygons;
+}
+
+const Polygons& LayerSupportMap::contours() const
+{
+    std::call_once(m_data->contours_once, [this]() {
+        m_data->contours.reserve(m_slices.size());
+        for (const ExPolygon &expoly : m_slices)
+            m_data->contours.push_back(expoly.contour);
+    });
+    return m_data->contours;
+}
+
+const Polygons& LayerSupportMap::safety_offset() const
+{
+    std::call_once(m_data->safety_offset_once, [this]() { m_data->safety_offset = union_safety_offset(m_slices); });
+    return m_data->safety_offset;
+}
+
+const Polygons& LayerSupportMap::grown(float delta, ClipperLib::JoinType join_type, double miter_limit) const
+{
+    auto key = std::make_tuple(delta, int(join_type), miter_limit);
+    std::lock_guard<std::mutex> lock(m_data->grown_mutex);
+    auto it = m_data->grown.find(key);
+    if (it == m_data->grown.end())
+        it = m_data->grown.emplace(key, offset(m_slices, delta, join_type, miter_limit)).first;
+    return it->second;
+}
+
+void LayerSupportMap::clear()
+{
+    m_data = std::make_unique<Data>();
+}
+
+} // namespace Slic3r
@@ -0,0 +1,63 @@
+#ifndef slic3r_LayerSupportMap_hpp_
+#define slic3r_LayerSupportMap_hpp_
+
+#include "libslic3r.h"
+#include "ExPolygon.hpp"
+#include "ClipperUtils.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace Slic3r {
+
+// Derived data of Layer::lslices, which are queried by the layer above when detecting bridges, overhangs
+// and bridges over the support contacts: the polygons, their contours, and grown polygons.
+// Each of them is calculated lazily on the first query and then shared by all the regions of the layer above,
+// which are processed in parallel, therefore the queries are thread safe.
+// The map has to be cleared whenever the lslices of its layer change. Clearing is not thread safe.
+// PrintObject clears the maps of its layers at the end of each step querying them to release the cached data,
+// thus the data is only held while a single step is running.
+class LayerSupportMap
+{
+public:
+    explicit LayerSupportMap(const ExPolygons &slices);
+    ~LayerSupportMap();
+
+    // The lslices this map is derived from.
+    const ExPolygons&       slices() const { return m_slices; }
+    // to_polygons(slices())
+    const Polygons&         polygons() const;
+    // Contours of slices(), holes ignored.
+    const Polygons&         contours() const;
+    // union_safety_offset(slices())
+    const Polygons&         safety_offset() const;
+    // offset(slices(), delta, join_type, miter_limit), cached for each combination of the parameters.
+    const Polygons&         grown(float delta, ClipperLib::JoinType join_type = DefaultJoinType, double miter_limit = DefaultMiterLimit) const;
+
+    void                    clear();
+
+private:
+    LayerSupportMap(const LayerSupportMap&) = delete;
+    LayerSupportMap& operator=(const LayerSupportMap&) = delete;
+
+    struct Data {
+        std::once_flag                      polygons_once;
+        Polygons                            polygons;
+        std::once_flag                      contours_once;
+        Polygons                            contours;
+        std::once_flag                      safety_offset_once;
+        Polygons                            safety_offset;
+        // Node based container, the references returned by grown() stay valid when inserting.
+        std::mutex                          grown_mutex;
+        std::map<std::tuple<float, int, double>, Polygons> grown;
+    };
+
+    const ExPolygons               &m_slices;
+    std::unique_ptr<Data>           m_data;
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_LayerSupportMap_hpp_
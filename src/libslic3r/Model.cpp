@@ -2301,7 +2301,7 @@ bool ModelVolume::is_splittable() const
 {
     // the call mesh.is_splittable() is expensive, so cache the value to calculate it only once
     if (m_is_splittable == -1)
-        m_is_splittable = its_is_splittable(this->mesh().its);
+        m_is_splittable = this->mesh().is_splittable();
 
     return m_is_splittable == 1;
 }
@@ -13,8 +13,6 @@
 
 #include <boost/log/trivial.hpp>
 #include <tbb/parallel_for.h>
-#include <mutex>
-#include <boost/thread/lock_guard.hpp>
 
 namespace Slic3r {
 struct ColoredLine {
@@ -81,9 +79,19 @@ struct PaintedLine
     int    color;
 };
 
+// Painted triangle transformed into the object coordinate system with vertices sorted by z-axis.
+struct PaintedFacet
+{
+    std::array<Vec3f, 3> vertices;
+    int                  color;
+    // Range of layers [layer_begin, layer_end) the triangle may intersect.
+    size_t               layer_begin;
+    size_t               layer_end;
+};
+
 struct PaintedLineVisitor
 {
-    PaintedLineVisitor(const EdgeGrid::Grid &grid, std::vector<PaintedLine> &painted_lines, std::mutex &painted_lines_mutex, size_t reserve) : grid(grid), painted_lines(painted_lines), painted_lines_mutex(painted_lines_mutex)
+    PaintedLineVisitor(const EdgeGrid::Grid &grid, std::vector<PaintedLine> &painted_lines, size_t reserve) : grid(grid), painted_lines(painted_lines)
     {
         painted_lines_set.reserve(reserve);
     }
@@ -125,10 +133,7 @@ struct PaintedLineVisitor
                             line_to_test_projected.reverse();
 
                         painted_lines_set.insert(*it_contour_and_segment);
-                        {
-                            boost::lock_guard<std::mutex> lock(painted_lines_mutex);
-                            painted_lines.push_back({it_contour_and_segment->first, it_contour_and_segment->second, line_to_test_projected, this->color});
-                        }
+                        painted_lines.push_back({it_contour_and_segment->first, it_contour_and_segment->second, line_to_test_projected, this->color});
                     }
                 }
             }
@@ -139,7 +144,6 @@ struct PaintedLineVisitor
 
     const EdgeGrid::Grid                                                                 &grid;
     std::vector<PaintedLine>                                                             &painted_lines;
-    std::mutex                                                                           &painted_lines_mutex;
     Line                                                                                  line_to_test;
     std::unordered_set<std::pair<size_t, size_t>, boost::hash<std::pair<size_t, size_t>>> painted_lines_set;
     int                                                                                   color             = -1;
@@ -1725,7 +1729,6 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
     std::vector<std::vector<ExPolygons>>  segmented_regions(num_layers);
     segmented_regions.assign(num_layers, std::vector<ExPolygons>(num_extruders + 1));
     std::vector<std::vector<PaintedLine>> painted_lines(num_layers);
-    std::array<std::mutex, 64>            painted_lines_mutex;
     std::vector<EdgeGrid::Grid>           edge_grids(num_layers);
     const ConstLayerPtrsAdaptor           layers = print_object.layers();
     std::vector<ExPolygons>               input_expolygons(num_layers);
@@ -1765,108 +1768,128 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
     }); // end of parallel_for
     BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - slices preparation in parallel - end";
 
+    BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - edge grids creation in parallel - begin";
     std::vector<BoundingBox> layer_bboxes(num_layers);
-    for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx) {
-        throw_on_cancel_callback();
-        layer_bboxes[layer_idx] = get_extents(layers[layer_idx]->regions());
-        layer_bboxes[layer_idx].merge(get_extents(input_expolygons[layer_idx]));
-    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&layers, &input_expolygons, &layer_bboxes, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
+            throw_on_cancel_callback();
+            layer_bboxes[layer_idx] = get_extents(layers[layer_idx]->regions());
+            layer_bboxes[layer_idx].merge(get_extents(input_expolygons[layer_idx]));
+        }
+    }); // end of parallel_for
 
-    for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx) {
-        throw_on_cancel_callback();
-        BoundingBox bbox = layer_bboxes[layer_idx];
-        // Projected triangles could, in rare cases (as in GH issue #7299), belongs to polygons printed in the previous or the next layer.
-        // Let's merge the bounding box of the current layer with bounding boxes of the previous and the next layer to ensure that
-        // every projected triangle will be inside the resulting bounding box.
-        if (layer_idx > 1) bbox.merge(layer_bboxes[layer_idx - 1]);
-        if (layer_idx < num_layers - 1) bbox.merge(layer_bboxes[layer_idx + 1]);
-        // Projected triangles may slightly exceed the input polygons.
-        bbox.offset(20 * SCALED_EPSILON);
-        edge_grids[layer_idx].set_bbox(bbox);
-        edge_grids[layer_idx].create(input_expolygons[layer_idx], coord_t(scale_(10.)));
-    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&num_layers, &layer_bboxes, &input_expolygons, &edge_grids, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
+            throw_on_cancel_callback();
+            BoundingBox bbox = layer_bboxes[layer_idx];
+            // Projected triangles could, in rare cases (as in GH issue #7299), belongs to polygons printed in the previous or the next layer.
+            // Let's merge the bounding box of the current layer with bounding boxes of the previous and the next layer to ensure that
+            // every projected triangle will be inside the resulting bounding box.
+            if (layer_idx > 1) bbox.merge(layer_bboxes[layer_idx - 1]);
+            if (layer_idx < num_layers - 1) bbox.merge(layer_bboxes[layer_idx + 1]);
+            // Projected triangles may slightly exceed the input polygons.
+            bbox.offset(20 * SCALED_EPSILON);
+            edge_grids[layer_idx].set_bbox(bbox);
+            edge_grids[layer_idx].create(input_expolygons[layer_idx], coord_t(scale_(10.)));
+        }
+    }); // end of parallel_for
+    BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - edge grids creation in parallel - end";
 
     BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - projection of painted triangles - begin";
+    // Collect the painted triangles of all volumes and extruders, transformed into the object coordinate system.
+    std::vector<PaintedFacet> painted_facets;
     for (const ModelVolume *mv : print_object.model_object()->volumes) {
-        tbb::parallel_for(tbb::blocked_range<size_t>(1, num_extruders + 1), [&mv, &print_object, &layers, &edge_grids, &painted_lines, &painted_lines_mutex, &input_expolygons, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        if (!mv->is_model_part())
+            continue;
+
+        const Transform3f                      tr = print_object.trafo().cast<float>() * mv->get_matrix().cast<float>();
+        std::vector<std::vector<PaintedFacet>> painted_facets_by_extruder(num_extruders + 1);
+        tbb::parallel_for(tbb::blocked_range<size_t>(1, num_extruders + 1), [&mv, &tr, &layers, &painted_facets_by_extruder, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
             for (size_t extruder_idx = range.begin(); extruder_idx < range.end(); ++extruder_idx) {
                 throw_on_cancel_callback();
                 const indexed_triangle_set custom_facets = mv->mmu_segmentation_facets.get_facets(*mv, EnforcerBlockerType(extruder_idx));
-                if (!mv->is_model_part() || custom_facets.indices.empty())
-                    continue;
+                std::vector<PaintedFacet> &out = painted_facets_by_extruder[extruder_idx];
+                out.reserve(custom_facets.indices.size());
+                for (const stl_triangle_vertex_indices &face : custom_facets.indices) {
+                    PaintedFacet &painted_facet = out.emplace_back();
+                    painted_facet.color = int(extruder_idx);
+                    std::array<Vec3f, 3> &facet = painted_facet.vertices;
+                    for (int p_idx = 0; p_idx < 3; ++p_idx)
+                        facet[p_idx] = tr * custom_facets.vertices[face(p_idx)];
+
+                    // Sort the vertices by z-axis for simplification of projected_facet on slices
+                    std::sort(facet.begin(), facet.end(), [](const Vec3f &p1, const Vec3f &p2) { return p1.z() < p2.z(); });
+
+                    // Find lowest slice not below the triangle and the first slice above the triangle.
+                    painted_facet.layer_begin = std::upper_bound(layers.begin(), layers.end(), float(facet[0].z() - EPSILON),
+                                                                 [](float z, const Layer *l1) { return z < l1->slice_z; }) - layers.begin();
+                    painted_facet.layer_end   = std::upper_bound(layers.begin(), layers.end(), float(facet[2].z() + EPSILON),
+                                                                 [](float z, const Layer *l1) { return z < l1->slice_z; }) - layers.begin();
+                }
+            }
+        }); // end of parallel_for
 
-                const Transform3f tr = print_object.trafo().cast<float>() * mv->get_matrix().cast<float>();
-                tbb::parallel_for(tbb::blocked_range<size_t>(0, custom_facets.indices.size()), [&tr, &custom_facets, &print_object, &layers, &edge_grids, &input_expolygons, &painted_lines, &painted_lines_mutex, &extruder_idx](const tbb::blocked_range<size_t> &range) {
-                    for (size_t facet_idx = range.begin(); facet_idx < range.end(); ++facet_idx) {
-                        float min_z = std::numeric_limits<float>::max();
-                        float max_z = std::numeric_limits<float>::lowest();
-
-                        std::array<Vec3f, 3> facet;
-                        for (int p_idx = 0; p_idx < 3; ++p_idx) {
-                            facet[p_idx] = tr * custom_facets.vertices[custom_facets.indices[facet_idx](p_idx)];
-                            max_z        = std::max(max_z, facet[p_idx].z());
-                            min_z        = std::min(min_z, facet[p_idx].z());
-                        }
+        for (std::vector<PaintedFacet> &facets : painted_facets_by_extruder)
+            append(painted_facets, std::move(facets));
+    }
 
-                        // Sort the vertices by z-axis for simplification of projected_facet on slices
-                        std::sort(facet.begin(), facet.end(), [](const Vec3f &p1, const Vec3f &p2) { return p1.z() < p2.z(); });
-
-                        // Find lowest slice not below the triangle.
-                        auto first_layer = std::upper_bound(layers.begin(), layers.end(), float(min_z - EPSILON),
-                                                            [](float z, const Layer *l1) { return z < l1->slice_z; });
-                        auto last_layer  = std::upper_bound(layers.begin(), layers.end(), float(max_z + EPSILON),
-                                                           [](float z, const Layer *l1) { return z < l1->slice_z; });
-                        --last_layer;
-
-                        for (auto layer_it = first_layer; layer_it != (last_layer + 1); ++layer_it) {
-                            const Layer *layer     = *layer_it;
-                            size_t       layer_idx = layer_it - layers.begin();
-                            if (input_expolygons[layer_idx].empty() || facet[0].z() > layer->slice_z || layer->slice_z > facet[2].z())
-                                continue;
-
-                            // https://kandepet.com/3d-printing-slicing-3d-objects/
-                            float t            = (float(layer->slice_z) - facet[0].z()) / (facet[2].z() - facet[0].z());
-                            Vec3f line_start_f = facet[0] + t * (facet[2] - facet[0]);
-                            Vec3f line_end_f;
-
-                            if (facet[1].z() > layer->slice_z) {
-                                // [P0, P2] and [P0, P1]
-                                float t1   = (float(layer->slice_z) - facet[0].z()) / (facet[1].z() - facet[0].z());
-                                line_end_f = facet[0] + t1 * (facet[1] - facet[0]);
-                            } else {
-                                // [P0, P2] and [P1, P2]
-                                float t2   = (float(layer->slice_z) - facet[1].z()) / (facet[2].z() - facet[1].z());
-                                line_end_f = facet[1] + t2 * (facet[2] - facet[1]);
-                            }
+    // Bucket the painted triangles by layers, so that painted lines of each layer are produced by a single task without any locking.
+    std::vector<std::vector<size_t>> painted_facets_by_layer(num_layers);
+    for (size_t facet_idx = 0; facet_idx < painted_facets.size(); ++facet_idx)
+        for (size_t layer_idx = painted_facets[facet_idx].layer_begin; layer_idx < painted_facets[facet_idx].layer_end; ++layer_idx)
+            painted_facets_by_layer[layer_idx].emplace_back(facet_idx);
 
-                            Line line_to_test(Point(scale_(line_start_f.x()), scale_(line_start_f.y())),
-                                              Point(scale_(line_end_f.x()), scale_(line_end_f.y())));
-                            line_to_test.translate(-print_object.center_offset());
-
-                            // BoundingBoxes for EdgeGrids are computed from printable regions. It is possible that the painted line (line_to_test) could
-                            // be outside EdgeGrid's BoundingBox, for example, when the negative volume is used on the painted area (GH #7618).
-                            // To ensure that the painted line is always inside EdgeGrid's BoundingBox, it is clipped by EdgeGrid's BoundingBox in cases
-                            // when any of the endpoints of the line are outside the EdgeGrid's BoundingBox.
-                            if (const BoundingBox &edge_grid_bbox = edge_grids[layer_idx].bbox(); !edge_grid_bbox.contains(line_to_test.a) || !edge_grid_bbox.contains(line_to_test.b)) {
-                                // If the painted line (line_to_test) is entirely outside EdgeGrid's BoundingBox, skip this painted line.
-                                if (!edge_grid_bbox.overlap(BoundingBox(Points{line_to_test.a, line_to_test.b})) ||
-                                    !line_to_test.clip_with_bbox(edge_grid_bbox))
-                                    continue;
-                            }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&print_object, &layers, &edge_grids, &input_expolygons, &painted_facets, &painted_facets_by_layer, &painted_lines, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
+            if (painted_facets_by_layer[layer_idx].empty() || input_expolygons[layer_idx].empty())
+                continue;
 
-                            size_t mutex_idx = layer_idx & 0x3F;
-                            assert(mutex_idx < painted_lines_mutex.size());
+            throw_on_cancel_callback();
+            const Layer          *layer     = layers[layer_idx];
+            const EdgeGrid::Grid &edge_grid = edge_grids[layer_idx];
+            PaintedLineVisitor    visitor(edge_grid, painted_lines[layer_idx], 16);
+            for (size_t facet_idx : painted_facets_by_layer[layer_idx]) {
+                const std::array<Vec3f, 3> &facet = painted_facets[facet_idx].vertices;
+                if (facet[0].z() > layer->slice_z || layer->slice_z > facet[2].z())
+                    continue;
 
-                            PaintedLineVisitor visitor(edge_grids[layer_idx], painted_lines[layer_idx], painted_lines_mutex[mutex_idx], 16);
-                            visitor.line_to_test = line_to_test;
-                            visitor.color        = int(extruder_idx);
-                            edge_grids[layer_idx].visit_cells_intersecting_line(line_to_test.a, line_to_test.b, visitor);
-                        }
-                    }
-                }); // end of parallel_for
+                // https://kandepet.com/3d-printing-slicing-3d-objects/
+                float t            = (float(layer->slice_z) - facet[0].z()) / (facet[2].z() - facet[0].z());
+                Vec3f line_start_f = facet[0] + t * (facet[2] - facet[0]);
+                Vec3f line_end_f;
+
+                if (facet[1].z() > layer->slice_z) {
+                    // [P0, P2] and [P0, P1]
+                    float t1   = (float(layer->slice_z) - facet[0].z()) / (facet[1].z() - facet[0].z());
+                    line_end_f = facet[0] + t1 * (facet[1] - facet[0]);
+                } else {
+                    // [P0, P2] and [P1, P2]
+                    float t2   = (float(layer->slice_z) - facet[1].z()) / (facet[2].z() - facet[1].z());
+                    line_end_f = facet[1] + t2 * (facet[2] - facet[1]);
+                }
+
+                Line line_to_test(Point(scale_(line_start_f.x()), scale_(line_start_f.y())),
+                                  Point(scale_(line_end_f.x()), scale_(line_end_f.y())));
+                line_to_test.translate(-print_object.center_offset());
+
+                // BoundingBoxes for EdgeGrids are computed from printable regions. It is possible that the painted line (line_to_test) could
+                // be outside EdgeGrid's BoundingBox, for example, when the negative volume is used on the painted area (GH #7618).
+                // To ensure that the painted line is always inside EdgeGrid's BoundingBox, it is clipped by EdgeGrid's BoundingBox in cases
+                // when any of the endpoints of the line are outside the EdgeGrid's BoundingBox.
+                if (const BoundingBox &edge_grid_bbox = edge_grid.bbox(); !edge_grid_bbox.contains(line_to_test.a) || !edge_grid_bbox.contains(line_to_test.b)) {
+                    // If the painted line (line_to_test) is entirely outside EdgeGrid's BoundingBox, skip this painted line.
+                    if (!edge_grid_bbox.overlap(BoundingBox(Points{line_to_test.a, line_to_test.b})) ||
+                        !line_to_test.clip_with_bbox(edge_grid_bbox))
+                        continue;
+                }
+
+                visitor.reset();
+                visitor.line_to_test = line_to_test;
+                visitor.color        = painted_facets[facet_idx].color;
+                edge_grid.visit_cells_intersecting_line(line_to_test.a, line_to_test.b, visitor);
             }
-        }); // end of parallel_for
-    }
+        }
+    }); // end of parallel_for
     BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - projection of painted triangles - end";
     BOOST_LOG_TRIVIAL(debug) << "MMU segmentation - painted layers count: "
                              << std::count_if(painted_lines.begin(), painted_lines.end(), [](const std::vector<PaintedLine> &pl) { return !pl.empty(); });
@@ -5,6 +5,7 @@
 #include <boost/geometry/index/rtree.hpp>
 #include <tbb/parallel_for.h>
 #include <tbb/atomic.h>
+#include <atomic>
 
 #if defined(_MSC_VER) && defined(__clang__)
 #define BOOST_NO_CXX17_HDR_STRING_VIEW
@@ -63,12 +64,21 @@ public:
     Eigen::MatrixXf normals, normals_hull;
     Eigen::VectorXf areas, areas_hull;
     Eigen::VectorXf is_apperance; // whether a facet is outer apperance
-    Eigen::MatrixXf z_projected;
-    Eigen::VectorXf z_max, z_max_hull;  // max of projected z
-    Eigen::VectorXf z_median;  // median of projected z
-    Eigen::VectorXf z_mean;  // mean of projected z
+    Eigen::VectorXf areas_appearance; // areas weighted by the appearance face penalty
+    // Facet vertices packed column by column (facets x 3 per vertex index), so that projecting
+    // all facets onto an orientation is a plain matrix-vector product.
+    std::array<Eigen::MatrixXf, 3> vertices, vertices_hull;
     OrientParams params;
 
+    // Projection of the mesh onto a single candidate orientation. Kept out of the members,
+    // so that the candidate orientations may be evaluated concurrently.
+    struct Projection {
+        Eigen::MatrixXf z_projected;  // projected z of the facet vertices
+        Eigen::VectorXf z_max, z_max_hull;  // max of projected z
+        Eigen::VectorXf z_mean;  // mean of projected z
+        float           z_min { 0.f };
+    };
+
 
     std::vector< Vec3f> orientations;  // Vec3f == stl_normal
     std::function<void(unsigned)> progressind = { };  // default empty indicator function
@@ -125,37 +135,61 @@ public:
         if (progressind)
             progressind(30);
 
-        std::unordered_map<Vec3f, CostItems, VecHash> results;
-        BOOST_LOG_TRIVIAL(info) << CostItems::field_names();
-        std::cout << CostItems::field_names() << std::endl;
-        for (int i = 0; i < orientations.size();i++) {
-            auto orientation = -orientations[i];
-
-            project_vertices(orientation);
-
-            auto cost_items = get_features(orientation, params.min_volume);
-
-            float unprintability = target_function(cost_items, params.min_volume);
+        // Features of the mesh, which do not depend on the orientation.
+        CostItems mesh_costs;
+        mesh_costs.area_total = mesh->bounding_box().area();
+        mesh_costs.radius = mesh->bounding_box().radius();
+        mesh_costs.volume = mesh->stats().volume > 0 ? mesh->stats().volume : its_volume(mesh->its);
+
+        // Evaluate the candidates in parallel. A candidate is rejected as soon as the lower bound
+        // of its cost exceeds the best cost found so far, thus it could never be picked.
+        std::vector<CostItems> results(orientations.size(), mesh_costs);
+        std::vector<char>      rejected(orientations.size(), false);
+        std::atomic<float>     best_cost { std::numeric_limits<float>::max() };
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, orientations.size()), [this, &results, &rejected, &best_cost](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i != range.end(); ++ i) {
+                auto orientation = -orientations[i];
+                CostItems &cost_items = results[i];
+
+                Projection proj = project_vertices(orientation);
+
+                cost_items.bottom = bottom_area(proj);
+                if (cost_lower_bound(cost_items, params.min_volume) > best_cost.load(std::memory_order_relaxed)) {
+                    rejected[i] = true;
+                    continue;
+                }
 
-            results[orientation] = cost_items;
+                get_features(orientation, proj, cost_items, params.min_volume);
 
-            BOOST_LOG_TRIVIAL(info) << std::fixed << std::setprecision(4) << "orientation:" << orientation.transpose() << ", cost:" << std::fixed << std::setprecision(4) << cost_items.field_values();
-            std::cout << std::fixed << std::setprecision(4) << "orientation:" << orientation.transpose() << ", cost:" << std::fixed << std::setprecision(4) << cost_items.field_values() << std::endl;
-        }
+                float unprintability = target_function(cost_items, params.min_volume);
+                for (float best = best_cost.load(std::memory_order_relaxed); unprintability < best && ! best_cost.compare_exchange_weak(best, unprintability, std::memory_order_relaxed); ) ;
+            }
+        });
         if (progressind)
             progressind(60);
 
-        typedef std::pair<Vec3f, CostItems> PAIR;
-        std::vector<PAIR> results_vector(results.begin(), results.end());
-        sort(results_vector.begin(), results_vector.end(), [](const PAIR& p1, const PAIR& p2) {return p1.second.unprintability < p2.second.unprintability; });
-
+        BOOST_LOG_TRIVIAL(info) << CostItems::field_names();
+        std::cout << CostItems::field_names() << std::endl;
+        size_t best_idx = size_t(-1);
+        for (size_t i = 0; i < orientations.size(); ++ i) {
+            auto orientation = -orientations[i];
+            if (rejected[i]) {
+                BOOST_LOG_TRIVIAL(info) << std::fixed << std::setprecision(4) << "orientation:" << orientation.transpose() << ", rejected, bottom:" << results[i].bottom;
+                continue;
+            }
+            BOOST_LOG_TRIVIAL(info) << std::fixed << std::setprecision(4) << "orientation:" << orientation.transpose() << ", cost:" << std::fixed << std::setprecision(4) << results[i].field_values();
+            std::cout << std::fixed << std::setprecision(4) << "orientation:" << orientation.transpose() << ", cost:" << std::fixed << std::setprecision(4) << results[i].field_values() << std::endl;
+            // Ties are resolved in favor of the candidate found first, so that the result does not depend on scheduling.
+            if (best_idx == size_t(-1) || results[i].unprintability < results[best_idx].unprintability)
+                best_idx = i;
+        }
         if (progressind)
             progressind(80);
 
-        auto best_orientation = results_vector[0].first;
+        auto best_orientation = -orientations[best_idx];
 
-        BOOST_LOG_TRIVIAL(info) << std::fixed << std::setprecision(6) << "best:" << best_orientation.transpose() << ", costs:" << results_vector[0].second.field_values();
-        std::cout << std::fixed << std::setprecision(6) << "best:" << best_orientation.transpose() << ", costs:" << results_vector[0].second.field_values() << std::endl;
+        BOOST_LOG_TRIVIAL(info) << std::fixed << std::setprecision(6) << "best:" << best_orientation.transpose() << ", costs:" << results[best_idx].field_values();
+        std::cout << std::fixed << std::setprecision(6) << "best:" << best_orientation.transpose() << ", costs:" << results[best_idx].field_values() << std::endl;
 
         return best_orientation.cast<double>();
     }
@@ -181,6 +215,8 @@ public:
                 is_apperance(i) = (its.get_property(i).type == EnumFaceTypes::eExteriorAppearance);
                 count_apperance += (is_apperance(i)==1);
             }
+            areas_appearance = areas.cwiseProduct(is_apperance * params.APPERANCE_FACE_SUPP + Eigen::VectorXf::Ones(face_count));
+            pack_vertices(its, vertices);
         }
 
         if (orient_mesh)
@@ -204,9 +240,19 @@ public:
                 normals_hull.row(i) = quantize_vec3f(face_normals[i]);
                 areas_hull(i) = area;
             }
+            pack_vertices(its, vertices_hull);
         }
     }
 
+    static void pack_vertices(const indexed_triangle_set &its, std::array<Eigen::MatrixXf, 3> &out)
+    {
+        for (Eigen::MatrixXf &v : out)
+            v.resize(its.indices.size(), 3);
+        for (size_t i = 0; i < its.indices.size(); ++ i)
+            for (int j = 0; j < 3; ++ j)
+                out[j].row(i) = its.vertices[its.indices[i](j)];
+    }
+
     void area_cumulation(const Eigen::MatrixXf& normals_, const Eigen::VectorXf& areas_, int num_directions = 10)
     {
         std::unordered_map<stl_normal, float, VecHash> alignments;
@@ -266,36 +312,31 @@ public:
         }
     }
 
-    void project_vertices(Vec3f orientation)
+    Projection project_vertices(const Vec3f &orientation) const
     {
-        int face_count = mesh->facets_count();
-        auto its = mesh->its;
-        z_projected.resize(face_count, 3);
-        z_max.resize(face_count, 1);
-        z_median.resize(face_count, 1);
-        z_mean.resize(face_count, 1);
-        for (size_t i = 0; i < face_count; i++)
-        {
-            float z0 = its.get_vertex(i,0).dot(orientation);
-            float z1 = its.get_vertex(i,1).dot(orientation);
-            float z2 = its.get_vertex(i,2).dot(orientation);
-            z_projected(i, 0) = z0;
-            z_projected(i, 1) = z1;
-            z_projected(i, 2) = z2;
-            z_max(i) = MAX3(z0,z1,z2);
-            z_median(i) = MEDIAN3(z0,z1,z2);
-            z_mean(i) = (z0 + z1 + z2) / 3;
-        }
+        Projection proj;
+        proj.z_projected.resize(vertices[0].rows(), 3);
+        for (int j = 0; j < 3; ++ j)
+            proj.z_projected.col(j).noalias() = vertices[j] * orientation;
+        proj.z_max  = proj.z_projected.rowwise().maxCoeff();
+        proj.z_mean = proj.z_projected.rowwise().mean();
+        proj.z_min  = proj.z_projected.size() > 0 ? proj.z_projected.minCoeff() : 0.f;
+
+        proj.z_max_hull.noalias() = vertices_hull[0] * orientation;
+        for (int j = 1; j < 3; ++ j)
+            proj.z_max_hull = proj.z_max_hull.cwiseMax(vertices_hull[j] * orientation);
+        return proj;
+    }
 
-        z_max_hull.resize(mesh_convex_hull.facets_count(), 1);
-        its = mesh_convex_hull.its;
-        for (size_t i = 0; i < z_max_hull.rows(); i++)
-        {
-            float z0 = its.get_vertex(i,0).dot(orientation);
-            float z1 = its.get_vertex(i,1).dot(orientation);
-            float z2 = its.get_vertex(i,2).dot(orientation);
-            z_max_hull(i) = MAX3(z0, z1, z2);
-        }
+    float bottom_area(const Projection &proj) const
+    {
+        return (proj.z_max.array() < proj.z_min + this->params.FIRST_LAY_H).select(areas, 0).sum();
+    }
+
+    // Lower bound of target_function() knowing just the bottom area, all the other terms are non-negative.
+    float cost_lower_bound(const CostItems &costs, bool min_volume) const
+    {
+        return (min_volume ? params.TAR_A * params.TAR_B : 0.f) + (costs.bottom < params.BOTTOM_MIN) * 100;
     }
 
     static Eigen::VectorXi argsort(const Eigen::VectorXf& vec, std::string order="ascend")
@@ -322,32 +363,23 @@ public:
     }
 
     // previously calc_overhang
-    CostItems get_features(Vec3f orientation, bool min_volume = true)
+    // Fills in the orientation dependent features, costs.bottom is expected to be filled in by bottom_area().
+    void get_features(const Vec3f &orientation, const Projection &proj, CostItems &costs, bool min_volume = true) const
     {
-        CostItems costs;
-        costs.area_total = mesh->bounding_box().area();
-        costs.radius = mesh->bounding_box().radius();
-        // volume
-        costs.volume = mesh->stats().volume > 0 ? mesh->stats().volume : its_volume(mesh->its);
-
-        float total_min_z = z_projected.minCoeff();
+        float total_min_z = proj.z_min;
+        const Eigen::VectorXf &z_max = proj.z_max;
         // filter bottom area
         auto bottom_condition = z_max.array() < total_min_z + this->params.FIRST_LAY_H;
-        costs.bottom = bottom_condition.select(areas, 0).sum();
 
         // filter overhang
-        Eigen::VectorXf normal_projection(normals.rows(), 1);// = this->normals.dot(orientation);
-        for (size_t i = 0; i < normals.rows(); i++)
-        {
-            normal_projection(i) = normals.row(i).dot(orientation);
-        }
-        auto areas_appearance = areas.cwiseProduct((is_apperance * params.APPERANCE_FACE_SUPP + Eigen::VectorXf::Ones(is_apperance.rows(), is_apperance.cols())));
+        Eigen::VectorXf normal_projection;
+        normal_projection.noalias() = normals * orientation;
         auto overhang_areas = ((normal_projection.array() < params.ASCENT) * (!bottom_condition)).select(areas_appearance, 0);
         Eigen::MatrixXf inner = normal_projection.array() - params.ASCENT;
         inner = inner.cwiseMin(0).cwiseAbs();
         if (min_volume)
         {
-            Eigen::MatrixXf heights = z_mean.array() - total_min_z;
+            Eigen::MatrixXf heights = proj.z_mean.array() - total_min_z;
             costs.overhang = (heights.array()* overhang_areas.array()*inner.array()).sum();
         }
         else {
@@ -367,7 +399,7 @@ public:
             for (size_t i = 0; i < face_count; i++)
             {
                 if (bottom_condition(i)) {
-                    Eigen::VectorXi index = argsort(z_projected.row(i));
+                    Eigen::VectorXi index = argsort(proj.z_projected.row(i));
                     stl_vertex line = its.get_vertex(i, index(0)) - its.get_vertex(i, index(1));
                     contour += line.norm();
                     contour_amout++;
@@ -378,7 +410,7 @@ public:
         }
 
         // bottom of convex hull
-        costs.bottom_hull = (z_max_hull.array()< total_min_z + this->params.FIRST_LAY_H).select(areas_hull, 0).sum();
+        costs.bottom_hull = (proj.z_max_hull.array()< total_min_z + this->params.FIRST_LAY_H).select(areas_hull, 0).sum();
 
         // low angle faces
         auto normal_projection_abs = normal_projection.cwiseAbs();
@@ -386,13 +418,11 @@ public:
         costs.area_laf = laf_areas.sum();
 
         // height to bottom_hull_area ratio
-        //float total_max_z = z_projected.maxCoeff();
+        //float total_max_z = proj.z_projected.maxCoeff();
         //costs.height_to_bottom_hull_ratio = SQ(total_max_z) / (costs.bottom_hull + 1e-7);
-
-        return costs;
     }
 
-    float target_function(CostItems& costs, bool min_volume)
+    float target_function(CostItems& costs, bool min_volume) const
     {
         float cost=0;
         float bottom = costs.bottom;//std::min(costs.bottom, params.BOTTOM_MAX);
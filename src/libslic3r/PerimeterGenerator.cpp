@@ -4,6 +4,7 @@
 #include "ShortestPath.hpp"
 #include "VariableWidth.hpp"
 #include "CurveAnalyzer.hpp"
+#include "LayerSupportMap.hpp"
 
 #include <cmath>
 #include <cassert>
@@ -432,14 +433,13 @@ void PerimeterGenerator::process()
                             ex.medial_axis(ext_perimeter_width + ext_perimeter_spacing2, min_width, &thin_walls);
                     } else {
                         coord_t ext_perimeter_smaller_width = this->smaller_ext_perimeter_flow.scaled_width();
-                        for (const ExPolygon& expolygon : last) {
-                            // BBS: judge whether it's narrow but not too long island which is hard to place two line
-                            ExPolygons expolys;
-                            expolys.push_back(expolygon);
-                            ExPolygons offset_result = offset2_ex(expolys,
-                                -float(ext_perimeter_width / 2. + ext_min_spacing_smaller / 2.),
-                                +float(ext_min_spacing_smaller / 2.));
-                            if (offset_result.empty() &&
+                        // BBS: judge whether it's narrow but not too long island which is hard to place two line
+                        std::vector<ExPolygons> offset_results = offset2_ex_batch(last,
+                            -float(ext_perimeter_width / 2. + ext_min_spacing_smaller / 2.),
+                            +float(ext_min_spacing_smaller / 2.));
+                        for (size_t i = 0; i < last.size(); ++ i) {
+                            const ExPolygon &expolygon = last[i];
+                            if (offset_results[i].empty() &&
                                 expolygon.area() < (double)(ext_perimeter_width + ext_min_spacing_smaller) * scale_(narrow_loop_length_threshold)) {
                                 // BBS: for narrow external loop, use smaller line width
                                 ExPolygons temp_result = offset_ex(expolygon, -float(ext_perimeter_smaller_width / 2.));
@@ -829,8 +829,10 @@ std::map<int, Polygons> PerimeterGenerator::generate_lower_polygons_series(float
     }
 
     // offset expolygon to generate series of polygons
+    // The offsets are shared through the support map of the lower layer by the regions with the same perimeter widths.
     for (int i = 0; i < offset_series.size(); i++) {
-        lower_polygons_series.insert(std::pair<int, Polygons>(i, offset(*this->lower_slices, float(scale_(offset_series[i])))));
+        float delta = float(scale_(offset_series[i]));
+        lower_polygons_series.insert(std::pair<int, Polygons>(i, this->lower_support_map ? this->lower_support_map->grown(delta) : offset(*this->lower_slices, delta)));
     }
     return lower_polygons_series;
 }
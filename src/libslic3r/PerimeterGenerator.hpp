@@ -10,12 +10,16 @@
 
 namespace Slic3r {
 
+class LayerSupportMap;
+
 class PerimeterGenerator {
 public:
     // Inputs:
     const SurfaceCollection     *slices;
     const ExPolygons            *upper_slices;
     const ExPolygons            *lower_slices;
+    // Optional cache of the offsets of lower_slices, shared by the regions of a layer.
+    const LayerSupportMap       *lower_support_map;
     double                       layer_height;
     int                          layer_id;
     Flow                         perimeter_flow;
@@ -53,7 +57,7 @@ public:
         ExtrusionEntityCollection*  gap_fill,
         // Infills without the gap fills
         SurfaceCollection*          fill_surfaces)
-        : slices(slices), upper_slices(nullptr), lower_slices(nullptr), layer_height(layer_height),
+        : slices(slices), upper_slices(nullptr), lower_slices(nullptr), lower_support_map(nullptr), layer_height(layer_height),
             layer_id(-1), perimeter_flow(flow), ext_perimeter_flow(flow),
             overhang_flow(flow), solid_infill_flow(flow),
             config(config), object_config(object_config), print_config(print_config),
@@ -6,6 +6,10 @@
 #include <iomanip>
 #include <sstream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 #ifdef _MSC_VER
     #include <stdlib.h>  // provides **_environ
 #else
@@ -1424,7 +1428,838 @@ static std::string process_macro(const std::string &templ, client::MyContext &co
     return output;
 }
 
+// Expression compiled from a subset of the macro language: number, boolean and string literals, variable references,
+// arithmetic, comparisons, logical operators, regex matching, the ternary operator and the min(), max(), int() and round() functions.
+// The compiled expression is evaluated using the same client::expr<> operators as the boost::spirit grammar,
+// thus it produces exactly the same results.
+struct CompiledExpression
+{
+    typedef std::string::const_iterator iterator_type;
+
+    enum Type {
+        LITERAL,
+        VARIABLE,
+        // args[0]: index
+        VECTOR_VARIABLE,
+        UNARY_MINUS,
+        NOT,
+        INT,
+        ROUND,
+        ADD,
+        SUBTRACT,
+        MULTIPLY,
+        DIVIDE,
+        MODULO,
+        EQUAL,
+        NOT_EQUAL,
+        LOWER,
+        GREATER,
+        LEQ,
+        GEQ,
+        REGEX_MATCHES,
+        REGEX_DOESNT_MATCH,
+        LOGICAL_AND,
+        LOGICAL_OR,
+        // args[0] ? args[1] : args[2]
+        TERNARY,
+        MIN,
+        MAX,
+    };
+
+    Type                            type { LITERAL };
+    client::expr<iterator_type>     value;
+    // Variable name or a regular expression including the enclosing slashes.
+    std::string                     text;
+    std::vector<CompiledExpression> args;
+};
+
+// A template split into independent segments, so that a custom G-code template is expanded by walking
+// the precompiled segments and expressions instead of running the boost::spirit grammar over the template text.
+// Expressions using the less common features of the macro language are handed over to process_macro() one by one.
+// Compiled templates are immutable and cached by the template text, see PlaceholderParser::process().
+struct CompiledTemplate
+{
+    struct Segment {
+        enum Type {
+            // Free-form text, copied to the output verbatim.
+            TEXT,
+            // [variable] or legacy [vector_variable_index]
+            LEGACY_VARIABLE,
+            // [vector_variable[index_variable]]
+            LEGACY_VECTOR_VARIABLE,
+            // {expression}
+            EXPRESSION,
+            // {if condition}...{elsif condition}...{else}...{endif}
+            IF,
+            // Anything else enclosed in {}, to be processed by the boost::spirit grammar.
+            MACRO,
+        };
+        struct Branch {
+            // Source of the boolean expression, empty for the {else} branch.
+            std::string          condition;
+            // Is the condition stored in condition_expression? Otherwise the condition is processed by the boost::spirit grammar.
+            bool                 condition_compiled { false };
+            CompiledExpression   condition_expression;
+            std::vector<Segment> body;
+        };
+        Type                type;
+        // Text, macro source, variable name.
+        std::string         text;
+        // Name of the indexing variable of LEGACY_VECTOR_VARIABLE.
+        std::string         index;
+        CompiledExpression  expression;
+        std::vector<Branch> branches;
+    };
+
+    // The template could not be split into segments, it is processed by the boost::spirit grammar as a whole.
+    // This is decided when compiling the template, before anything is evaluated. This is also the case for templates
+    // with syntax errors detected when splitting, so that the error messages are reported against the full template.
+    bool                 monolithic { false };
+    std::vector<Segment> segments;
+};
+
+// White spaces skipped by the boost::spirit grammar (spirit_encoding::space_type), limited to 7bit ASCII.
+static inline bool is_template_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r'; }
+static inline bool is_identifier_start(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+static inline bool is_identifier_char(char c) { return is_identifier_start(c) || (c >= '0' && c <= '9'); }
+
+static bool is_template_keyword(const std::string &s)
+{
+    static const char *keywords[] = { "and", "digits", "zdigits", "if", "int", "else", "elsif", "endif", "false", "min", "max", "random", "round", "not", "or", "true" };
+    for (const char *kw : keywords)
+        if (s == kw)
+            return true;
+    return false;
+}
+
+// Mirrors client::utf8_char_skipper_parser: Is the free-form text a valid UTF-8 sequence?
+static bool is_template_text_utf8(const char *it, const char *end)
+{
+    while (it != end) {
+        unsigned char c = static_cast<unsigned char>(*it ++);
+        if ((c & 0xC0) == 0x80)
+            return false;
+        unsigned int cnt = 0;
+        for (unsigned char mask = 0x80u; c & mask; mask >>= 1)
+            ++ cnt;
+        cnt = (cnt == 0) ? 1 : ((cnt > 4) ? 4 : cnt);
+        for (-- cnt; cnt > 0; -- cnt) {
+            if (it == end)
+                return false;
+            c = static_cast<unsigned char>(*it ++);
+            if (cnt > 1 && (c & 0xC0) != 0x80)
+                return false;
+        }
+    }
+    return true;
+}
+
+static void skip_template_spaces(const std::string &templ, size_t &i)
+{
+    while (i < templ.size() && is_template_space(templ[i]))
+        ++ i;
+}
+
+// Parse an identifier starting at i, skipping the leading white spaces. Returns an empty string if there is no identifier at i.
+static std::string parse_template_identifier(const std::string &templ, size_t &i)
+{
+    skip_template_spaces(templ, i);
+    size_t begin = i;
+    if (i < templ.size() && is_identifier_start(templ[i]))
+        for (++ i; i < templ.size() && is_identifier_char(templ[i]); ++ i) ;
+    return templ.substr(begin, i - begin);
+}
+
+// Find the end of a {} block starting at templ[begin] == '{', skipping over string literals and over the regular expressions
+// following the =~ and !~ operators, which may contain a closing brace.
+// Returns the index one past the closing brace, or std::string::npos if there is none before end.
+static size_t find_template_block_end(const std::string &templ, size_t begin, size_t end)
+{
+    bool in_string = false;
+    for (size_t i = begin + 1; i < end; ++ i) {
+        char c = templ[i];
+        if (in_string) {
+            if (c == '\\')
+                ++ i;
+            else if (c == '"')
+                in_string = false;
+        } else if (c == '"')
+            in_string = true;
+        else if ((c == '=' || c == '!') && i + 1 < end && templ[i + 1] == '~') {
+            // Skip the regular expression the same way client::macro_processor::regular_expression does.
+            i += 2;
+            skip_template_spaces(templ, i);
+            if (i < end && templ[i] == '/') {
+                for (++ i; i < end && templ[i] != '/'; ++ i)
+                    if (templ[i] == '\\')
+                        ++ i;
+                if (i >= end)
+                    return std::string::npos;
+            } else
+                -- i;
+        } else if (c == '}')
+            return i + 1;
+    }
+    return std::string::npos;
+}
+
+// Keyword at the start of a {} block starting at templ[begin] == '{'. The position after the keyword is stored into end_keyword.
+static std::string template_block_keyword(const std::string &templ, size_t begin, size_t &end_keyword)
+{
+    end_keyword = begin + 1;
+    return parse_template_identifier(templ, end_keyword);
+}
+
+static bool is_template_blank(const std::string &templ, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++ i)
+        if (! is_template_space(templ[i]))
+            return false;
+    return true;
+}
+
+// Recursive descent parser of the expressions, following the rules of client::macro_processor.
+// The parse methods return false if the expression is not supported, or if it is invalid. In both cases
+// the expression is left to the boost::spirit grammar, which reports the errors.
+class ExpressionCompiler
+{
+public:
+    ExpressionCompiler(const std::string &src, size_t begin, size_t end) : m_src(src), m_pos(begin), m_end(end) {}
+
+    bool conditional(CompiledExpression &out)
+    {
+        if (! this->logical_or(out))
+            return false;
+        if (this->accept("?")) {
+            CompiledExpression cond = std::move(out);
+            out = CompiledExpression();
+            out.type = CompiledExpression::TERNARY;
+            out.args.assign(3, CompiledExpression());
+            out.args[0] = std::move(cond);
+            return this->conditional(out.args[1]) && this->accept(":") && this->conditional(out.args[2]);
+        }
+        return true;
+    }
+
+    bool additive(CompiledExpression &out)
+    {
+        if (! this->multiplicative(out))
+            return false;
+        for (;;) {
+            if (this->accept("+")) {
+                if (! this->binary(out, CompiledExpression::ADD, &ExpressionCompiler::multiplicative))
+                    return false;
+            } else if (this->accept("-")) {
+                if (! this->binary(out, CompiledExpression::SUBTRACT, &ExpressionCompiler::multiplicative))
+                    return false;
+            } else
+                return true;
+        }
+    }
+
+    // Were all the characters up to the end consumed?
+    bool at_end() { this->skip_spaces(); return m_pos == m_end; }
+
+private:
+    typedef bool (ExpressionCompiler::*ParseMethod)(CompiledExpression &out);
+
+    // Replace out with a binary operator of type over out and an expression parsed by rhs_method.
+    bool binary(CompiledExpression &out, CompiledExpression::Type type, ParseMethod rhs_method)
+    {
+        CompiledExpression lhs = std::move(out);
+        out = CompiledExpression();
+        out.type = type;
+        out.args.assign(2, CompiledExpression());
+        out.args[0] = std::move(lhs);
+        return (this->*rhs_method)(out.args[1]);
+    }
+
+    bool logical_or(CompiledExpression &out)
+    {
+        if (! this->logical_and(out))
+            return false;
+        while (this->accept_keyword("or") || this->accept("||"))
+            if (! this->binary(out, CompiledExpression::LOGICAL_OR, &ExpressionCompiler::logical_and))
+                return false;
+        return true;
+    }
+
+    bool logical_and(CompiledExpression &out)
+    {
+        if (! this->equality(out))
+            return false;
+        while (this->accept_keyword("and") || this->accept("&&"))
+            if (! this->binary(out, CompiledExpression::LOGICAL_AND, &ExpressionCompiler::equality))
+                return false;
+        return true;
+    }
+
+    bool equality(CompiledExpression &out)
+    {
+        if (! this->relational(out))
+            return false;
+        for (;;) {
+            if (this->accept("==")) {
+                if (! this->binary(out, CompiledExpression::EQUAL, &ExpressionCompiler::relational))
+                    return false;
+            } else if (this->accept("!=")) {
+                if (! this->binary(out, CompiledExpression::NOT_EQUAL, &ExpressionCompiler::relational))
+                    return false;
+            } else if (this->accept("=~")) {
+                if (! this->regex(out, CompiledExpression::REGEX_MATCHES))
+                    return false;
+            } else if (this->accept("!~")) {
+                if (! this->regex(out, CompiledExpression::REGEX_DOESNT_MATCH))
+                    return false;
+            } else
+                return true;
+        }
+    }
+
+    bool relational(CompiledExpression &out)
+    {
+        if (! this->additive(out))
+            return false;
+        for (;;) {
+            // "<>" is consumed by the grammar as '<' followed by an invalid expression.
+            if (this->peek("<>"))
+                return false;
+            if (this->accept("<=")) {
+                if (! this->binary(out, CompiledExpression::LEQ, &ExpressionCompiler::additive))
+                    return false;
+            } else if (this->accept(">=")) {
+                if (! this->binary(out, CompiledExpression::GEQ, &ExpressionCompiler::additive))
+                    return false;
+            } else if (this->accept("<")) {
+                if (! this->binary(out, CompiledExpression::LOWER, &ExpressionCompiler::additive))
+                    return false;
+            } else if (this->accept(">")) {
+                if (! this->binary(out, CompiledExpression::GREATER, &ExpressionCompiler::additive))
+                    return false;
+            } else
+                return true;
+        }
+    }
+
+    bool multiplicative(CompiledExpression &out)
+    {
+        if (! this->unary(out))
+            return false;
+        for (;;) {
+            if (this->accept("*")) {
+                if (! this->binary(out, CompiledExpression::MULTIPLY, &ExpressionCompiler::unary))
+                    return false;
+            } else if (this->accept("/")) {
+                if (! this->binary(out, CompiledExpression::DIVIDE, &ExpressionCompiler::unary))
+                    return false;
+            } else if (this->accept("%")) {
+                if (! this->binary(out, CompiledExpression::MODULO, &ExpressionCompiler::unary))
+                    return false;
+            } else
+                return true;
+        }
+    }
+
+    bool unary(CompiledExpression &out)
+    {
+        this->skip_spaces();
+        if (m_pos == m_end)
+            return false;
+        char c = m_src[m_pos];
+        if (is_identifier_start(c)) {
+            std::string name = parse_template_identifier(m_src, m_pos);
+            if (name == "true" || name == "false") {
+                out.type  = CompiledExpression::LITERAL;
+                out.value = client::expr<CompiledExpression::iterator_type>(name == "true");
+                return true;
+            }
+            if (name == "not")
+                return this->unary_op(out, CompiledExpression::NOT);
+            if (name == "min" || name == "max") {
+                out.type = name == "min" ? CompiledExpression::MIN : CompiledExpression::MAX;
+                out.args.assign(2, CompiledExpression());
+                return this->accept("(") && this->conditional(out.args[0]) && this->accept(",") && this->conditional(out.args[1]) && this->accept(")");
+            }
+            if (name == "int" || name == "round") {
+                out.type = name == "int" ? CompiledExpression::INT : CompiledExpression::ROUND;
+                out.args.assign(1, CompiledExpression());
+                return this->accept("(") && this->conditional(out.args[0]) && this->accept(")");
+            }
+            if (is_template_keyword(name))
+                return false;
+            out.text = std::move(name);
+            if (this->accept("[")) {
+                out.type = CompiledExpression::VECTOR_VARIABLE;
+                out.args.assign(1, CompiledExpression());
+                return this->additive(out.args[0]) && this->accept("]");
+            }
+            out.type = CompiledExpression::VARIABLE;
+            return true;
+        }
+        if (c == '(') {
+            ++ m_pos;
+            return this->conditional(out) && this->accept(")");
+        }
+        if (c == '-') {
+            ++ m_pos;
+            return this->unary_op(out, CompiledExpression::UNARY_MINUS);
+        }
+        if (c == '+') {
+            ++ m_pos;
+            return this->unary(out);
+        }
+        if (c == '!') {
+            ++ m_pos;
+            return this->unary_op(out, CompiledExpression::NOT);
+        }
+        if (c == '"') {
+            size_t begin = m_pos;
+            for (++ m_pos; m_pos < m_end && m_src[m_pos] != '"'; ++ m_pos)
+                if (m_src[m_pos] == '\\')
+                    ++ m_pos;
+            if (m_pos >= m_end || ! this->is_ascii(begin, m_pos))
+                return false;
+            ++ m_pos;
+            // Escape sequences are kept verbatim, as done by the grammar.
+            out.type  = CompiledExpression::LITERAL;
+            out.value = client::expr<CompiledExpression::iterator_type>(m_src.substr(begin + 1, m_pos - begin - 2));
+            return true;
+        }
+        if ((c >= '0' && c <= '9') || c == '.') {
+            // Use the very same number parsers as the grammar to get bit identical values.
+            const char *first = m_src.data() + m_pos;
+            const char *last  = m_src.data() + m_end;
+            const char *it    = first;
+            double      d;
+            int         i;
+            qi::real_parser<double, client::strict_real_policies_without_nan_inf> strict_double;
+            if (qi::parse(it, last, strict_double, d))
+                out.value = client::expr<CompiledExpression::iterator_type>(d);
+            else {
+                it = first;
+                if (! qi::parse(it, last, qi::int_, i))
+                    return false;
+                out.value = client::expr<CompiledExpression::iterator_type>(i);
+            }
+            out.type = CompiledExpression::LITERAL;
+            m_pos   += it - first;
+            return true;
+        }
+        return false;
+    }
+
+    bool unary_op(CompiledExpression &out, CompiledExpression::Type type)
+    {
+        out.type = type;
+        out.args.assign(1, CompiledExpression());
+        return this->unary(out.args[0]);
+    }
+
+    bool regex(CompiledExpression &out, CompiledExpression::Type type)
+    {
+        CompiledExpression lhs = std::move(out);
+        out = CompiledExpression();
+        out.type = type;
+        out.args.emplace_back(std::move(lhs));
+        this->skip_spaces();
+        if (m_pos == m_end || m_src[m_pos] != '/')
+            return false;
+        size_t begin = m_pos;
+        for (++ m_pos; m_pos < m_end && m_src[m_pos] != '/'; ++ m_pos)
+            if (m_src[m_pos] == '\\')
+                ++ m_pos;
+        if (m_pos >= m_end || ! this->is_ascii(begin, m_pos))
+            return false;
+        ++ m_pos;
+        out.text = m_src.substr(begin, m_pos - begin);
+        return true;
+    }
+
+    void skip_spaces() { while (m_pos < m_end && is_template_space(m_src[m_pos])) ++ m_pos; }
+
+    bool peek(const char *token)
+    {
+        this->skip_spaces();
+        size_t len = strlen(token);
+        return m_pos + len <= m_end && m_src.compare(m_pos, len, token) == 0;
+    }
+
+    bool accept(const char *token)
+    {
+        if (! this->peek(token))
+            return false;
+        m_pos += strlen(token);
+        return true;
+    }
+
+    bool accept_keyword(const char *keyword)
+    {
+        if (! this->peek(keyword))
+            return false;
+        size_t end = m_pos + strlen(keyword);
+        if (end < m_end && is_identifier_char(m_src[end]))
+            return false;
+        m_pos = end;
+        return true;
+    }
+
+    bool is_ascii(size_t begin, size_t end) const
+    {
+        for (size_t i = begin; i < end; ++ i)
+            if (static_cast<unsigned char>(m_src[i]) >= 0x80)
+                return false;
+        return true;
+    }
+
+    const std::string &m_src;
+    size_t             m_pos;
+    size_t             m_end;
+};
+
+static bool compile_text_block(const std::string &templ, size_t begin, size_t end, std::vector<CompiledTemplate::Segment> &segments);
+
+// Compile an {if}...{elsif}...{else}...{endif} block starting at templ[begin] == '{'.
+// Returns the index one past the closing {endif}, or std::string::npos if the block could not be compiled.
+static size_t compile_if_block(const std::string &templ, size_t begin, size_t end, CompiledTemplate::Segment &segment)
+{
+    segment.type = CompiledTemplate::Segment::IF;
+    bool has_else = false;
+    for (size_t i = begin;;) {
+        size_t block_end = find_template_block_end(templ, i, end);
+        if (block_end == std::string::npos)
+            return std::string::npos;
+        size_t      end_keyword;
+        std::string keyword = template_block_keyword(templ, i, end_keyword);
+        if (keyword == "endif")
+            return is_template_blank(templ, end_keyword, block_end - 1) ? block_end : std::string::npos;
+        CompiledTemplate::Segment::Branch branch;
+        if ((keyword == "if" && i == begin) || (keyword == "elsif" && i != begin && ! has_else)) {
+            if (is_template_blank(templ, end_keyword, block_end - 1))
+                return std::string::npos;
+            branch.condition = templ.substr(end_keyword, block_end - 1 - end_keyword);
+            ExpressionCompiler compiler(branch.condition, 0, branch.condition.size());
+            branch.condition_compiled = compiler.conditional(branch.condition_expression) && compiler.at_end();
+        } else if (keyword == "else" && i != begin && ! has_else && is_template_blank(templ, end_keyword, block_end - 1))
+            has_else = true;
+        else
+            return std::string::npos;
+        // Find the {elsif}, {else} or {endif} terminating the body of this branch, skipping the nested {if} blocks.
+        size_t body_end = block_end;
+        for (int depth = 0;;) {
+            body_end = templ.find('{', body_end);
+            if (body_end == std::string::npos || body_end >= end)
+                return std::string::npos;
+            size_t next_end = find_template_block_end(templ, body_end, end);
+            if (next_end == std::string::npos)
+                return std::string::npos;
+            keyword = template_block_keyword(templ, body_end, end_keyword);
+            if (keyword == "if")
+                ++ depth;
+            else if (depth == 0 && (keyword == "elsif" || keyword == "else" || keyword == "endif"))
+                break;
+            else if (keyword == "endif")
+                -- depth;
+            body_end = next_end;
+        }
+        if (! compile_text_block(templ, block_end, body_end, branch.body))
+            return std::string::npos;
+        segment.branches.emplace_back(std::move(branch));
+        i = body_end;
+    }
+}
+
+// Compile templ[begin, end) as a sequence of free-form texts and macros.
+// Returns false if the text block could not be split into segments.
+static bool compile_text_block(const std::string &templ, size_t begin, size_t end, std::vector<CompiledTemplate::Segment> &segments)
+{
+    using Segment = CompiledTemplate::Segment;
+    for (size_t i = begin; i < end;) {
+        Segment segment;
+        char    c = templ[i];
+        if (c == '[') {
+            // [variable], [vector_variable_index] or [vector_variable[index_variable]]
+            ++ i;
+            segment.text = parse_template_identifier(templ, i);
+            if (segment.text.empty() || is_template_keyword(segment.text))
+                return false;
+            skip_template_spaces(templ, i);
+            if (i < end && templ[i] == '[') {
+                ++ i;
+                segment.index = parse_template_identifier(templ, i);
+                if (segment.index.empty() || is_template_keyword(segment.index))
+                    return false;
+                skip_template_spaces(templ, i);
+                if (i >= end || templ[i ++] != ']')
+                    return false;
+                skip_template_spaces(templ, i);
+                segment.type = Segment::LEGACY_VECTOR_VARIABLE;
+            } else
+                segment.type = Segment::LEGACY_VARIABLE;
+            if (i >= end || templ[i ++] != ']')
+                return false;
+        } else if (c == '{') {
+            size_t      end_keyword;
+            std::string keyword = template_block_keyword(templ, i, end_keyword);
+            if (keyword == "if") {
+                i = compile_if_block(templ, i, end, segment);
+                if (i == std::string::npos)
+                    return false;
+            } else if (keyword == "elsif" || keyword == "else" || keyword == "endif") {
+                // Not paired with an {if}.
+                return false;
+            } else {
+                size_t block_end = find_template_block_end(templ, i, end);
+                if (block_end == std::string::npos)
+                    return false;
+                // The grammar accepts just an additive expression at the top level of a macro.
+                ExpressionCompiler compiler(templ, i + 1, block_end - 1);
+                if (compiler.additive(segment.expression) && compiler.at_end())
+                    segment.type = Segment::EXPRESSION;
+                else {
+                    segment.type = Segment::MACRO;
+                    segment.text = templ.substr(i, block_end - i);
+                }
+                i = block_end;
+            }
+        } else {
+            // Free-form text up to a first brace.
+            size_t text_end = std::min(templ.find_first_of("[{", i), end);
+            if (! is_template_text_utf8(templ.data() + i, templ.data() + text_end))
+                return false;
+            segment.type = Segment::TEXT;
+            segment.text = templ.substr(i, text_end - i);
+            i = text_end;
+        }
+        segments.emplace_back(std::move(segment));
+    }
+    return true;
+}
+
+static std::shared_ptr<const CompiledTemplate> compile_template(const std::string &templ)
+{
+    auto   out = std::make_shared<CompiledTemplate>();
+    size_t i   = 0;
+    // The grammar skips white spaces at the start of the template.
+    skip_template_spaces(templ, i);
+    if (! compile_text_block(templ, i, templ.size(), out->segments)) {
+        out->monolithic = true;
+        out->segments.clear();
+    }
+    return out;
+}
+
+static client::expr<CompiledExpression::iterator_type> evaluate_compiled_expression(const CompiledExpression &expression, client::MyContext &context)
+{
+    typedef CompiledExpression::iterator_type    iterator_type;
+    typedef boost::iterator_range<iterator_type> range_type;
+    typedef client::expr<iterator_type>          expr_type;
+    switch (expression.type) {
+    case CompiledExpression::LITERAL:
+        return expression.value;
+    case CompiledExpression::VARIABLE:
+    case CompiledExpression::VECTOR_VARIABLE:
+    {
+        range_type                        opt_key(expression.text.begin(), expression.text.end());
+        client::OptWithPos<iterator_type> opt;
+        expr_type                         out;
+        client::MyContext::resolve_variable<iterator_type>(&context, opt_key, opt);
+        if (expression.type == CompiledExpression::VARIABLE)
+            client::MyContext::scalar_variable_reference<iterator_type>(&context, opt, out);
+        else {
+            expr_type index_expr = evaluate_compiled_expression(expression.args.front(), context);
+            int       index;
+            client::MyContext::evaluate_index<iterator_type>(index_expr, index);
+            client::MyContext::vector_variable_reference<iterator_type>(&context, opt, index, expression.text.end(), out);
+        }
+        return out;
+    }
+    case CompiledExpression::UNARY_MINUS:
+    case CompiledExpression::NOT:
+    case CompiledExpression::INT:
+    case CompiledExpression::ROUND:
+    {
+        expr_type arg = evaluate_compiled_expression(expression.args.front(), context);
+        iterator_type start_pos = arg.it_range.begin();
+        return expression.type == CompiledExpression::UNARY_MINUS ? arg.unary_minus(start_pos) :
+               expression.type == CompiledExpression::NOT         ? arg.unary_not(start_pos) :
+               expression.type == CompiledExpression::INT         ? arg.unary_integer(start_pos) : arg.round(start_pos);
+    }
+    case CompiledExpression::REGEX_MATCHES:
+    case CompiledExpression::REGEX_DOESNT_MATCH:
+    {
+        expr_type  out = evaluate_compiled_expression(expression.args.front(), context);
+        range_type regex(expression.text.begin(), expression.text.end());
+        if (expression.type == CompiledExpression::REGEX_MATCHES)
+            expr_type::regex_matches(out, regex);
+        else
+            expr_type::regex_doesnt_match(out, regex);
+        return out;
+    }
+    case CompiledExpression::TERNARY:
+    {
+        // Both alternatives are evaluated by the grammar.
+        expr_type out  = evaluate_compiled_expression(expression.args[0], context);
+        expr_type rhs1 = evaluate_compiled_expression(expression.args[1], context);
+        expr_type rhs2 = evaluate_compiled_expression(expression.args[2], context);
+        expr_type::ternary_op(out, rhs1, rhs2);
+        return out;
+    }
+    default:
+        break;
+    }
+    // Binary operators. Both operands are always evaluated, there is no short circuit evaluation in the grammar.
+    expr_type out = evaluate_compiled_expression(expression.args[0], context);
+    expr_type rhs = evaluate_compiled_expression(expression.args[1], context);
+    switch (expression.type) {
+    case CompiledExpression::ADD:           out += rhs; break;
+    case CompiledExpression::SUBTRACT:      out -= rhs; break;
+    case CompiledExpression::MULTIPLY:      out *= rhs; break;
+    case CompiledExpression::DIVIDE:        out /= rhs; break;
+    case CompiledExpression::MODULO:        out %= rhs; break;
+    case CompiledExpression::EQUAL:         expr_type::equal(out, rhs); break;
+    case CompiledExpression::NOT_EQUAL:     expr_type::not_equal(out, rhs); break;
+    case CompiledExpression::LOWER:         expr_type::lower(out, rhs); break;
+    case CompiledExpression::GREATER:       expr_type::greater(out, rhs); break;
+    case CompiledExpression::LEQ:           expr_type::leq(out, rhs); break;
+    case CompiledExpression::GEQ:           expr_type::geq(out, rhs); break;
+    case CompiledExpression::LOGICAL_AND:   expr_type::logical_and(out, rhs); break;
+    case CompiledExpression::LOGICAL_OR:    expr_type::logical_or(out, rhs); break;
+    case CompiledExpression::MIN:           expr_type::min(out, rhs); break;
+    case CompiledExpression::MAX:           expr_type::max(out, rhs); break;
+    default:                                assert(false);
+    }
+    return out;
+}
+
+static bool evaluate_template_condition(const CompiledTemplate::Segment::Branch &branch, client::MyContext &context)
+{
+    if (branch.condition_compiled) {
+        client::expr<CompiledExpression::iterator_type> value = evaluate_compiled_expression(branch.condition_expression, context);
+        bool result;
+        client::expr<CompiledExpression::iterator_type>::evaluate_boolean(value, result);
+        return result;
+    }
+    context.just_boolean_expression = true;
+    bool result = process_macro(branch.condition, context) == "true";
+    context.just_boolean_expression = false;
+    return result;
+}
+
+static std::string process_template_segments(const std::vector<CompiledTemplate::Segment> &segments, client::MyContext &context)
+{
+    typedef CompiledExpression::iterator_type    iterator_type;
+    typedef boost::iterator_range<iterator_type> range_type;
+    std::string output;
+    for (const CompiledTemplate::Segment &segment : segments) {
+        switch (segment.type) {
+        case CompiledTemplate::Segment::TEXT:
+            output += segment.text;
+            break;
+        case CompiledTemplate::Segment::LEGACY_VARIABLE:
+        {
+            range_type  opt_key(segment.text.begin(), segment.text.end());
+            std::string value;
+            client::MyContext::legacy_variable_expansion<iterator_type>(&context, opt_key, value);
+            output += value;
+            break;
+        }
+        case CompiledTemplate::Segment::LEGACY_VECTOR_VARIABLE:
+        {
+            range_type  opt_key(segment.text.begin(), segment.text.end());
+            range_type  opt_index(segment.index.begin(), segment.index.end());
+            std::string value;
+            client::MyContext::legacy_variable_expansion2<iterator_type>(&context, opt_key, opt_index, value);
+            output += value;
+            break;
+        }
+        case CompiledTemplate::Segment::EXPRESSION:
+            output += evaluate_compiled_expression(segment.expression, context).to_string();
+            break;
+        case CompiledTemplate::Segment::IF:
+        {
+            // Like the grammar, evaluate all the conditions and all the branches, so that the same errors are reported.
+            bool        matched = false;
+            std::string value;
+            for (const CompiledTemplate::Segment::Branch &branch : segment.branches) {
+                bool        condition = branch.condition.empty() || evaluate_template_condition(branch, context);
+                std::string body      = process_template_segments(branch.body, context);
+                if (condition && ! matched) {
+                    value   = std::move(body);
+                    matched = true;
+                }
+            }
+            output += value;
+            break;
+        }
+        case CompiledTemplate::Segment::MACRO:
+            output += process_macro(segment.text, context);
+            break;
+        }
+    }
+    return output;
+}
+
+// Cache of compiled templates, shared by all PlaceholderParser instances.
+// Custom G-code templates are processed repeatedly (for each layer change, each tool change ...),
+// while there are just a few of them.
+class CompiledTemplateCache
+{
+public:
+    std::shared_ptr<const CompiledTemplate> get(const std::string &templ)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_cache.find(templ);
+            if (it != m_cache.end())
+                return it->second;
+        }
+        // Compile outside of the lock.
+        std::shared_ptr<const CompiledTemplate> compiled = compile_template(templ);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Don't let the cache grow indefinitely if the templates are edited interactively.
+        if (m_cache.size() >= max_size)
+            m_cache.clear();
+        return m_cache.emplace(templ, std::move(compiled)).first->second;
+    }
+
+private:
+    static constexpr size_t max_size = 1024;
+
+    std::mutex                                                               m_mutex;
+    std::unordered_map<std::string, std::shared_ptr<const CompiledTemplate>> m_cache;
+};
+
+static CompiledTemplateCache s_compiled_template_cache;
+
 std::string PlaceholderParser::process(const std::string &templ, unsigned int current_extruder_id, const DynamicConfig *config_override, ContextData *context_data) const
+{
+    client::MyContext context;
+    context.external_config 	= this->external_config();
+    context.config              = &this->config();
+    context.config_override     = config_override;
+    context.current_extruder_id = current_extruder_id;
+    context.context_data        = context_data;
+
+    std::shared_ptr<const CompiledTemplate> compiled = s_compiled_template_cache.get(templ);
+    if (compiled->monolithic)
+        return process_macro(templ, context);
+    try {
+        return process_template_segments(compiled->segments, context);
+    } catch (const std::exception &ex) {
+        // The segments throw the qi::expectation_failure of the MyContext helpers unformatted, and the errors of the segments
+        // handed over to process_macro() refer to the segment text only. Run the grammar over the whole template to throw
+        // the PlaceholderParserError with the same message as before the templates were compiled. The grammar runs
+        // on a copy of the context data, so that the random generator of the caller is not advanced twice.
+        std::optional<ContextData> context_data_copy;
+        if (context_data != nullptr)
+            context_data_copy = *context_data;
+        this->process_uncached(templ, current_extruder_id, config_override, context_data_copy ? &*context_data_copy : nullptr);
+        // The grammar succeeded, as the failed expression depended on the state of the random generator.
+        throw Slic3r::PlaceholderParserError(ex.what());
+    }
+}
+
+std::string PlaceholderParser::process_uncached(const std::string &templ, unsigned int current_extruder_id, const DynamicConfig *config_override, ContextData *context_data) const
 {
     client::MyContext context;
     context.external_config 	= this->external_config();
@@ -51,8 +51,13 @@ public:
 	const DynamicConfig*	external_config() const  			{ return m_external_config; }
 
     // Fill in the template using a macro processing language.
+    // The template is parsed once and cached by its text, repeated calls only evaluate the cached template
+    // against the current configuration.
     // Throws Slic3r::PlaceholderParserError on syntax or runtime error.
     std::string process(const std::string &templ, unsigned int current_extruder_id = 0, const DynamicConfig *config_override = nullptr, ContextData *context = nullptr) const;
+    // Fill in the template by running the macro processing grammar over the whole template, bypassing the cache of compiled templates.
+    // Produces the same output as process(), to verify the compiled templates against the grammar.
+    std::string process_uncached(const std::string &templ, unsigned int current_extruder_id = 0, const DynamicConfig *config_override = nullptr, ContextData *context = nullptr) const;
     
     // Evaluate a boolean expression using the full expressive power of the PlaceholderParser boolean expression syntax.
     // Throws Slic3r::PlaceholderParserError on syntax or runtime error.
@@ -22,6 +22,8 @@
 #include <boost/locale.hpp>
 #include <boost/log/trivial.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
 
 // Store the print/filament/printer presets into a "presets" subdirectory of the Slic3rPE config dir.
 // This breaks compatibility with the upstream Slic3r if the --datadir is used to switch between the two versions.
@@ -2393,8 +2395,6 @@ void PresetBundle::load_config_file_config(const std::string &name_or_path, bool
 std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_from_json(
     const std::string &path, const std::string &vendor_name, LoadConfigBundleAttributes flags, ForwardCompatibilitySubstitutionRule compatibility_rule)
 {
-    // Enable substitutions for user config bundle, throw an exception when loading a system profile.
-    ConfigSubstitutionContext  substitution_context { compatibility_rule };
     PresetsConfigSubstitutions substitutions;
     std::string vendor_system_path = data_dir() + "/" + PRESET_SYSTEM_DIR;
 
@@ -2590,11 +2590,56 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
     PresetCollection         *presets = nullptr;
     size_t                   presets_loaded = 0;
 
+    // The json subfiles of a vendor do not depend on each other until their "inherits" are resolved,
+    // thus they are parsed in parallel first. Exceptions are kept to be rethrown in the order the files are loaded.
+    struct ParsedSubfile {
+        DynamicPrintConfig                  config;
+        std::map<std::string, std::string>  key_values;
+        ConfigSubstitutions                 substitutions;
+        std::string                         reason;
+        std::exception_ptr                  exception;
+    };
+    auto parse_subfiles = [&path, &vendor_name, compatibility_rule](const std::vector<std::pair<std::string, std::string>> &subfiles) {
+        std::vector<ParsedSubfile> parsed(subfiles.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, subfiles.size()), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                std::string    subfile = path + "/" + vendor_name + "/" + subfiles[i].second;
+                ParsedSubfile &out     = parsed[i];
+                try {
+                    // Enable substitutions for user config bundle, throw an exception when loading a system profile.
+                    ConfigSubstitutionContext substitution_context { compatibility_rule };
+                    out.config.load_from_json(subfile, substitution_context, false, out.key_values, out.reason);
+                    if (! out.reason.empty())
+                        BOOST_LOG_TRIVIAL(error) << __FUNCTION__<< ": load config file "<<subfile<<" Failed!";
+                    out.substitutions = std::move(substitution_context.substitutions);
+                } catch (nlohmann::detail::parse_error &err) {
+                    BOOST_LOG_TRIVIAL(error) << __FUNCTION__<< ": parse "<< subfile <<" got a nlohmann::detail::parse_error, reason = " << err.what();
+                    out.reason = std::string("json parse error") + err.what();
+                } catch (...) {
+                    out.exception = std::current_exception();
+                }
+            }
+        });
+        return parsed;
+    };
+
+    // Order the subfiles so that a preset is resolved after the preset it inherits from.
+    auto dependency_order = [](const std::vector<ParsedSubfile> &parsed) {
+        std::vector<std::pair<std::string, std::string>> names_inherits(parsed.size());
+        for (size_t i = 0; i < parsed.size(); ++ i) {
+            if (auto it = parsed[i].key_values.find(BBL_JSON_KEY_NAME); it != parsed[i].key_values.end())
+                names_inherits[i].first = it->second;
+            if (auto it = parsed[i].key_values.find(BBL_JSON_KEY_INHERITS); it != parsed[i].key_values.end())
+                names_inherits[i].second = it->second;
+        }
+        return PresetBundle::vendor_presets_dependency_order(names_inherits);
+    };
+
     auto parse_subfile = [path, vendor_name, presets_loaded, current_vendor_profile](\
-        ConfigSubstitutionContext& substitution_context,
         PresetsConfigSubstitutions& substitutions,
         LoadConfigBundleAttributes& flags,
         std::pair<std::string, std::string>& subfile_iter,
+        ParsedSubfile& parsed,
         std::map<std::string, DynamicPrintConfig>& config_maps,
         std::map<std::string, std::string>& filament_id_maps,
         PresetCollection* presets_collection,
@@ -2608,17 +2653,13 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
         std::vector<std::string>  renamed_from;
         const DynamicPrintConfig* default_config = nullptr;
         std::string               reason;
-        try {
-            std::map<std::string, std::string> key_values;
-            substitution_context.substitutions.clear();
-
-            //parse the json elements
-            DynamicPrintConfig config_src;
-            config_src.load_from_json(subfile, substitution_context, false, key_values, reason);
-            if (!reason.empty()) {
-                BOOST_LOG_TRIVIAL(error) << __FUNCTION__<< ": load config file "<<subfile<<" Failed!";
-                return reason;
-            }
+        if (parsed.exception)
+            std::rethrow_exception(parsed.exception);
+        if (! parsed.reason.empty())
+            return parsed.reason;
+        {
+            std::map<std::string, std::string> &key_values = parsed.key_values;
+            const DynamicPrintConfig           &config_src = parsed.config;
             preset_name = key_values[BBL_JSON_KEY_NAME];
             instantiation = key_values[BBL_JSON_KEY_INSTANTIATION];
             auto setting_it = key_values.find(BBL_JSON_KEY_SETTING_ID);
@@ -2670,11 +2711,6 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
             }
             Preset::normalize(config);
         }
-        catch(nlohmann::detail::parse_error &err) {
-            BOOST_LOG_TRIVIAL(error) << __FUNCTION__<< ": parse "<< subfile <<" got a nlohmann::detail::parse_error, reason = " << err.what();
-            reason = std::string("json parse error") + err.what();
-            return reason;
-        }
 
         // Report configuration fields, which are misplaced into a wrong group.
         std::string incorrect_keys = Preset::remove_invalid_keys(config, *default_config);
@@ -2762,10 +2798,10 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
         else
             loaded.alias = std::move(alias_name);
         loaded.renamed_from = std::move(renamed_from);
-        if (! substitution_context.empty())
+        if (! parsed.substitutions.empty())
             substitutions.push_back({
                 preset_name, presets_collection->type(), PresetConfigSubstitutions::Source::ConfigBundle,
-                std::string(), std::move(substitution_context.substitutions) });
+                std::string(), std::move(parsed.substitutions) });
         config_maps.emplace(preset_name, loaded.config);
         ++count;
         //BBS: add config related logs
@@ -2773,15 +2809,22 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
         return reason;
     };
 
+    std::vector<ParsedSubfile> parsed_process, parsed_filament, parsed_machine;
+    tbb::parallel_invoke(
+        [&]() { parsed_process  = parse_subfiles(process_subfiles); },
+        [&]() { parsed_filament = parse_subfiles(filament_subfiles); },
+        [&]() { parsed_machine  = parse_subfiles(machine_subfiles); });
+
     std::map<std::string, DynamicPrintConfig> configs;
     std::map<std::string, std::string> filament_id_maps;
     //3.1) paste the process
     presets = &this->prints;
     configs.clear();
     filament_id_maps.clear();
-    for (auto& subfile : process_subfiles)
+    for (size_t idx : dependency_order(parsed_process))
     {
-        std::string reason = parse_subfile(substitution_context, substitutions, flags, subfile, configs, filament_id_maps, presets, presets_loaded);
+        auto &subfile = process_subfiles[idx];
+        std::string reason = parse_subfile(substitutions, flags, subfile, parsed_process[idx], configs, filament_id_maps, presets, presets_loaded);
         if (!reason.empty()) {
             //parse error
             std::string subfile_path = path + "/" + vendor_name + "/" + subfile.second;
@@ -2794,9 +2837,10 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
     presets = &this->filaments;
     configs.clear();
     filament_id_maps.clear();
-    for (auto& subfile : filament_subfiles)
+    for (size_t idx : dependency_order(parsed_filament))
     {
-        std::string reason = parse_subfile(substitution_context, substitutions, flags, subfile, configs, filament_id_maps, presets, presets_loaded);
+        auto &subfile = filament_subfiles[idx];
+        std::string reason = parse_subfile(substitutions, flags, subfile, parsed_filament[idx], configs, filament_id_maps, presets, presets_loaded);
         if (!reason.empty()) {
             //parse error
             std::string subfile_path = path + "/" + vendor_name + "/" + subfile.second;
@@ -2809,9 +2853,10 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
     presets = &this->printers;
     configs.clear();
     filament_id_maps.clear();
-    for (auto& subfile : machine_subfiles)
+    for (size_t idx : dependency_order(parsed_machine))
     {
-        std::string reason = parse_subfile(substitution_context, substitutions, flags, subfile, configs, filament_id_maps, presets, presets_loaded);
+        auto &subfile = machine_subfiles[idx];
+        std::string reason = parse_subfile(substitutions, flags, subfile, parsed_machine[idx], configs, filament_id_maps, presets, presets_loaded);
         if (!reason.empty()) {
             //parse error
             std::string subfile_path = path + "/" + vendor_name + "/" + subfile.second;
@@ -2825,6 +2870,38 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_vendor_configs_
     return std::make_pair(std::move(substitutions), presets_loaded);
 }
 
+std::vector<size_t> PresetBundle::vendor_presets_dependency_order(const std::vector<std::pair<std::string, std::string>> &names_inherits)
+{
+    std::map<std::string, size_t> name_to_idx;
+    for (size_t i = 0; i < names_inherits.size(); ++ i)
+        if (! names_inherits[i].first.empty())
+            name_to_idx.emplace(names_inherits[i].first, i);
+    std::vector<size_t> order;
+    order.reserve(names_inherits.size());
+    // 0: not visited, 1: being visited, 2: ordered
+    std::vector<char>   state(names_inherits.size(), 0);
+    std::vector<size_t> stack;
+    for (size_t i = 0; i < names_inherits.size(); ++ i) {
+        // Walk up the chain of parents, then emit it top down.
+        for (size_t idx = i; state[idx] == 0;) {
+            state[idx] = 1;
+            stack.emplace_back(idx);
+            if (names_inherits[idx].second.empty())
+                break;
+            auto it_parent = name_to_idx.find(names_inherits[idx].second);
+            if (it_parent == name_to_idx.end())
+                break;
+            // A cycle ends at a preset being visited, its inherits will not be found.
+            idx = it_parent->second;
+        }
+        for (; ! stack.empty(); stack.pop_back()) {
+            state[stack.back()] = 2;
+            order.emplace_back(stack.back());
+        }
+    }
+    return order;
+}
+
 void PresetBundle::update_multi_material_filament_presets()
 {
     if (printers.get_edited_preset().printer_technology() != ptFFF)
@@ -157,6 +157,11 @@ public:
     //BBS: add json related logic
     std::pair<PresetsConfigSubstitutions, size_t> load_vendor_configs_from_json(
         const std::string &path, const std::string &vendor_name, LoadConfigBundleAttributes flags, ForwardCompatibilitySubstitutionRule compatibility_rule);
+    // Order the presets of a vendor, given by their names and the names of the presets they inherit from (empty if none),
+    // so that a preset is resolved after the preset it inherits from. The order of the vendor profile is kept where
+    // it already satisfies the dependencies. Parents not in the list are ignored, a cycle is broken where it was entered.
+    // Returns indices into names_inherits, each index exactly once.
+    static std::vector<size_t>  vendor_presets_dependency_order(const std::vector<std::pair<std::string, std::string>> &names_inherits);
 
     // Export a config bundle file containing all the presets and the names of the active presets.
     //void                        export_configbundle(const std::string &path, bool export_system_settings = false, bool export_physical_printers = false);
@@ -19,7 +19,9 @@
 
 #include <Eigen/Geometry>
 
+#include <array>
 #include <functional>
+#include <optional>
 #include <set>
 
 namespace Slic3r {
@@ -418,12 +420,21 @@ private:
     PrintBase::ApplyStatus  set_instances(PrintInstances &&instances);
     // Invalidates the step, and its depending steps in PrintObject and Print.
     bool                    invalidate_step(PrintObjectStep step);
+    // Invalidates the step and its depending steps just for the layers sliced inside z_range (in the coordinates of the layer height ranges).
+    // The steps processing the layers independently will only be recalculated for these layers, see invalidated_layers().
+    bool                    invalidate_step(PrintObjectStep step, const t_layer_height_range &z_range);
     // Invalidates all PrintObject and Print steps.
     bool                    invalidate_all_steps();
+    bool                    invalidate_step_and_depending_steps(PrintObjectStep step);
     // Invalidate steps based on a set of parameters changed.
     // It may be called for both the PrintObjectConfig and PrintRegionConfig.
+    // If z_range is provided, the parameters changed just for the layers sliced inside z_range,
+    // for example for a region of a layer height range or of a modifier volume.
     bool                    invalidate_state_by_config_options(
-        const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys);
+        const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys,
+        const t_layer_height_range *z_range = nullptr);
+    // Range of indices of m_layers to be (re)calculated by a step: all layers, or just the layers sliced inside the z range the step was invalidated for.
+    std::pair<size_t, size_t> invalidated_layers(PrintObjectStep step) const;
     // If ! m_slicing_params.valid, recalculate.
     void                    update_slicing_parameters();
 
@@ -449,6 +460,8 @@ private:
     void discover_horizontal_shells();
     void combine_infill();
     void _generate_support_material();
+    // Release the lower slice data cached by Layer::support_map() once the steps querying it are finished.
+    void clear_support_maps();
     std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> prepare_adaptive_infill_data();
 
     // BBS
@@ -479,6 +492,11 @@ private:
     // this is set to true when LayerRegion->slices is split in top/internal/bottom
     // so that next call to make_perimeters() performs a union() before computing loops
     bool                    				m_typed_slices = false;
+    // Z ranges of the layers a step was invalidated for by invalidate_step(step, z_range), or empty if the step is to be calculated for all layers.
+    std::array<std::optional<t_layer_height_range>, posCount> m_invalidated_z_ranges;
+    // Hashes of the fill surfaces of the layers produced by prepare_infill(), to find the layers with fill surfaces modified
+    // by a partial invalidation of the layers above or below, for example due to the top / bottom shells.
+    std::vector<size_t>                     m_fill_surfaces_hashes;
     std::vector < VolumeSlices >            firstLayerObjSliceByVolume;
     std::vector<groupedVolumeSlices>        firstLayerObjSliceByGroups;
     // BBS: per object skirt
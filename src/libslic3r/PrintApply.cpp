@@ -218,14 +218,17 @@ static t_config_option_keys print_config_diffs(
     const std::vector<std::string> &extruder_retract_keys = print_config_def.extruder_retract_keys();
     const std::string               filament_prefix       = "filament_";
     t_config_option_keys            print_diff;
-    for (const t_config_option_key &opt_key : current_config.keys()) {
-        const ConfigOption *opt_old = current_config.option(opt_key);
-        assert(opt_old != nullptr);
-        const ConfigOption *opt_new = new_full_config.option(opt_key);
-        // assert(opt_new != nullptr);
-        if (opt_new == nullptr)
+    // Both current_config.keys_ref() and new_full_config are sorted by key, walk them in lockstep.
+    auto                            it_new                = new_full_config.cbegin();
+    for (const t_config_option_key &opt_key : current_config.keys_ref()) {
+        while (it_new != new_full_config.cend() && it_new->first < opt_key)
+            ++ it_new;
+        if (it_new == new_full_config.cend() || it_new->first != opt_key)
             //FIXME This may happen when executing some test cases.
             continue;
+        const ConfigOption *opt_old = current_config.option(opt_key);
+        assert(opt_old != nullptr);
+        const ConfigOption *opt_new = it_new->second.get();
         const ConfigOption *opt_new_filament = std::binary_search(extruder_retract_keys.begin(), extruder_retract_keys.end(), opt_key) ? new_full_config.option(filament_prefix + opt_key) : nullptr;
         if (opt_new_filament != nullptr && ! opt_new_filament->is_nil()) {
             // An extruder retract override is available at some of the filament presets.
@@ -270,9 +273,14 @@ static t_config_option_keys print_config_diffs(
 static t_config_option_keys full_print_config_diffs(const DynamicPrintConfig &current_full_config, const DynamicPrintConfig &new_full_config, int plate_index)
 {
     t_config_option_keys full_config_diff;
-    for (const t_config_option_key &opt_key : new_full_config.keys()) {
-        const ConfigOption *opt_old = current_full_config.option(opt_key);
-        const ConfigOption *opt_new = new_full_config.option(opt_key);
+    // Both configs are sorted by key, walk them in lockstep.
+    auto it_old = current_full_config.cbegin();
+    for (auto it_new = new_full_config.cbegin(); it_new != new_full_config.cend(); ++ it_new) {
+        const t_config_option_key &opt_key = it_new->first;
+        while (it_old != current_full_config.cend() && it_old->first < opt_key)
+            ++ it_old;
+        const ConfigOption *opt_old = it_old != current_full_config.cend() && it_old->first == opt_key ? it_old->second.get() : nullptr;
+        const ConfigOption *opt_new = it_new->second.get();
         if (opt_old == nullptr || *opt_new != *opt_old) {
             //BBS: add plate_index logic for wipe_tower_x/wipe_tower_y
             if (opt_old && (!opt_key.compare("wipe_tower_x") || !opt_key.compare("wipe_tower_y"))) {
@@ -682,12 +690,41 @@ PrintObjectRegions::BoundingBox find_modifier_volume_extents(const PrintObjectRe
 
 PrintRegionConfig region_config_from_model_volume(const PrintRegionConfig &default_or_parent_region_config, const DynamicPrintConfig *layer_range_config, const ModelVolume &volume, size_t num_extruders);
 
+// Z span of the layers, which may contain a PrintRegion: the layer ranges referencing the region clipped by the extents
+// of the ModelVolumes producing the region.
+static t_layer_height_range print_region_z_span(const PrintObjectRegions &print_object_regions, const PrintRegion &region)
+{
+    t_layer_height_range out(DBL_MAX, - DBL_MAX);
+    auto extend = [&out](const PrintObjectRegions::LayerRangeRegions &layer_range, const ModelVolume &model_volume) {
+        t_layer_height_range span = layer_range.layer_height_range;
+        if (const PrintObjectRegions::BoundingBox *bbox = find_volume_extents(layer_range, model_volume); bbox) {
+            span.first  = std::max(span.first,  coordf_t(bbox->min().z()));
+            span.second = std::min(span.second, coordf_t(bbox->max().z()));
+        }
+        out.first  = std::min(out.first,  span.first);
+        out.second = std::max(out.second, span.second);
+    };
+    for (const PrintObjectRegions::LayerRangeRegions &layer_range : print_object_regions.layer_ranges) {
+        for (const PrintObjectRegions::VolumeRegion &volume_region : layer_range.volume_regions)
+            if (volume_region.region == &region)
+                extend(layer_range, *volume_region.model_volume);
+        for (const PrintObjectRegions::PaintedRegion &painted_region : layer_range.painted_regions)
+            if (painted_region.region == &region)
+                extend(layer_range, *layer_range.volume_regions[painted_region.parent].model_volume);
+    }
+    if (out.first > out.second)
+        // Not referenced, let the region cover the whole object.
+        out = t_layer_height_range(- DBL_MAX, DBL_MAX);
+    return out;
+}
+
 void print_region_ref_inc(PrintRegion &r) { ++ r.m_ref_cnt; }
 void print_region_ref_reset(PrintRegion &r) { r.m_ref_cnt = 0; }
 int  print_region_ref_cnt(const PrintRegion &r) { return r.m_ref_cnt; }
 
 // Verify whether the PrintRegions of a PrintObject are still valid, possibly after updating the region configs.
 // Before region configs are updated, callback_invalidate() is called to possibly stop background processing.
+// callback_invalidate() receives the z span of the layers, which may contain the modified region.
 // Returns false if this object needs to be resliced because regions were merged or split.
 bool verify_update_print_object_regions(
     ModelVolumePtrs                     model_volumes,
@@ -695,7 +732,7 @@ bool verify_update_print_object_regions(
     size_t                              num_extruders,
     const std::vector<unsigned int>    &painting_extruders,
     PrintObjectRegions                 &print_object_regions,
-    const std::function<void(const PrintRegionConfig&, const PrintRegionConfig&, const t_config_option_keys&)> &callback_invalidate)
+    const std::function<void(const PrintRegionConfig&, const PrintRegionConfig&, const t_config_option_keys&, const t_layer_height_range&)> &callback_invalidate)
 {
     // Sort by ModelVolume ID.
     model_volumes_sort_by_id(model_volumes);
@@ -756,7 +793,7 @@ bool verify_update_print_object_regions(
                         // Region is referenced for the first time. Just change its parameters.
                         // Stop the background process before assigning new configuration to the regions.
                         t_config_option_keys diff = region.region->config().diff(cfg);
-                        callback_invalidate(region.region->config(), cfg, diff);
+                        callback_invalidate(region.region->config(), cfg, diff, print_region_z_span(print_object_regions, *region.region));
                         region.region->config_apply_only(cfg, diff, false);
                     } else {
                         // Region is referenced multiple times, thus the region is being split. We need to reslice.
@@ -781,7 +818,7 @@ bool verify_update_print_object_regions(
                     // Region is referenced for the first time. Just change its parameters.
                     // Stop the background process before assigning new configuration to the regions.
                     t_config_option_keys diff = region.region->config().diff(cfg);
-                    callback_invalidate(region.region->config(), cfg, diff);
+                    callback_invalidate(region.region->config(), cfg, diff, print_region_z_span(print_object_regions, *region.region));
                     region.region->config_apply_only(cfg, diff, false);
                 } else {
                     // Region is referenced multiple times, thus the region is being split. We need to reslice.
@@ -1029,8 +1066,8 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
     t_config_option_keys print_diff       = print_config_diffs(m_config, new_full_config, filament_overrides, this->m_plate_index);
     t_config_option_keys full_config_diff = full_print_config_diffs(m_full_print_config, new_full_config, this->m_plate_index);
     // Collect changes to object and region configs.
-    t_config_option_keys object_diff      = m_default_object_config.diff(new_full_config);
-    t_config_option_keys region_diff      = m_default_region_config.diff(new_full_config);
+    t_config_option_keys object_diff      = m_default_object_config.diff_dynamic(new_full_config);
+    t_config_option_keys region_diff      = m_default_region_config.diff_dynamic(new_full_config);
 
     // Do not use the ApplyStatus as we will use the max function when updating apply_status.
     unsigned int apply_status = APPLY_STATUS_UNCHANGED;
@@ -1441,10 +1478,11 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
                     num_extruders ,
                     painting_extruders,
                     *print_object_regions,
-                    [it_print_object, it_print_object_end, &update_apply_status](const PrintRegionConfig &old_config, const PrintRegionConfig &new_config, const t_config_option_keys &diff_keys) {
+                    [it_print_object, it_print_object_end, &update_apply_status](const PrintRegionConfig &old_config, const PrintRegionConfig &new_config, const t_config_option_keys &diff_keys, const t_layer_height_range &z_span) {
+                        // Only the layers of the modified region need to be recalculated by the steps processing the layers independently.
                         for (auto it = it_print_object; it != it_print_object_end; ++it)
                             if ((*it)->m_shared_regions != nullptr)
-                                update_apply_status((*it)->invalidate_state_by_config_options(old_config, new_config, diff_keys));
+                                update_apply_status((*it)->invalidate_state_by_config_options(old_config, new_config, diff_keys, &z_span));
                     })) {
                 // Regions are valid, just keep them.
             } else {
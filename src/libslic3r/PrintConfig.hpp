@@ -27,6 +27,8 @@
 #include <boost/preprocessor/tuple/elem.hpp>
 #include <boost/preprocessor/tuple/to_seq.hpp>
 
+#include <unordered_map>
+
 // #define HAS_PRESSURE_EQUALIZER
 
 namespace Slic3r {
@@ -362,7 +364,8 @@ protected:
         }
 
     protected:
-        std::map<std::string, ptrdiff_t>    m_map_name_to_offset;
+        // Hashed, as the lookup by name is performed for every option access by name, see optptr().
+        std::unordered_map<std::string, ptrdiff_t> m_map_name_to_offset;
     };
 
     // Parametrized by the type of the topmost class owning the options.
@@ -391,6 +394,27 @@ protected:
         const std::vector<std::string>& keys()      const { return m_keys; }
         const T&                        defaults()  const { return *m_defaults; }
 
+        // Returns options of owner differing from a DynamicConfig, ignoring options not present in both configs.
+        // Both m_keys and the DynamicConfig keys are sorted, thus they are walked in lockstep
+        // and the options of owner are accessed by their offsets without any lookup by name.
+        t_config_option_keys            diff(const T *owner, const DynamicConfig &other) const
+        {
+            t_config_option_keys out;
+            size_t i = 0;
+            for (auto it_other = other.cbegin(); i < m_keys.size() && it_other != other.cend();)
+                if (int cmp = m_keys[i].compare(it_other->first); cmp < 0)
+                    ++ i;
+                else if (cmp > 0)
+                    ++ it_other;
+                else {
+                    if (*reinterpret_cast<const ConfigOption*>((const char*)owner + m_offsets[i]) != *it_other->second)
+                        out.emplace_back(m_keys[i]);
+                    ++ i;
+                    ++ it_other;
+                }
+            return out;
+        }
+
         // To be called during the StaticCache setup.
         // Collect option keys from m_map_name_to_offset,
         // assign default values to m_defaults.
@@ -400,6 +424,9 @@ protected:
             m_defaults = defaults;
             m_keys.clear();
             m_keys.reserve(m_map_name_to_offset.size());
+            m_offsets.clear();
+            m_offsets.reserve(m_map_name_to_offset.size());
+            // defs->options is sorted by name, thus m_keys will be sorted as well.
             for (const auto &kvp : defs->options) {
                 // Find the option given the option name kvp.first by an offset from (char*)m_defaults.
                 ConfigOption *opt = this->optptr(kvp.first, m_defaults);
@@ -407,6 +434,7 @@ protected:
                     // This option is not defined by the ConfigBase of type T.
                     continue;
                 m_keys.emplace_back(kvp.first);
+                m_offsets.emplace_back((const char*)opt - (const char*)m_defaults);
                 const ConfigOptionDef *def = defs->get(kvp.first);
                 assert(def != nullptr);
                 if (def->default_value)
@@ -417,6 +445,8 @@ protected:
     private:
         T                                  *m_defaults;
         std::vector<std::string>            m_keys;
+        // Offsets of the options named by m_keys.
+        std::vector<ptrdiff_t>              m_offsets;
     };
 };
 
@@ -431,6 +461,8 @@ public: \
     /* Overrides ConfigBase::keys(). Collect names of all configuration values maintained by this configuration store. */ \
     t_config_option_keys     keys() const override { return s_cache_##CLASS_NAME.keys(); } \
     const t_config_option_keys& keys_ref() const override { return s_cache_##CLASS_NAME.keys(); } \
+    /* Same as ConfigBase::diff(), faster by walking the cached keys and the DynamicConfig in lockstep. */ \
+    t_config_option_keys     diff_dynamic(const DynamicConfig &other) const { return s_cache_##CLASS_NAME.diff(this, other); } \
     static const CLASS_NAME& defaults() { assert(s_cache_##CLASS_NAME.initialized()); return s_cache_##CLASS_NAME.defaults(); } \
 private: \
     friend int print_config_static_initializer(); \
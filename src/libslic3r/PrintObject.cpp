@@ -22,6 +22,7 @@
 #include <string_view>
 #include <utility>
 
+#include <boost/functional/hash.hpp>
 #include <boost/log/trivial.hpp>
 
 #include <tbb/parallel_for.h>
@@ -115,6 +116,106 @@ std::vector<std::reference_wrapper<const PrintRegion>> PrintObject::all_regions(
     return out;
 }
 
+static void hash_combine_expolygon(size_t &seed, const ExPolygon &expolygon)
+{
+    auto hash_polygon = [&seed](const Polygon &polygon) {
+        boost::hash_combine(seed, polygon.points.size());
+        for (const Point &pt : polygon.points) {
+            boost::hash_combine(seed, pt.x());
+            boost::hash_combine(seed, pt.y());
+        }
+    };
+    hash_polygon(expolygon.contour);
+    boost::hash_combine(seed, expolygon.holes.size());
+    for (const Polygon &hole : expolygon.holes)
+        hash_polygon(hole);
+}
+
+static void hash_combine_surfaces(size_t &seed, const Surfaces &surfaces)
+{
+    boost::hash_combine(seed, surfaces.size());
+    for (const Surface &surface : surfaces) {
+        boost::hash_combine(seed, int(surface.surface_type));
+        boost::hash_combine(seed, surface.thickness);
+        boost::hash_combine(seed, surface.thickness_layers);
+        boost::hash_combine(seed, surface.bridge_angle);
+        boost::hash_combine(seed, surface.extra_perimeters);
+        hash_combine_expolygon(seed, surface.expolygon);
+    }
+}
+
+// Options of the print and of the object read by the perimeter and the fill generators, directly or through PrintRegion::flow().
+// Changing any other print or object option keeps the extrusions of the layers, whose other inputs did not change.
+// To be kept in sync with PerimeterGenerator, LayerRegion::make_perimeters() and Layer::make_fills().
+static const char *extrusions_print_options[]  = { "nozzle_diameter", "initial_layer_line_width", "resolution", "enable_arc_fitting", "wall_infill_order", "spiral_mode" };
+static const char *extrusions_object_options[] = { "layer_height", "line_width", "raft_layers", "enable_support", "enforce_support_layers", "support_top_z_distance",
+                                                   "brim_type", "brim_width", "detect_narrow_internal_solid_infill" };
+// Options of a region only read by PrintObject::prepare_infill(). Their effect on the fills of a layer is captured by the hash
+// of its fill surfaces, thus they are left out of the fingerprint of the fills.
+static const char *prepare_infill_region_options[] = { "top_shell_layers", "top_shell_thickness", "bottom_shell_layers", "bottom_shell_thickness",
+                                                       "infill_combination", "minimum_sparse_infill_area" };
+
+// Fingerprint of the configuration shared by the perimeters and the fills of all layers of an object.
+static size_t extrusions_config_fingerprint(const PrintObject &object)
+{
+    size_t seed = 0;
+    for (const char *opt_key : extrusions_print_options)
+        boost::hash_combine(seed, object.print()->config().option(opt_key)->hash());
+    for (const char *opt_key : extrusions_object_options)
+        boost::hash_combine(seed, object.config().option(opt_key)->hash());
+    // The infill patterns are aligned to the bounding box of the object.
+    const BoundingBox bbox = object.bounding_box();
+    boost::hash_combine(seed, bbox.min.x());
+    boost::hash_combine(seed, bbox.min.y());
+    boost::hash_combine(seed, bbox.max.x());
+    boost::hash_combine(seed, bbox.max.y());
+    return seed;
+}
+
+// Hash of the options of a region read by Layer::make_fills().
+static size_t fills_region_config_hash(const PrintRegionConfig &config)
+{
+    size_t seed = 0;
+    for (const std::string &opt_key : config.keys())
+        if (std::find_if(std::begin(prepare_infill_region_options), std::end(prepare_infill_region_options),
+                [&opt_key](const char *key) { return opt_key == key; }) == std::end(prepare_infill_region_options))
+            boost::hash_combine(seed, config.option(opt_key)->hash());
+    return seed;
+}
+
+// Fingerprint of the inputs of Layer::make_perimeters(): the untyped region slices and the configs of the non-empty regions of a layer,
+// the lslices of the layers below and above (zero if there is no such layer) and the configuration shared by all layers.
+static size_t perimeters_fingerprint(const Layer &layer, size_t config_fingerprint, size_t lower_lslices_hash, size_t upper_lslices_hash)
+{
+    size_t seed = config_fingerprint;
+    boost::hash_combine(seed, layer.id());
+    boost::hash_combine(seed, layer.print_z);
+    boost::hash_combine(seed, layer.slice_z);
+    boost::hash_combine(seed, layer.height);
+    boost::hash_combine(seed, lower_lslices_hash);
+    boost::hash_combine(seed, upper_lslices_hash);
+    for (const LayerRegion *layerm : layer.regions()) {
+        // The perimeters of an empty region are cleared whatever its config.
+        boost::hash_combine(seed, layerm->slices.empty() ? 0 : layerm->region().config_hash());
+        hash_combine_surfaces(seed, layerm->slices.surfaces);
+    }
+    return seed;
+}
+
+// Fingerprint of the inputs of Layer::make_fills(): the prepared surfaces and the configs of the non-empty regions of a layer,
+// the inputs of its perimeters and the configuration shared by all layers. region_config_hashes are indexed by the region id.
+static size_t fills_fingerprint(const Layer &layer, size_t config_fingerprint, const std::vector<size_t> &region_config_hashes,
+    size_t fill_surfaces_hash, size_t perimeters_fingerprint)
+{
+    assert(layer.regions().size() == region_config_hashes.size());
+    size_t seed = config_fingerprint;
+    boost::hash_combine(seed, fill_surfaces_hash);
+    boost::hash_combine(seed, perimeters_fingerprint);
+    for (size_t region_id = 0; region_id < layer.regions().size(); ++ region_id)
+        boost::hash_combine(seed, layer.regions()[region_id]->slices.empty() ? 0 : region_config_hashes[region_id]);
+    return seed;
+}
+
 // 1) Merges typed region slices into stInternal type.
 // 2) Increases an "extra perimeters" counter at region slices where needed.
 // 3) Generates perimeters, gap fills and fill regions (fill regions of type stInternal).
@@ -129,10 +230,12 @@ void PrintObject::make_perimeters()
     m_print->set_status(15, L("Generating walls"));
     BOOST_LOG_TRIVIAL(info) << "Generating walls..." << log_memory_info();
 
-    // Revert the typed slices into untyped slices.
+    // Revert the typed slices into untyped slices and the fill surfaces into the fill surfaces generated by the perimeter generator.
+    // The fill surfaces of the layers, whose perimeters are not regenerated below, were already processed by prepare_infill().
     if (m_typed_slices) {
         for (Layer *layer : m_layers) {
             layer->restore_untyped_slices();
+            layer->restore_untyped_fill_surfaces();
             m_print->throw_if_canceled();
         }
         m_typed_slices = false;
@@ -209,22 +312,60 @@ void PrintObject::make_perimeters()
         BOOST_LOG_TRIVIAL(debug) << "Generating extra perimeters for region " << region_id << " in parallel - end";
     }
 
-    BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - start";
+    // The perimeters of a layer only depend on the layer's own regions and on the slices of the layer below,
+    // thus after changing a region of a layer range or of a modifier volume, only the layers of that region are regenerated.
+    auto [layers_begin, layers_end] = this->invalidated_layers(posPerimeters);
+    // The perimeters of a layer, whose inputs did not change since they were generated, are kept.
+    std::vector<size_t> lslices_hashes(m_layers.size(), 0);
     tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, m_layers.size()),
-        [this](const tbb::blocked_range<size_t>& range) {
+        tbb::blocked_range<size_t>(layers_begin == 0 ? 0 : layers_begin - 1, std::min(layers_end + 1, m_layers.size())),
+        [this, &lslices_hashes](const tbb::blocked_range<size_t>& range) {
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+                size_t seed = 0;
+                boost::hash_combine(seed, m_layers[layer_idx]->lslices.size());
+                for (const ExPolygon &expolygon : m_layers[layer_idx]->lslices)
+                    hash_combine_expolygon(seed, expolygon);
+                lslices_hashes[layer_idx] = seed;
+            }
+        });
+    const size_t config_fingerprint = extrusions_config_fingerprint(*this);
+    BOOST_LOG_TRIVIAL(debug) << "Generating perimeters of layers " << layers_begin << " to " << layers_end << " in parallel - start";
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(layers_begin, layers_end),
+        [this, &lslices_hashes, config_fingerprint](const tbb::blocked_range<size_t>& range) {
             for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
                 m_print->throw_if_canceled();
-                m_layers[layer_idx]->make_perimeters();
+                Layer        *layer       = m_layers[layer_idx];
+                const size_t  fingerprint = perimeters_fingerprint(*layer, config_fingerprint,
+                    layer->lower_layer ? lslices_hashes[layer_idx - 1] : 0, layer->upper_layer ? lslices_hashes[layer_idx + 1] : 0);
+                if (fingerprint != layer->m_perimeters_fingerprint) {
+                    layer->make_perimeters();
+                    layer->m_perimeters_fingerprint = fingerprint;
+                }
             }
         }
     );
     m_print->throw_if_canceled();
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end";
 
+    // The offsets of the lower slices used for the overhang detection are not needed anymore.
+    this->clear_support_maps();
+    m_invalidated_z_ranges[posPerimeters].reset();
     this->set_done(posPerimeters);
 }
 
+// Hash of the typed slices and of the fill surfaces of all regions of a layer, to find the layers with surfaces modified by prepare_infill().
+// The typed slices are hashed as well, as the ironing is applied to the top slices.
+static size_t fill_surfaces_hash(const Layer &layer)
+{
+    size_t seed = 0;
+    for (const LayerRegion *layerm : layer.regions()) {
+        hash_combine_surfaces(seed, layerm->slices.surfaces);
+        hash_combine_surfaces(seed, layerm->fill_surfaces.surfaces);
+    }
+    return seed;
+}
+
 void PrintObject::prepare_infill()
 {
     if (! this->set_started(posPrepareInfill))
@@ -346,6 +487,33 @@ void PrintObject::prepare_infill()
     } // for each layer
 #endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
 
+    // The fill surfaces are prepared for all layers, as the top / bottom shells, bridges and combined infill
+    // spread over multiple layers. If the infill is to be regenerated for a z range only, extend the z range
+    // with the layers, whose fill surfaces were modified.
+    {
+        std::vector<size_t> fill_surfaces_hashes(m_layers.size(), 0);
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, m_layers.size()),
+            [this, &fill_surfaces_hashes](const tbb::blocked_range<size_t>& range) {
+                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+                    fill_surfaces_hashes[layer_idx] = fill_surfaces_hash(*m_layers[layer_idx]);
+            });
+        if (std::optional<t_layer_height_range> &z_range = m_invalidated_z_ranges[posInfill]; z_range) {
+            if (fill_surfaces_hashes.size() != m_fill_surfaces_hashes.size())
+                z_range.reset();
+            else
+                for (size_t layer_idx = 0; layer_idx < m_layers.size(); ++ layer_idx)
+                    if (fill_surfaces_hashes[layer_idx] != m_fill_surfaces_hashes[layer_idx]) {
+                        z_range->first  = std::min(z_range->first,  m_layers[layer_idx]->slice_z);
+                        z_range->second = std::max(z_range->second, m_layers[layer_idx]->slice_z);
+                    }
+        }
+        m_fill_surfaces_hashes = std::move(fill_surfaces_hashes);
+    }
+
+    // The lower slice data queried by process_external_surfaces() is not needed anymore.
+    this->clear_support_maps();
+    m_invalidated_z_ranges[posPrepareInfill].reset();
     this->set_done(posPrepareInfill);
 }
 
@@ -358,14 +526,39 @@ void PrintObject::infill()
         m_print->set_status(35, L("Generating infill toolpath"));
 
         auto [adaptive_fill_octree, support_fill_octree] = this->prepare_adaptive_infill_data();
-
-        BOOST_LOG_TRIVIAL(debug) << "Filling layers in parallel - start";
+        // Periodic infill patterns are generated once for the whole object and shared by its layers.
+        FillPatternCache pattern_cache;
+
+        auto [layers_begin, layers_end] = this->invalidated_layers(posInfill);
+        if (adaptive_fill_octree || support_fill_octree) {
+            // The octrees are built over the whole object, thus they may have changed for all layers.
+            layers_begin = 0;
+            layers_end   = m_layers.size();
+        }
+        // The fills of a layer, whose inputs did not change since they were generated, are kept.
+        // The octrees are not fingerprinted, thus the fills are always regenerated if the octrees are in use.
+        assert(m_fill_surfaces_hashes.size() == m_layers.size());
+        const size_t config_fingerprint = extrusions_config_fingerprint(*this);
+        const bool   use_fingerprints   = ! adaptive_fill_octree && ! support_fill_octree;
+        std::vector<size_t> region_config_hashes;
+        region_config_hashes.reserve(this->num_printing_regions());
+        for (size_t region_id = 0; region_id < this->num_printing_regions(); ++ region_id)
+            region_config_hashes.emplace_back(fills_region_config_hash(this->printing_region(region_id).config()));
+        BOOST_LOG_TRIVIAL(debug) << "Filling layers " << layers_begin << " to " << layers_end << " in parallel - start";
         tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, m_layers.size()),
-            [this, &adaptive_fill_octree = adaptive_fill_octree, &support_fill_octree = support_fill_octree](const tbb::blocked_range<size_t>& range) {
+            tbb::blocked_range<size_t>(layers_begin, layers_end),
+            [this, &adaptive_fill_octree = adaptive_fill_octree, &support_fill_octree = support_fill_octree, &pattern_cache, &region_config_hashes,
+             config_fingerprint, use_fingerprints]
+            (const tbb::blocked_range<size_t>& range) {
                 for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
                     m_print->throw_if_canceled();
-                    m_layers[layer_idx]->make_fills(adaptive_fill_octree.get(), support_fill_octree.get());
+                    Layer        *layer       = m_layers[layer_idx];
+                    const size_t  fingerprint = use_fingerprints ?
+                        fills_fingerprint(*layer, config_fingerprint, region_config_hashes, m_fill_surfaces_hashes[layer_idx], layer->m_perimeters_fingerprint) : 0;
+                    if (fingerprint == 0 || fingerprint != layer->m_fills_fingerprint) {
+                        layer->make_fills(adaptive_fill_octree.get(), support_fill_octree.get(), &pattern_cache);
+                        layer->m_fills_fingerprint = fingerprint;
+                    }
                 }
             }
         );
@@ -374,6 +567,7 @@ void PrintObject::infill()
         /*  we could free memory now, but this would make this step not idempotent
         ### $_->fill_surfaces->clear for map @{$_->regions}, @{$object->layers};
         */
+        m_invalidated_z_ranges[posInfill].reset();
         this->set_done(posInfill);
     }
 }
@@ -382,6 +576,7 @@ void PrintObject::ironing()
 {
     if (this->set_started(posIroning)) {
         BOOST_LOG_TRIVIAL(debug) << "Ironing in parallel - start";
+        // Only the layers with regenerated fills are ironed, Layer::make_ironing() skips the layers with fills kept by infill().
         tbb::parallel_for(
             // Ironing starting with layer 0 to support ironing all surfaces.
             tbb::blocked_range<size_t>(0, m_layers.size()),
@@ -427,6 +622,8 @@ void PrintObject::generate_support_material()
 #endif
         }
 
+        // The grown lower slices queried by remove_bridges_from_contacts() are not needed anymore.
+        this->clear_support_maps();
         this->set_done(posSupportMaterial);
     }
 }
@@ -437,12 +634,17 @@ void PrintObject::simplify_extrusion_path()
         m_print->set_status(75, L("Optimizing toolpath"));
         BOOST_LOG_TRIVIAL(debug) << "Simplify extrusion path of object in parallel - start";
         //BBS: infill and walls
+        // The regions are independent, balance the work between the regions of all the layers.
+        // Only the regenerated extrusions are simplified, LayerRegion::simplify_extrusion_entity() skips the extrusions simplified already.
+        std::vector<LayerRegion*> layer_regions;
+        for (const Layer *layer : m_layers)
+            layer_regions.insert(layer_regions.end(), layer->regions().begin(), layer->regions().end());
         tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, m_layers.size()),
-            [this](const tbb::blocked_range<size_t>& range) {
-                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+            tbb::blocked_range<size_t>(0, layer_regions.size()),
+            [this, &layer_regions](const tbb::blocked_range<size_t>& range) {
+                for (size_t region_idx = range.begin(); region_idx < range.end(); ++ region_idx) {
                     m_print->throw_if_canceled();
-                    m_layers[layer_idx]->simplify_extrusion_path();
+                    layer_regions[region_idx]->simplify_extrusion_entity();
                 }
             }
         );
@@ -455,22 +657,16 @@ void PrintObject::simplify_extrusion_path()
         //BBS: share same progress
         m_print->set_status(75, L("Optimizing toolpath"));
         BOOST_LOG_TRIVIAL(debug) << "Simplify extrusion path of support in parallel - start";
+        // Normal and tree support layers in a single parallel pass.
         tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, m_support_layers.size()),
+            tbb::blocked_range<size_t>(0, m_support_layers.size() + m_tree_support_layers.size()),
             [this](const tbb::blocked_range<size_t>& range) {
                 for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
                     m_print->throw_if_canceled();
-                    m_support_layers[layer_idx]->simplify_support_extrusion_path();
-                }
-            }
-        );
-        m_print->throw_if_canceled();
-        tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, m_tree_support_layers.size()),
-            [this](const tbb::blocked_range<size_t>& range) {
-                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
-                    m_print->throw_if_canceled();
-                    m_tree_support_layers[layer_idx]->simplify_support_extrusion_path();
+                    if (layer_idx < m_support_layers.size())
+                        m_support_layers[layer_idx]->simplify_support_extrusion_path();
+                    else
+                        m_tree_support_layers[layer_idx - m_support_layers.size()]->simplify_support_extrusion_path();
                 }
             }
         );
@@ -593,6 +789,12 @@ void PrintObject::clear_support_layers()
     m_support_layers.clear();
 }
 
+void PrintObject::clear_support_maps()
+{
+    for (Layer *l : m_layers)
+        l->clear_support_map();
+}
+
 SupportLayer* PrintObject::add_support_layer(int id, int interface_id, coordf_t height, coordf_t print_z)
 {
     m_support_layers.emplace_back(new SupportLayer(id, interface_id, this, height, print_z, -1));
@@ -607,7 +809,8 @@ SupportLayerPtrs::iterator PrintObject::insert_support_layer(SupportLayerPtrs::i
 // Called by Print::apply().
 // This method only accepts PrintObjectConfig and PrintRegionConfig option keys.
 bool PrintObject::invalidate_state_by_config_options(
-    const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys)
+    const ConfigOptionResolver &old_config, const ConfigOptionResolver &new_config, const std::vector<t_config_option_key> &opt_keys,
+    const t_layer_height_range *z_range)
 {
     if (opt_keys.empty())
         return false;
@@ -799,32 +1002,76 @@ bool PrintObject::invalidate_state_by_config_options(
 
     sort_remove_duplicates(steps);
     for (PrintObjectStep step : steps)
-        invalidated |= this->invalidate_step(step);
+        invalidated |= z_range ? this->invalidate_step(step, *z_range) : this->invalidate_step(step);
     return invalidated;
 }
 
+// PrintObject steps depending on a step, thus invalidated together with the step.
+static std::vector<PrintObjectStep> object_steps_depending_on(PrintObjectStep step)
+{
+    switch (step) {
+    case posSlice:           return { posPerimeters, posPrepareInfill, posInfill, posIroning, posSupportMaterial, posSimplifyPath };
+    case posPerimeters:      return { posPrepareInfill, posInfill, posIroning, posSimplifyPath };
+    case posPrepareInfill:   return { posInfill, posIroning, posSimplifyPath };
+    case posInfill:          return { posIroning, posSimplifyPath };
+    case posSupportMaterial: return { posSimplifySupportPath };
+    default:                 return {};
+    }
+}
+
+// Steps, which may be invalidated for a z range only. posPerimeters and posInfill process just the layers of the z range,
+// posPrepareInfill is always recalculated for all layers, it only passes the z range over to posInfill.
+// The other depending steps (posIroning, posSimplifyPath) go over all layers and skip the extrusions kept by
+// the steps above, thus they are not tracked by a z range.
+static bool object_step_invalidated_by_z_range(PrintObjectStep step)
+{
+    return step == posPerimeters || step == posPrepareInfill || step == posInfill;
+}
+
 bool PrintObject::invalidate_step(PrintObjectStep step)
+{
+    // The step and its depending steps will be recalculated for all layers.
+    m_invalidated_z_ranges[step].reset();
+    for (PrintObjectStep depending_step : object_steps_depending_on(step))
+        m_invalidated_z_ranges[depending_step].reset();
+    return this->invalidate_step_and_depending_steps(step);
+}
+
+bool PrintObject::invalidate_step(PrintObjectStep step, const t_layer_height_range &z_range)
+{
+    if (! object_step_invalidated_by_z_range(step))
+        return this->invalidate_step(step);
+
+    std::vector<PrintObjectStep> steps = object_steps_depending_on(step);
+    steps.emplace_back(step);
+    for (PrintObjectStep invalidated_step : steps) {
+        if (! object_step_invalidated_by_z_range(invalidated_step))
+            continue;
+        std::optional<t_layer_height_range> &invalidated_z_range = m_invalidated_z_ranges[invalidated_step];
+        if (this->is_step_done(invalidated_step))
+            // All layers are valid, recalculate just the layers of z_range.
+            invalidated_z_range = z_range;
+        else if (invalidated_z_range) {
+            // Some layers are already waiting for recalculation.
+            invalidated_z_range->first  = std::min(invalidated_z_range->first,  z_range.first);
+            invalidated_z_range->second = std::max(invalidated_z_range->second, z_range.second);
+        }
+        // Otherwise the step is to be calculated for all layers already.
+    }
+    return this->invalidate_step_and_depending_steps(step);
+}
+
+bool PrintObject::invalidate_step_and_depending_steps(PrintObjectStep step)
 {
 	bool invalidated = Inherited::invalidate_step(step);
 
     // propagate to dependent steps
-    if (step == posPerimeters) {
-		invalidated |= this->invalidate_steps({ posPrepareInfill, posInfill, posIroning, posSimplifyPath });
-        invalidated |= m_print->invalidate_steps({ psSkirtBrim });
-    } else if (step == posPrepareInfill) {
-        invalidated |= this->invalidate_steps({ posInfill, posIroning, posSimplifyPath });
-    } else if (step == posInfill) {
-        invalidated |= this->invalidate_steps({ posIroning, posSimplifyPath });
-        invalidated |= m_print->invalidate_steps({ psSkirtBrim });
-    } else if (step == posSlice) {
-		invalidated |= this->invalidate_steps({ posPerimeters, posPrepareInfill, posInfill, posIroning, posSupportMaterial, posSimplifyPath });
-        invalidated |= m_print->invalidate_steps({ psSkirtBrim });
-        m_slicing_params.valid = false;
-    } else if (step == posSupportMaterial) {
-        invalidated |= this->invalidate_steps({ posSimplifySupportPath });
+    std::vector<PrintObjectStep> depending_steps = object_steps_depending_on(step);
+    invalidated |= this->invalidate_steps(depending_steps.begin(), depending_steps.end());
+    if (step == posPerimeters || step == posInfill || step == posSlice || step == posSupportMaterial)
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
+    if (step == posSlice || step == posSupportMaterial)
         m_slicing_params.valid = false;
-    }
 
     // Wipe tower depends on the ordering of extruders, which in turn depends on everything.
     // It also decides about what the flush_into_infill / wipe_into_object features will do,
@@ -841,9 +1088,24 @@ bool PrintObject::invalidate_all_steps()
     bool result = Inherited::invalidate_all_steps() | m_print->invalidate_all_steps();
 	// Then reset some of the depending values.
 	m_slicing_params.valid = false;
+	for (std::optional<t_layer_height_range> &z_range : m_invalidated_z_ranges)
+		z_range.reset();
 	return result;
 }
 
+std::pair<size_t, size_t> PrintObject::invalidated_layers(PrintObjectStep step) const
+{
+    const std::optional<t_layer_height_range> &z_range = m_invalidated_z_ranges[step];
+    if (! z_range)
+        return { 0, m_layers.size() };
+    // The layers are assigned to the layer height ranges by their slice_z, see PrintObject::slice_volumes().
+    auto it_begin = std::lower_bound(m_layers.begin(), m_layers.end(), z_range->first - EPSILON,
+        [](const Layer *layer, coordf_t z) { return layer->slice_z < z; });
+    auto it_end   = std::upper_bound(it_begin, m_layers.end(), z_range->second + EPSILON,
+        [](coordf_t z, const Layer *layer) { return z < layer->slice_z; });
+    return { size_t(it_begin - m_layers.begin()), size_t(it_end - m_layers.begin()) };
+}
+
 // This function analyzes slices of a region (SurfaceCollection slices).
 // Each region slice (instance of Surface) is analyzed, whether it is supported or whether it is the top surface.
 // Initially all slices are of type stInternal.
@@ -2304,14 +2566,14 @@ void PrintObject::remove_bridges_from_contacts(
     float fw = extrusion_width;
     Lines overhang_perimeters = to_lines(*overhang_regions);
     auto layer_regions = current_layer->regions();
-    Polygons lower_layer_polygons = to_polygons(lower_layer->lslices);
 
     Polygons all_bridges;
     for (LayerRegion* layerm : layer_regions)
     {
         Polygons bridges;
         // Surface supporting this layer, expanded by 0.5 * nozzle_diameter, as we consider this kind of overhang to be sufficiently supported.
-        Polygons lower_grown_slices = offset(lower_layer_polygons,
+        // Shared with the other regions and with the other callers querying the same lower layer.
+        const Polygons &lower_grown_slices = lower_layer->support_map().grown(
             //FIXME to mimic the decision in the perimeter generator, we should use half the external perimeter width.
             0.5f * fw, SUPPORT_SURFACES_OFFSET_PARAMETERS);
         Polylines overhang_perimeters = diff_pl(layerm->perimeters.as_polylines(), lower_grown_slices);
@@ -53,16 +53,20 @@ static std::vector<ExPolygons> slice_volume(
     const std::function<void()>   &throw_on_cancel_callback)
 {
     std::vector<ExPolygons> layers;
-    if (! zs.empty()) {
-        indexed_triangle_set its = volume.mesh().its;
-        if (its.indices.size() > 0) {
-            MeshSlicingParamsEx params2 { params };
-            params2.trafo = params2.trafo * volume.get_matrix();
-            if (params2.trafo.rotation().determinant() < 0.)
-                its_flip_triangles(its);
+    const TriangleMesh     &mesh = volume.mesh();
+    if (! zs.empty() && ! mesh.empty()) {
+        MeshSlicingParamsEx params2 { params };
+        params2.trafo = params2.trafo * volume.get_matrix();
+        if (params2.trafo.rotation().determinant() < 0.) {
+            indexed_triangle_set its = mesh.its;
+            its_flip_triangles(its);
             layers = slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
-            throw_on_cancel_callback();
+        } else {
+            // Slice the shared mesh in place, reusing its cached edge topology.
+            params2.face_edge_ids = &mesh.face_edge_ids();
+            layers = slice_mesh_ex(mesh.its, zs, params2, throw_on_cancel_callback);
         }
+        throw_on_cancel_callback();
     }
     return layers;
 }
@@ -1052,6 +1056,7 @@ void PrintObject::slice_volumes()
                 lslices_1st_layer_sorted.emplace_back(std::move(lslices_1st_layer[i]));
 
             m_layers.front()->lslices = std::move(lslices_1st_layer_sorted);
+            m_layers.front()->clear_support_map();
 		}
 	}
 
@@ -32,30 +32,17 @@ template<class Color> struct Colors {
 template<class Color> const Color Colors<Color>::White = Color{255};
 template<class Color> const Color Colors<Color>::Black = Color{0};
 
-template<class PixelRenderer,
-         template<class /*agg::renderer_base<PixelRenderer>*/> class Renderer,
-         class Rasterizer = agg::rasterizer_scanline_aa<>,
+// Common part of the AGG based rasters: converts the scaled polygons into AGG
+// paths in pixel coordinates (applying the raster transformation) and feeds the
+// resulting scanlines into a renderer supplied by the derived class.
+template<class Rasterizer = agg::rasterizer_scanline_aa<>,
          class Scanline   = agg::scanline_p8>
-class AGGRaster: public RasterBase {
-public:
-    using TColor = typename PixelRenderer::color_type;
-    using TValue = typename TColor::value_type;
-    using TPixel = typename PixelRenderer::pixel_type;
-    using TRawBuffer = agg::rendering_buffer;
-    
+class AGGRasterBase: public RasterBase {
 protected:
     
     Resolution m_resolution;
     PixelDim m_pxdim_scaled;    // used for scaled coordinate polygons
     
-    std::vector<TPixel> m_buf;
-    agg::rendering_buffer m_rbuf;
-    
-    PixelRenderer m_pixrenderer;
-    
-    agg::renderer_base<PixelRenderer> m_raw_renderer;
-    Renderer<agg::renderer_base<PixelRenderer>> m_renderer;
-    
     Trafo m_trafo;
     Scanline m_scanlines;
     Rasterizer m_rasterizer;
@@ -111,34 +98,24 @@ protected:
         return path;
     }
     
-    template<class P> void _draw(const P &poly)
+    template<class P, class Renderer> void _draw(const P &poly, Renderer &ren)
     {
         m_rasterizer.reset();
         
         m_rasterizer.add_path(to_path(contour(poly)));
         for(auto& h : holes(poly)) m_rasterizer.add_path(to_path(h));
         
-        agg::render_scanlines(m_rasterizer, m_scanlines, m_renderer);
+        agg::render_scanlines(m_rasterizer, m_scanlines, ren);
     }
     
 public:
     template<class GammaFn>
-    AGGRaster(const Resolution &res,
-              const PixelDim &  pd,
-              const Trafo &     trafo,
-              const TColor &    foreground,
-              const TColor &    background,
-              GammaFn &&        gammafn)
+    AGGRasterBase(const Resolution &res,
+                  const PixelDim &  pd,
+                  const Trafo &     trafo,
+                  GammaFn &&        gammafn)
         : m_resolution(res)
         , m_pxdim_scaled(SCALING_FACTOR, SCALING_FACTOR)
-        , m_buf(res.pixels())
-        , m_rbuf(reinterpret_cast<TValue *>(m_buf.data()),
-                 unsigned(res.width_px),
-                 unsigned(res.height_px),
-                 int(res.width_px *PixelRenderer::num_components))
-        , m_pixrenderer(m_rbuf)
-        , m_raw_renderer(m_pixrenderer)
-        , m_renderer(m_raw_renderer)
         , m_trafo(trafo)
     {
         // Visual Studio compiler gives warnings about possible division by zero.
@@ -147,8 +124,6 @@ public:
             m_pxdim_scaled.w_mm /= pd.w_mm;
             m_pxdim_scaled.h_mm /= pd.h_mm;
         }
-        m_renderer.color(foreground);
-        clear(background);
         
         m_rasterizer.gamma(gammafn);
     }
@@ -160,12 +135,75 @@ public:
         return {SCALING_FACTOR / m_pxdim_scaled.w_mm,
                 SCALING_FACTOR / m_pxdim_scaled.h_mm};
     }
+};
+
+template<class PixelRenderer,
+         template<class /*agg::renderer_base<PixelRenderer>*/> class Renderer,
+         class Rasterizer = agg::rasterizer_scanline_aa<>,
+         class Scanline   = agg::scanline_p8>
+class AGGRaster: public AGGRasterBase<Rasterizer, Scanline> {
+    using Base = AGGRasterBase<Rasterizer, Scanline>;
     
-    void draw(const ExPolygon &poly) override { _draw(poly); }
+public:
+    using TColor = typename PixelRenderer::color_type;
+    using TValue = typename TColor::value_type;
+    using TPixel = typename PixelRenderer::pixel_type;
+    using TRawBuffer = agg::rendering_buffer;
+    
+    using typename Base::Resolution;
+    using typename Base::PixelDim;
+    using typename Base::Trafo;
+    
+protected:
+    
+    std::vector<TPixel> m_buf;
+    agg::rendering_buffer m_rbuf;
+    
+    PixelRenderer m_pixrenderer;
+    
+    agg::renderer_base<PixelRenderer> m_raw_renderer;
+    Renderer<agg::renderer_base<PixelRenderer>> m_renderer;
+    
+public:
+    template<class GammaFn>
+    AGGRaster(const Resolution &res,
+              const PixelDim &  pd,
+              const Trafo &     trafo,
+              const TColor &    foreground,
+              const TColor &    background,
+              GammaFn &&        gammafn)
+        : Base(res, pd, trafo, std::forward<GammaFn>(gammafn))
+        , m_buf(res.pixels())
+        , m_rbuf(reinterpret_cast<TValue *>(m_buf.data()),
+                 unsigned(res.width_px),
+                 unsigned(res.height_px),
+                 int(res.width_px *PixelRenderer::num_components))
+        , m_pixrenderer(m_rbuf)
+        , m_raw_renderer(m_pixrenderer)
+        , m_renderer(m_raw_renderer)
+    {
+        m_renderer.color(foreground);
+        clear(background);
+    }
+    
+    void draw(const ExPolygon &poly) override { Base::_draw(poly, m_renderer); }
     
     EncodedRaster encode(RasterEncoder encoder) const override
     {
-        return encoder(m_buf.data(), m_resolution.width_px, m_resolution.height_px, 1);    
+        return encoder(m_buf.data(), this->m_resolution.width_px,
+                       this->m_resolution.height_px, 1);
+    }
+    
+    EncodedRaster encode_rows(RasterRowEncoder encoder) const override
+    {
+        const size_t w = this->m_resolution.width_px;
+        auto rowfn = [this, w](size_t row, uint8_t *dst) {
+            auto src = reinterpret_cast<const uint8_t *>(m_buf.data() + row * w);
+            std::copy(src, src + w * sizeof(TPixel), dst);
+        };
+        
+        return encoder(rowfn, w, this->m_resolution.height_px,
+                       PixelRenderer::num_components);
     }
     
     void clear(const TColor color) { m_raw_renderer.clear(color); }
@@ -217,6 +255,91 @@ public:
     {}
 };
 
+/*
+ * Same output as RasterGrayscaleAA, but the canvas is stored as run-length
+ * encoded rows: the scanlines coming out of the AGG rasterizer are merged
+ * directly into sorted, non-overlapping spans of equal coverage. A sliced
+ * layer consists of a few spans per row, so the memory footprint is a small
+ * fraction of the full bitmap, which is never allocated when the raster is
+ * encoded through encode_rows().
+ */
+class RasterGrayscaleAARLE: public AGGRasterBase<> {
+    using Base = AGGRasterBase<>;
+    
+public:
+    struct Span {
+        uint32_t x   = 0;
+        uint32_t len = 0;
+        uint8_t  cover = 0;
+    };
+    
+    using Row = std::vector<Span>;
+    
+private:
+    std::vector<Row> m_rows;
+    
+    // Scratch buffers reused between the rendered scanlines.
+    Row m_incoming, m_merged;
+    
+    // Receives the scanlines from agg::render_scanlines
+    struct SpanRenderer {
+        RasterGrayscaleAARLE &self;
+        void prepare() {}
+        template<class Scanline> void render(const Scanline &sl);
+    } m_renderer;
+    
+    void add_span(Row &row, int x, int len, uint8_t cover) const;
+    void merge_row(Row &row);
+    
+public:
+    template<class GammaFn>
+    RasterGrayscaleAARLE(const RasterBase::Resolution &res,
+                         const RasterBase::PixelDim &  pd,
+                         const RasterBase::Trafo &     trafo,
+                         GammaFn &&                    fn)
+        : Base(res, pd, trafo, std::forward<GammaFn>(fn))
+        , m_rows(res.height_px)
+        , m_renderer{*this}
+    {}
+    
+    void draw(const ExPolygon &poly) override { Base::_draw(poly, m_renderer); }
+    
+    // Fallback for encoders which need the whole bitmap.
+    EncodedRaster encode(RasterEncoder encoder) const override;
+    EncodedRaster encode_rows(RasterRowEncoder encoder) const override;
+    
+    const Row &row(size_t r) const { return m_rows[r]; }
+    void fill_row(size_t r, uint8_t *dst) const;
+    uint8_t read_pixel(size_t col, size_t row) const;
+    
+    void clear();
+};
+
+template<class Scanline>
+void RasterGrayscaleAARLE::SpanRenderer::render(const Scanline &sl)
+{
+    int y = sl.y();
+    if (y < 0 || y >= int(self.m_resolution.height_px)) return;
+    
+    self.m_incoming.clear();
+    
+    auto     span      = sl.begin();
+    unsigned num_spans = sl.num_spans();
+    for (;;) {
+        if (span->len > 0) {
+            for (int i = 0; i < span->len; ++i)
+                self.add_span(self.m_incoming, span->x + i, 1, span->covers[i]);
+        } else {
+            self.add_span(self.m_incoming, span->x, -span->len, *span->covers);
+        }
+        
+        if (--num_spans == 0) break;
+        ++span;
+    }
+    
+    self.merge_row(self.m_rows[size_t(y)]);
+}
+
 }} // namespace Slic3r::sla
 
 #endif // AGGRASTER_HPP
@@ -2,6 +2,8 @@
 #define SLARASTER_CPP
 
 #include <functional>
+#include <limits>
+#include <atomic>
 
 #include <libslic3r/SLA/RasterBase.hpp>
 #include <libslic3r/SLA/AGGRaster.hpp>
@@ -38,6 +40,139 @@ EncodedRaster PNGRasterEncoder::operator()(const void *ptr, size_t w, size_t h,
     return EncodedRaster(std::move(buf), "png");
 }
 
+namespace {
+
+void append_be32(std::vector<uint8_t> &buf, uint32_t v)
+{
+    buf.emplace_back(uint8_t(v >> 24));
+    buf.emplace_back(uint8_t(v >> 16));
+    buf.emplace_back(uint8_t(v >> 8));
+    buf.emplace_back(uint8_t(v));
+}
+
+void append_png_chunk(std::vector<uint8_t> &buf, const char *type,
+                      const uint8_t *data, size_t len)
+{
+    append_be32(buf, uint32_t(len));
+    size_t crc_begin = buf.size();
+    buf.insert(buf.end(), type, type + 4);
+    if (len > 0) buf.insert(buf.end(), data, data + len);
+    append_be32(buf, uint32_t(mz_crc32(MZ_CRC32_INIT, buf.data() + crc_begin,
+                                       buf.size() - crc_begin)));
+}
+
+// Adler-32 of the concatenation of two blocks, len2 being the length of the
+// second one (same as adler32_combine() of zlib).
+uint32_t adler32_combine(uint32_t adler1, uint32_t adler2, size_t len2)
+{
+    const uint64_t Base = 65521;
+    uint64_t rem  = len2 % Base;
+    uint64_t sum1 = adler1 & 0xffff;
+    uint64_t sum2 = (rem * sum1) % Base;
+    sum1 += (adler2 & 0xffff) + Base - 1;
+    sum2 += ((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff) + Base - rem;
+    sum1 %= Base;
+    sum2 %= Base;
+    return uint32_t(sum1 | (sum2 << 16));
+}
+
+struct DeflatedBand {
+    std::vector<uint8_t> data;
+    uint32_t adler = MZ_ADLER32_INIT;
+    size_t   raw_len = 0;
+};
+
+mz_bool put_deflated(const void *buf, int len, void *user)
+{
+    auto &out = *static_cast<std::vector<uint8_t> *>(user);
+    auto  ptr = static_cast<const uint8_t *>(buf);
+    out.insert(out.end(), ptr, ptr + len);
+    return MZ_TRUE;
+}
+
+} // namespace
+
+EncodedRaster PNGRasterEncoder::operator()(const RasterRowFn &rowfn, size_t w,
+                                           size_t h, size_t num_components)
+{
+    static const uint8_t ColorTypes[] = {0, 0, 4, 2, 6};
+    if (w == 0 || h == 0 || num_components < 1 || num_components > 4)
+        return EncodedRaster({}, "png");
+    
+    // Every row is prefixed by its filter type, which is always 'None' here.
+    const size_t stride = w * num_components + 1;
+    
+    // Bands are compressed independently with a sync flush at the end, so
+    // their raw deflate streams can simply be concatenated.
+    const size_t BandSize = 256 * 1024;
+    const size_t band_rows = std::max(size_t(1), BandSize / stride);
+    const size_t nbands = (h + band_rows - 1) / band_rows;
+    std::vector<DeflatedBand> bands(nbands);
+    
+    const mz_uint comp_flags = tdefl_create_comp_flags_from_zip_params(
+        MZ_DEFAULT_LEVEL, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+    
+    std::atomic<bool> failed{false};
+    execution::for_each(ex_tbb, size_t(0), nbands,
+        [&](size_t b) {
+            size_t row_begin = b * band_rows;
+            size_t row_end   = std::min(h, row_begin + band_rows);
+            
+            std::vector<uint8_t> raw((row_end - row_begin) * stride, 0);
+            for (size_t r = row_begin; r < row_end; ++r)
+                rowfn(r, raw.data() + (r - row_begin) * stride + 1);
+            
+            DeflatedBand &band = bands[b];
+            band.raw_len = raw.size();
+            band.adler   = uint32_t(mz_adler32(MZ_ADLER32_INIT, raw.data(), raw.size()));
+            
+            std::unique_ptr<tdefl_compressor, void (*)(tdefl_compressor *)>
+                comp(tdefl_compressor_alloc(), tdefl_compressor_free);
+            
+            if (!comp ||
+                tdefl_init(comp.get(), put_deflated, &band.data, int(comp_flags)) != TDEFL_STATUS_OKAY) {
+                failed = true;
+                return;
+            }
+            
+            tdefl_flush flush = b + 1 == nbands ? TDEFL_FINISH : TDEFL_SYNC_FLUSH;
+            tdefl_status st = tdefl_compress_buffer(comp.get(), raw.data(), raw.size(), flush);
+            if (st != (flush == TDEFL_FINISH ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY))
+                failed = true;
+        });
+    
+    if (failed) return EncodedRaster({}, "png");
+    
+    size_t zsize = 6;
+    for (const DeflatedBand &band : bands) zsize += band.data.size();
+    
+    std::vector<uint8_t> idat;
+    idat.reserve(zsize);
+    idat.emplace_back(0x78);
+    idat.emplace_back(0x01);
+    uint32_t adler = MZ_ADLER32_INIT;
+    for (const DeflatedBand &band : bands) {
+        idat.insert(idat.end(), band.data.begin(), band.data.end());
+        adler = adler32_combine(adler, band.adler, band.raw_len);
+    }
+    append_be32(idat, adler);
+    
+    std::vector<uint8_t> ihdr;
+    append_be32(ihdr, uint32_t(w));
+    append_be32(ihdr, uint32_t(h));
+    ihdr.insert(ihdr.end(), {8, ColorTypes[num_components], 0, 0, 0});
+    
+    static const uint8_t Signature[] = {137, 80, 78, 71, 13, 10, 26, 10};
+    std::vector<uint8_t> buf;
+    buf.reserve(zsize + 64);
+    buf.insert(buf.end(), std::begin(Signature), std::end(Signature));
+    append_png_chunk(buf, "IHDR", ihdr.data(), ihdr.size());
+    append_png_chunk(buf, "IDAT", idat.data(), idat.size());
+    append_png_chunk(buf, "IEND", nullptr, 0);
+    
+    return EncodedRaster(std::move(buf), "png");
+}
+
 std::ostream &operator<<(std::ostream &stream, const EncodedRaster &bytes)
 {
     stream.write(reinterpret_cast<const char *>(bytes.data()),
@@ -83,6 +218,117 @@ std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     return rst;
 }
 
+std::unique_ptr<RasterBase> create_raster_grayscale_aa_rle(
+    const RasterBase::Resolution &res,
+    const RasterBase::PixelDim &  pxdim,
+    double                        gamma,
+    const RasterBase::Trafo &     tr)
+{
+    std::unique_ptr<RasterBase> rst;
+    
+    if (gamma > 0)
+        rst = std::make_unique<RasterGrayscaleAARLE>(res, pxdim, tr, agg::gamma_power(gamma));
+    else
+        rst = std::make_unique<RasterGrayscaleAARLE>(res, pxdim, tr, agg::gamma_threshold(.5));
+    
+    return rst;
+}
+
+void RasterGrayscaleAARLE::add_span(Row &row, int x, int len, uint8_t cover) const
+{
+    // Clip to the canvas, as agg::renderer_base would do.
+    int w = int(m_resolution.width_px);
+    if (x < 0) { len += x; x = 0; }
+    if (x + len > w) len = w - x;
+    if (len <= 0 || cover == 0) return;
+    
+    if (!row.empty() && row.back().cover == cover &&
+        row.back().x + row.back().len == uint32_t(x))
+        row.back().len += uint32_t(len);
+    else
+        row.push_back({uint32_t(x), uint32_t(len), cover});
+}
+
+// Blends m_incoming over the already rendered spans of the row. The result
+// is identical to what agg::renderer_scanline_aa_solid does with a white
+// color on the gray8 pixel format.
+void RasterGrayscaleAARLE::merge_row(Row &row)
+{
+    if (m_incoming.empty()) return;
+    if (row.empty()) { row = m_incoming; return; }
+    
+    const Row &in  = m_incoming;
+    const uint32_t None = std::numeric_limits<uint32_t>::max();
+    
+    m_merged.clear();
+    
+    // ax and bx are the starts of the not yet consumed parts of row[i] and
+    // in[j] respectively.
+    size_t i = 0, j = 0;
+    uint32_t ax = row.front().x, bx = in.front().x;
+    
+    while (i < row.size() || j < in.size()) {
+        uint32_t x    = std::min(ax, bx);
+        bool     in_a = ax == x, in_b = bx == x;
+        uint32_t aend = in_a ? row[i].x + row[i].len : ax;
+        uint32_t bend = in_b ? in[j].x + in[j].len : bx;
+        uint32_t end  = std::min(aend, bend);
+        
+        uint8_t px = in_a ? row[i].cover : 0;
+        if (in_b) {
+            uint8_t cover = in[j].cover;
+            px = cover == agg::cover_full ? agg::gray8::full_value() :
+                                            agg::gray8::lerp(px, agg::gray8::full_value(), cover);
+        }
+        
+        add_span(m_merged, int(x), int(end - x), px);
+        
+        if (in_a) ax = end < aend ? end : (++i < row.size() ? row[i].x : None);
+        if (in_b) bx = end < bend ? end : (++j < in.size() ? in[j].x : None);
+    }
+    
+    row.swap(m_merged);
+}
+
+void RasterGrayscaleAARLE::fill_row(size_t r, uint8_t *dst) const
+{
+    std::fill(dst, dst + m_resolution.width_px, uint8_t(0));
+    for (const Span &s : m_rows[r])
+        std::fill(dst + s.x, dst + s.x + s.len, s.cover);
+}
+
+uint8_t RasterGrayscaleAARLE::read_pixel(size_t col, size_t row) const
+{
+    const Row &spans = m_rows[row];
+    auto it = std::upper_bound(spans.begin(), spans.end(), col,
+                               [](size_t c, const Span &s) { return c < s.x; });
+    
+    if (it == spans.begin()) return 0;
+    --it;
+    
+    return col < it->x + it->len ? it->cover : 0;
+}
+
+void RasterGrayscaleAARLE::clear()
+{
+    for (Row &r : m_rows) Row().swap(r);
+}
+
+EncodedRaster RasterGrayscaleAARLE::encode(RasterEncoder encoder) const
+{
+    size_t w = m_resolution.width_px, h = m_resolution.height_px;
+    std::vector<uint8_t> buf(w * h);
+    for (size_t r = 0; r < h; ++r) fill_row(r, buf.data() + r * w);
+    
+    return encoder(buf.data(), w, h, 1);
+}
+
+EncodedRaster RasterGrayscaleAARLE::encode_rows(RasterRowEncoder encoder) const
+{
+    return encoder([this](size_t r, uint8_t *dst) { fill_row(r, dst); },
+                   m_resolution.width_px, m_resolution.height_px, 1);
+}
+
 } // namespace sla
 } // namespace Slic3r
 
@@ -7,6 +7,7 @@
 #include <array>
 #include <utility>
 #include <cstdint>
+#include <functional>
 
 #include <libslic3r/ExPolygon.hpp>
 #include <libslic3r/SLA/Concurrency.hpp>
@@ -34,6 +35,15 @@ public:
 using RasterEncoder =
     std::function<EncodedRaster(const void *ptr, size_t w, size_t h, size_t num_components)>;
 
+// Writes the pixels of one raster row (w * num_components bytes) into dst.
+// Has to be callable concurrently for different rows.
+using RasterRowFn = std::function<void(size_t row, uint8_t *dst)>;
+
+// Encoder consuming the raster row by row, so that the full bitmap does not
+// have to exist at any point.
+using RasterRowEncoder =
+    std::function<EncodedRaster(const RasterRowFn &rowfn, size_t w, size_t h, size_t num_components)>;
+
 class RasterBase {
 public:
     
@@ -95,10 +105,15 @@ public:
     virtual Trafo      trafo() const = 0;
     
     virtual EncodedRaster encode(RasterEncoder encoder) const = 0;
+    virtual EncodedRaster encode_rows(RasterRowEncoder encoder) const = 0;
 };
 
 struct PNGRasterEncoder {
     EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
+    
+    // Deflates independent bands of rows in parallel and joins them into a
+    // single zlib stream. Only one band per thread is held uncompressed.
+    EncodedRaster operator()(const RasterRowFn &rowfn, size_t w, size_t h, size_t num_components);
 };
 
 struct PPMRasterEncoder {
@@ -114,6 +129,13 @@ std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     double                        gamma = 1.0,
     const RasterBase::Trafo &     tr    = {});
 
+// Same as above, but the raster is stored as run-length encoded rows.
+std::unique_ptr<RasterBase> create_raster_grayscale_aa_rle(
+    const RasterBase::Resolution &res,
+    const RasterBase::PixelDim &  pxdim,
+    double                        gamma = 1.0,
+    const RasterBase::Trafo &     tr    = {});
+
 }} // namespace Slic3r::sla
 
 #endif // SLARASTERBASE_HPP
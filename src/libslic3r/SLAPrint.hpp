@@ -394,6 +394,10 @@ protected:
     virtual std::unique_ptr<sla::RasterBase> create_raster() const = 0;
     virtual sla::RasterEncoder get_encoder() const = 0;
     
+    // Archives able to consume the raster row by row should return a non
+    // empty encoder here, so the rasters don't have to be materialized.
+    virtual sla::RasterRowEncoder get_row_encoder() const { return {}; }
+    
 public:
     virtual ~SLAArchive() = default;
     
@@ -416,7 +420,10 @@ public:
                 sla::EncodedRaster &enc = m_layers[idx];
                 auto                rst = create_raster();
                 drawfn(*rst, idx);
-                enc = rst->encode(get_encoder());
+                if (auto rowenc = get_row_encoder())
+                    enc = rst->encode_rows(rowenc);
+                else
+                    enc = rst->encode(get_encoder());
             },
             execution::max_concurrency(ep));
     }
@@ -9,9 +9,14 @@
 #include "KDTreeIndirect.hpp"
 #include "MutablePriorityQueue.hpp"
 #include "Print.hpp"
+#include "BoundingBox.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cassert>
+#include <numeric>
+
+#include <tbb/parallel_for.h>
 
 namespace Slic3r {
 
@@ -998,11 +1003,104 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy2(SegmentEndPointFunc
 	return chain_segments_greedy_constrained_reversals2_<PointType, SegmentEndPointFunc, false, decltype(could_reverse_func)>(end_point_func, could_reverse_func, num_segments, start_near);
 }
 
-std::vector<std::pair<size_t, bool>> chain_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near)
+// Spatially partitioned chaining of a large number of segments.
+// The greedy chainers above are single threaded and their cost grows super-linearly with the number of segments.
+// Here the segments are binned by their centers into a grid of cells, the cells are visited in a boustrophedon order
+// (left to right on even rows, right to left on odd rows) and each cell is chained independently and in parallel,
+// starting at the point of the cell closest to the center of the previous non-empty cell.
+// chain_cell(segments, start_near) chains a subset of segments, returning indices into the subset.
+template<typename SegmentEndPointFunc, typename ChainCellFunc>
+std::vector<std::pair<size_t, bool>> chain_segments_partitioned(SegmentEndPointFunc end_point_func, size_t num_segments, const Point *start_near, ChainCellFunc chain_cell)
+{
+	// Target number of segments chained by a single greedy chainer.
+	static constexpr const size_t segments_per_cell = 1000;
+
+	std::vector<Vec2d> centers;
+	centers.reserve(num_segments);
+	BoundingBoxf bbox;
+	for (size_t i = 0; i < num_segments; ++ i) {
+		centers.emplace_back(0.5 * (end_point_func(i, true).template cast<double>() + end_point_func(i, false).template cast<double>()));
+		bbox.merge(centers.back());
+	}
+	if (num_segments <= segments_per_cell || ! bbox.defined) {
+		std::vector<size_t> all(num_segments);
+		std::iota(all.begin(), all.end(), 0);
+		return chain_cell(all, start_near);
+	}
+
+	const Vec2d  size      = bbox.size().cwiseMax(Vec2d(1., 1.));
+	const size_t num_cells = (num_segments + segments_per_cell - 1) / segments_per_cell;
+	const size_t cols      = std::clamp<size_t>(size_t(std::round(std::sqrt(double(num_cells) * size.x() / size.y()))), 1, num_cells);
+	const size_t rows      = (num_cells + cols - 1) / cols;
+	const Vec2d  cell_size(size.x() / double(cols), size.y() / double(rows));
+	auto cell_rect = [&bbox, &cell_size](size_t row, size_t col) {
+		Vec2d min = bbox.min + Vec2d(cell_size.x() * double(col), cell_size.y() * double(row));
+		return std::make_pair(min, Vec2d(min + cell_size));
+	};
+
+	// Cells are numbered in the order of their visit.
+	std::vector<std::vector<size_t>> cells(rows * cols);
+	for (size_t i = 0; i < num_segments; ++ i) {
+		Vec2d  p   = (centers[i] - bbox.min).cwiseQuotient(cell_size);
+		size_t row = std::min(rows - 1, size_t(std::max(0., p.y())));
+		size_t col = std::min(cols - 1, size_t(std::max(0., p.x())));
+		cells[row * cols + ((row & 1) ? cols - 1 - col : col)].emplace_back(i);
+	}
+
+	// Entry point of each non-empty cell.
+	std::vector<size_t> non_empty;
+	std::vector<Point>  cell_start;
+	for (size_t idx = 0; idx < cells.size(); ++ idx)
+		if (! cells[idx].empty()) {
+			size_t row = idx / cols;
+			size_t col = (row & 1) ? cols - 1 - idx % cols : idx % cols;
+			auto [min, max] = cell_rect(row, col);
+			if (non_empty.empty())
+				// The first cell starts near start_near, if provided.
+				cell_start.emplace_back(start_near ? *start_near : Point(0, 0));
+			else {
+				size_t prev_idx = non_empty.back();
+				size_t prev_row = prev_idx / cols;
+				size_t prev_col = (prev_row & 1) ? cols - 1 - prev_idx % cols : prev_idx % cols;
+				auto [prev_min, prev_max] = cell_rect(prev_row, prev_col);
+				Vec2d prev_center = 0.5 * (prev_min + prev_max);
+				cell_start.emplace_back(prev_center.cwiseMax(min).cwiseMin(max).template cast<coord_t>());
+			}
+			non_empty.emplace_back(idx);
+		}
+
+	std::vector<std::vector<std::pair<size_t, bool>>> chains(non_empty.size());
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, non_empty.size()), [&](const tbb::blocked_range<size_t> &range) {
+		for (size_t i = range.begin(); i < range.end(); ++ i)
+			chains[i] = chain_cell(cells[non_empty[i]], (i == 0 && start_near == nullptr) ? nullptr : &cell_start[i]);
+	});
+
+	std::vector<std::pair<size_t, bool>> out;
+	out.reserve(num_segments);
+	for (size_t i = 0; i < non_empty.size(); ++ i)
+		for (const std::pair<size_t, bool> &segment : chains[i])
+			out.emplace_back(cells[non_empty[i]][segment.first], segment.second);
+	assert(out.size() == num_segments);
+	return out;
+}
+
+static inline bool chain_partitioned(ChainingMode mode, size_t num_segments)
+{
+	return mode == ChainingMode::Partitioned || (mode == ChainingMode::Auto && num_segments >= ChainPartitionedMinSegments);
+}
+
+std::vector<std::pair<size_t, bool>> chain_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near, ChainingMode mode)
 {
 	auto segment_end_point = [&entities](size_t idx, bool first_point) -> const Point& { return first_point ? entities[idx]->first_point() : entities[idx]->last_point(); };
 	auto could_reverse = [&entities](size_t idx) { const ExtrusionEntity *ee = entities[idx]; return ee->is_loop() || ee->can_reverse(); };
-	std::vector<std::pair<size_t, bool>> out = chain_segments_greedy_constrained_reversals<Point, decltype(segment_end_point), decltype(could_reverse)>(segment_end_point, could_reverse, entities.size(), start_near);
+	auto chain_cell = [&segment_end_point, &could_reverse](const std::vector<size_t> &segments, const Point *start_near) {
+		auto cell_end_point     = [&segments, &segment_end_point](size_t idx, bool first_point) -> const Point& { return segment_end_point(segments[idx], first_point); };
+		auto cell_could_reverse = [&segments, &could_reverse](size_t idx) { return could_reverse(segments[idx]); };
+		return chain_segments_greedy_constrained_reversals<Point, decltype(cell_end_point), decltype(cell_could_reverse)>(cell_end_point, cell_could_reverse, segments.size(), start_near);
+	};
+	std::vector<std::pair<size_t, bool>> out = chain_partitioned(mode, entities.size()) ?
+		chain_segments_partitioned(segment_end_point, entities.size(), start_near, chain_cell) :
+		chain_segments_greedy_constrained_reversals<Point, decltype(segment_end_point), decltype(could_reverse)>(segment_end_point, could_reverse, entities.size(), start_near);
 	for (std::pair<size_t, bool> &segment : out) {
 		ExtrusionEntity *ee = entities[segment.first];
 		if (ee->is_loop())
@@ -1918,7 +2016,7 @@ static inline void improve_ordering_by_two_exchanges_with_segment_flipping(Polyl
 }
 
 // Used to optimize order of infill lines and brim lines.
-Polylines chain_polylines(Polylines &&polylines, const Point *start_near)
+Polylines chain_polylines(Polylines &&polylines, const Point *start_near, ChainingMode mode)
 {
 #ifdef DEBUG_SVG_OUTPUT
 	static int iRun = 0;
@@ -1929,14 +2027,22 @@ Polylines chain_polylines(Polylines &&polylines, const Point *start_near)
 	Polylines out;
 	if (! polylines.empty()) {
 		auto segment_end_point = [&polylines](size_t idx, bool first_point) -> const Point& { return first_point ? polylines[idx].first_point() : polylines[idx].last_point(); };
-		std::vector<std::pair<size_t, bool>> ordered = chain_segments_greedy2<Point, decltype(segment_end_point)>(segment_end_point, polylines.size(), start_near);
+		const bool partitioned = chain_partitioned(mode, polylines.size());
+		std::vector<std::pair<size_t, bool>> ordered = partitioned ?
+			chain_segments_partitioned(segment_end_point, polylines.size(), start_near, [&segment_end_point](const std::vector<size_t> &segments, const Point *start_near) {
+				// chain_segments_greedy2() may lose segments if start_near is set, cells are always chained from an entry point.
+				auto cell_end_point = [&segments, &segment_end_point](size_t idx, bool first_point) -> const Point& { return segment_end_point(segments[idx], first_point); };
+				return chain_segments_greedy<Point, decltype(cell_end_point)>(cell_end_point, segments.size(), start_near);
+			}) :
+			chain_segments_greedy2<Point, decltype(segment_end_point)>(segment_end_point, polylines.size(), start_near);
 		out.reserve(polylines.size()); 
 		for (auto &segment_and_reversal : ordered) {
 			out.emplace_back(std::move(polylines[segment_and_reversal.first]));
 			if (segment_and_reversal.second)
 				out.back().reverse();
 		}
-		if (out.size() > 1 && start_near == nullptr) {
+		// The exchanges are not localized, they would undo the partitioning and they are too expensive for large inputs.
+		if (out.size() > 1 && start_near == nullptr && ! partitioned) {
 			improve_ordering_by_two_exchanges_with_segment_flipping(out, start_near != nullptr);
 			//improve_ordering_by_segment_flipping(out, start_near != nullptr);
 		}
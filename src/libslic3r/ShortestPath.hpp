@@ -12,9 +12,20 @@ namespace ClipperLib { class PolyNode; }
 
 namespace Slic3r {
 
+// How chain_extrusion_entities() and chain_polylines() order large sets of segments.
+enum class ChainingMode {
+	// Partitioned for at least ChainPartitionedMinSegments segments, greedy otherwise.
+	Auto,
+	// Greedy nearest neighbor chaining over all the segments.
+	Greedy,
+	// Segments are binned into grid cells, the cells are chained in parallel and stitched in a snake order.
+	Partitioned,
+};
+static constexpr const size_t ChainPartitionedMinSegments = 5000;
+
 std::vector<size_t> 				 chain_points(const Points &points, Point *start_near = nullptr);
 
-std::vector<std::pair<size_t, bool>> chain_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near = nullptr);
+std::vector<std::pair<size_t, bool>> chain_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near = nullptr, ChainingMode mode = ChainingMode::Auto);
 void                                 reorder_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const std::vector<std::pair<size_t, bool>> &chain);
 void                                 chain_and_reorder_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near = nullptr);
 
@@ -22,8 +33,8 @@ std::vector<std::pair<size_t, bool>> chain_extrusion_paths(std::vector<Extrusion
 void                                 reorder_extrusion_paths(std::vector<ExtrusionPath> &extrusion_paths, std::vector<std::pair<size_t, bool>> &chain);
 void                                 chain_and_reorder_extrusion_paths(std::vector<ExtrusionPath> &extrusion_paths, const Point *start_near = nullptr);
 
-Polylines 							 chain_polylines(Polylines &&src, const Point *start_near = nullptr);
-inline Polylines 					 chain_polylines(const Polylines& src, const Point* start_near = nullptr) { Polylines tmp(src); return chain_polylines(std::move(tmp), start_near); }
+Polylines 							 chain_polylines(Polylines &&src, const Point *start_near = nullptr, ChainingMode mode = ChainingMode::Auto);
+inline Polylines 					 chain_polylines(const Polylines& src, const Point* start_near = nullptr, ChainingMode mode = ChainingMode::Auto) { Polylines tmp(src); return chain_polylines(std::move(tmp), start_near, mode); }
 
 std::vector<ClipperLib::PolyNode*>	 chain_clipper_polynodes(const Points &points, const std::vector<ClipperLib::PolyNode*> &items);
 
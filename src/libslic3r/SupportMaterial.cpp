@@ -13,8 +13,8 @@
 #include <boost/log/trivial.hpp>
 #include <boost/container/static_vector.hpp>
 
+#include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
-#include <tbb/spin_mutex.h>
 #include <tbb/task_group.h>
 
 #define SUPPORT_USE_AGG_RASTERIZER
@@ -419,27 +419,41 @@ PrintObjectSupportMaterial::PrintObjectSupportMaterial(const PrintObject *object
         (m_support_params.interface_density > 0.95 ? ipRectilinear : ipSupportBase);
 }
 
-// Using the std::deque as an allocator.
-inline PrintObjectSupportMaterial::MyLayer& layer_allocate(
-    std::deque<PrintObjectSupportMaterial::MyLayer> &layer_storage, 
-    PrintObjectSupportMaterial::SupporLayerType      layer_type)
-{ 
-    layer_storage.push_back(PrintObjectSupportMaterial::MyLayer());
-    layer_storage.back().layer_type = layer_type;
-    return layer_storage.back();
+struct PrintObjectSupportMaterial::MyLayerStorage::ThreadChunks
+{
+    // Number of layers allocated at once by a single thread.
+    static constexpr size_t chunk_size = 64;
+
+    std::vector<std::unique_ptr<MyLayer[]>> chunks;
+    // Number of layers used from the last chunk.
+    size_t                                  last_chunk_used { chunk_size };
+};
+
+struct PrintObjectSupportMaterial::MyLayerStorage::Chunks
+{
+    tbb::enumerable_thread_specific<ThreadChunks> per_thread;
+};
+
+PrintObjectSupportMaterial::MyLayerStorage::MyLayerStorage() : m_chunks(std::make_unique<Chunks>()) {}
+PrintObjectSupportMaterial::MyLayerStorage::~MyLayerStorage() = default;
+
+PrintObjectSupportMaterial::MyLayer& PrintObjectSupportMaterial::MyLayerStorage::allocate(SupporLayerType layer_type)
+{
+    ThreadChunks &thread_chunks = m_chunks->per_thread.local();
+    if (thread_chunks.last_chunk_used == ThreadChunks::chunk_size) {
+        thread_chunks.chunks.emplace_back(std::make_unique<MyLayer[]>(ThreadChunks::chunk_size));
+        thread_chunks.last_chunk_used = 0;
+    }
+    MyLayer &layer_new = thread_chunks.chunks.back()[thread_chunks.last_chunk_used ++];
+    layer_new.layer_type = layer_type;
+    return layer_new;
 }
 
 inline PrintObjectSupportMaterial::MyLayer& layer_allocate(
-    std::deque<PrintObjectSupportMaterial::MyLayer> &layer_storage,
-    tbb::spin_mutex                                 &layer_storage_mutex,
+    PrintObjectSupportMaterial::MyLayerStorage      &layer_storage,
     PrintObjectSupportMaterial::SupporLayerType      layer_type)
-{ 
-    layer_storage_mutex.lock();
-    layer_storage.push_back(PrintObjectSupportMaterial::MyLayer());
-    PrintObjectSupportMaterial::MyLayer *layer_new = &layer_storage.back();
-    layer_storage_mutex.unlock();
-    layer_new->layer_type = layer_type;
-    return *layer_new;
+{
+    return layer_storage.allocate(layer_type);
 }
 
 inline void layers_append(PrintObjectSupportMaterial::MyLayersPtr &dst, const PrintObjectSupportMaterial::MyLayersPtr &src)
@@ -460,7 +474,7 @@ void PrintObjectSupportMaterial::generate(PrintObject &object)
     for (size_t i = 0; i < object.layer_count(); ++ i)
         max_object_layer_height = std::max(max_object_layer_height, object.layers()[i]->height);
 
-    // Layer instances will be allocated by std::deque and they will be kept until the end of this function call.
+    // Layer instances will be allocated by MyLayerStorage and they will be kept until the end of this function call.
     // The layers will be referenced by various LayersPtr (of type std::vector<Layer*>)
     MyLayerStorage layer_storage;
 
@@ -1814,8 +1828,7 @@ static inline std::pair<PrintObjectSupportMaterial::MyLayer*, PrintObjectSupport
     const SlicingParameters                             &slicing_params,
     const coordf_t                                       support_layer_height_min,
     const Layer                                         &layer, 
-    std::deque<PrintObjectSupportMaterial::MyLayer>     &layer_storage,
-    tbb::spin_mutex                                     &layer_storage_mutex)
+    PrintObjectSupportMaterial::MyLayerStorage          &layer_storage)
 {
     double print_z, bottom_z, height;
     PrintObjectSupportMaterial::MyLayer* bridging_layer = nullptr;
@@ -1878,7 +1891,7 @@ static inline std::pair<PrintObjectSupportMaterial::MyLayer*, PrintObjectSupport
                 }
                 if (bridging_print_z < print_z - EPSILON) {
                     // Allocate the new layer.
-                    bridging_layer = &layer_allocate(layer_storage, layer_storage_mutex, PrintObjectSupportMaterial::sltTopContact);
+                    bridging_layer = &layer_allocate(layer_storage, PrintObjectSupportMaterial::sltTopContact);
                     bridging_layer->idx_object_layer_above = layer_id;
                     bridging_layer->print_z = bridging_print_z;
                     if (bridging_print_z == slicing_params.first_print_layer_height) {
@@ -1896,7 +1909,7 @@ static inline std::pair<PrintObjectSupportMaterial::MyLayer*, PrintObjectSupport
         }
     }
 
-    PrintObjectSupportMaterial::MyLayer &new_layer = layer_allocate(layer_storage, layer_storage_mutex, PrintObjectSupportMaterial::sltTopContact);
+    PrintObjectSupportMaterial::MyLayer &new_layer = layer_allocate(layer_storage, PrintObjectSupportMaterial::sltTopContact);
     new_layer.idx_object_layer_above = layer_id;
     new_layer.print_z  = print_z;
     new_layer.bottom_z = bottom_z;
@@ -2197,7 +2210,6 @@ PrintObjectSupportMaterial::MyLayersPtr PrintObjectSupportMaterial::top_contact_
     // For each overhang layer, two supporting layers may be generated: One for the overhangs extruded with a bridging flow, 
     // and the other for the overhangs extruded with a normal flow.
     contact_out.assign(num_layers * 2, nullptr);
-    tbb::spin_mutex layer_storage_mutex;
 
     std::vector<Polygons> overhangs_per_layers(num_layers);
     for (size_t layer_id = this->has_raft() ? 0 : 1; layer_id < num_layers; layer_id++) {
@@ -2330,7 +2342,7 @@ PrintObjectSupportMaterial::MyLayersPtr PrintObjectSupportMaterial::top_contact_
         // Now apply the contact areas to the layer where they need to be made.
         if (!contact_polygons.empty() || !overhang_polygons.empty()) {
             // Allocate the two empty layers.
-            auto [new_layer, bridging_layer] = new_contact_layer(*m_print_config, *m_object_config, m_slicing_params, m_support_params.support_layer_height_min, layer, layer_storage, layer_storage_mutex);
+            auto [new_layer, bridging_layer] = new_contact_layer(*m_print_config, *m_object_config, m_slicing_params, m_support_params.support_layer_height_min, layer, layer_storage);
             if (new_layer) {
                 // Fill the non-bridging layer with polygons.
                 fill_contact_layer(*new_layer, layer_id, m_slicing_params,
@@ -2379,7 +2391,7 @@ static inline PrintObjectSupportMaterial::MyLayer* detect_bottom_contacts(
     // First top contact layer index overlapping with this new bottom interface layer.
     size_t                                            contact_idx,
     // To allocate a new layer from.
-    std::deque<PrintObjectSupportMaterial::MyLayer>  &layer_storage,
+    PrintObjectSupportMaterial::MyLayerStorage       &layer_storage,
     // To trim the support areas above this bottom interface layer with this newly created bottom interface layer.
     std::vector<Polygons>                            &layer_support_areas,
     // Support areas projected from top to bottom, starting with top support interfaces.
@@ -3460,9 +3472,8 @@ std::pair<PrintObjectSupportMaterial::MyLayersPtr, PrintObjectSupportMaterial::M
         auto smoothing_distance              = m_support_params.support_material_interface_flow.scaled_spacing() * 1.5;
         auto minimum_island_radius           = m_support_params.support_material_interface_flow.scaled_spacing() / m_support_params.interface_density;
         auto closing_distance                = smoothing_distance; // scaled<float>(m_object_config->support_closing_radius.value);
-        tbb::spin_mutex layer_storage_mutex;
         // Insert a new layer into base_interface_layers, if intersection with base exists.
-        auto insert_layer = [&layer_storage, &layer_storage_mutex, snug_supports, closing_distance, smoothing_distance, minimum_island_radius](
+        auto insert_layer = [&layer_storage, snug_supports, closing_distance, smoothing_distance, minimum_island_radius](
                 MyLayer &intermediate_layer, Polygons &bottom, Polygons &&top, const Polygons *subtract, SupporLayerType type) -> MyLayer* {
             assert(! bottom.empty() || ! top.empty());
             // Merge top into bottom, unite them with a safety offset.
@@ -3477,7 +3488,7 @@ std::pair<PrintObjectSupportMaterial::MyLayersPtr, PrintObjectSupportMaterial::M
                 //FIXME Remove non-printable tiny islands, let them be printed using the base support.
                 //bottom = opening(std::move(bottom), minimum_island_radius);
                 if (! bottom.empty()) {
-                    MyLayer &layer_new = layer_allocate(layer_storage, layer_storage_mutex, type);
+                    MyLayer &layer_new = layer_allocate(layer_storage, type);
                     layer_new.polygons   = std::move(bottom);
                     layer_new.print_z    = intermediate_layer.print_z;
                     layer_new.bottom_z   = intermediate_layer.bottom_z;
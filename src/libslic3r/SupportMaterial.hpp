@@ -146,10 +146,25 @@ public:
 	    bool                    with_sheath;
 	};
 
-	// Layers are allocated and owned by a deque. Once a layer is allocated, it is maintained
-	// up to the end of a generate() method. The layer storage may be replaced by an allocator class in the future, 
-	// which would allocate layers by multiple chunks.
-	typedef std::deque<MyLayer> 				MyLayerStorage;
+	// Layers are allocated and owned by a storage. Once a layer is allocated, it is maintained
+	// up to the end of a generate() method, when all of them are released at once.
+	// The layers are allocated by chunks from storages private to the allocating threads,
+	// so that the layers may be allocated from parallel loops without locking.
+	class MyLayerStorage {
+	public:
+		MyLayerStorage();
+		~MyLayerStorage();
+		// Thread safe. The address of the allocated layer is stable during the life time of the storage.
+		MyLayer& 	allocate(SupporLayerType layer_type);
+
+	private:
+		MyLayerStorage(const MyLayerStorage&) = delete;
+		MyLayerStorage& operator=(const MyLayerStorage&) = delete;
+
+		struct ThreadChunks;
+		struct Chunks;
+		std::unique_ptr<Chunks> m_chunks;
+	};
 	typedef std::vector<MyLayer*> 				MyLayersPtr;
 
 public:
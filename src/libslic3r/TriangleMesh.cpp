@@ -41,36 +41,35 @@ static void update_bounding_box(const indexed_triangle_set &its, TriangleMeshSta
     out.size                = out.max - out.min;    
 }
 
-static void fill_initial_stats(const indexed_triangle_set &its, TriangleMeshStats &out)
+// Returns the face neighbors to seed the topology cache with.
+static std::vector<Vec3i> fill_initial_stats(const indexed_triangle_set &its, TriangleMeshStats &out)
 {
     out.number_of_facets    = its.indices.size();
     out.volume              = its_volume(its);
     update_bounding_box(its, out);
 
-    const std::vector<Vec3i> face_neighbors = its_face_neighbors(its);
+    std::vector<Vec3i> face_neighbors = its_face_neighbors(its);
     out.number_of_parts = its_number_of_patches(its, face_neighbors);
     out.open_edges      = its_num_open_edges(face_neighbors);
+    return face_neighbors;
 }
 
-TriangleMesh::TriangleMesh(const std::vector<Vec3f> &vertices, const std::vector<Vec3i> &faces) : its { faces, vertices }
-{
-    fill_initial_stats(this->its, m_stats);
-}
+TriangleMesh::TriangleMesh(const std::vector<Vec3f> &vertices, const std::vector<Vec3i> &faces) : 
+    its { faces, vertices }, m_topology(std::make_shared<TriangleMeshTopology>(fill_initial_stats(this->its, m_stats)))
+{}
 
-TriangleMesh::TriangleMesh(std::vector<Vec3f> &&vertices, const std::vector<Vec3i> &&faces) : its { std::move(faces), std::move(vertices) }
-{
-    fill_initial_stats(this->its, m_stats);
-}
+TriangleMesh::TriangleMesh(std::vector<Vec3f> &&vertices, const std::vector<Vec3i> &&faces) : 
+    its { std::move(faces), std::move(vertices) }, m_topology(std::make_shared<TriangleMeshTopology>(fill_initial_stats(this->its, m_stats)))
+{}
 
-TriangleMesh::TriangleMesh(const indexed_triangle_set &its) : its(its)
-{
-    fill_initial_stats(this->its, m_stats);
-}
+TriangleMesh::TriangleMesh(const indexed_triangle_set &its) : 
+    its(its), m_topology(std::make_shared<TriangleMeshTopology>(fill_initial_stats(this->its, m_stats)))
+{}
 
-TriangleMesh::TriangleMesh(indexed_triangle_set &&its, const RepairedMeshErrors& errors/* = RepairedMeshErrors()*/) : its(std::move(its))
+TriangleMesh::TriangleMesh(indexed_triangle_set &&its, const RepairedMeshErrors& errors/* = RepairedMeshErrors()*/) : 
+    its(std::move(its)), m_topology(std::make_shared<TriangleMeshTopology>(fill_initial_stats(this->its, m_stats)))
 {
     m_stats.repaired_errors = errors;
-    fill_initial_stats(this->its, m_stats);
 }
 
 // #define SLIC3R_TRACE_REPAIR
@@ -204,7 +203,7 @@ bool TriangleMesh::from_stl(stl_file& stl, bool repair)
 #endif
 
     stl_generate_shared_vertices(&stl, this->its);
-    fill_initial_stats(this->its, this->m_stats);
+    m_topology = std::make_shared<TriangleMeshTopology>(fill_initial_stats(this->its, this->m_stats));
     return true;
 }
 
@@ -327,6 +326,7 @@ void TriangleMesh::mirror(const Axis axis)
         return;
     };
     its_flip_triangles(this->its);
+    this->invalidate_topology();
     int iaxis = int(axis);
     std::swap(m_stats.min[iaxis], m_stats.max[iaxis]);
     m_stats.min[iaxis] *= -1.0;
@@ -339,6 +339,7 @@ void TriangleMesh::transform(const Transform3d& t, bool fix_left_handed)
     double det = t.matrix().block(0, 0, 3, 3).determinant();
     if (fix_left_handed && det < 0.) {
         its_flip_triangles(its);
+        this->invalidate_topology();
         det = -det;
     }
     m_stats.volume *= det;
@@ -351,6 +352,7 @@ void TriangleMesh::transform(const Matrix3d& m, bool fix_left_handed)
     double det = m.block(0, 0, 3, 3).determinant();
     if (fix_left_handed && det < 0.) {
         its_flip_triangles(its);
+        this->invalidate_topology();
         det = -det;
     }
     m_stats.volume *= det;
@@ -360,6 +362,7 @@ void TriangleMesh::transform(const Matrix3d& m, bool fix_left_handed)
 void TriangleMesh::flip_triangles()
 {
     its_flip_triangles(its);
+    this->invalidate_topology();
     m_stats.volume = - m_stats.volume;
 }
 
@@ -383,12 +386,12 @@ void TriangleMesh::rotate(double angle, Point* center)
  */
 bool TriangleMesh::is_splittable() const
 {
-    return its_is_splittable(this->its);
+    return its_is_splittable(this->its, this->face_neighbors());
 }
 
 std::vector<TriangleMesh> TriangleMesh::split() const
 {
-    std::vector<indexed_triangle_set> itss = its_split(this->its);
+    std::vector<indexed_triangle_set> itss = its_split<>(ItsNeighborsWrapper{ this->its, this->face_neighbors() });
     std::vector<TriangleMesh> out;
     out.reserve(itss.size());
     for (indexed_triangle_set &m : itss) {
@@ -406,6 +409,7 @@ void TriangleMesh::merge(const TriangleMesh &mesh)
 {
     its_merge(this->its, mesh.its);
     m_stats = m_stats.merge(mesh.m_stats);
+    this->invalidate_topology();
 }
 
 // Calculate projection of the mesh into the XY plane, in scaled coordinates.
@@ -518,6 +522,88 @@ std::vector<ExPolygons> TriangleMesh::slice(const std::vector<double> &z) const
 size_t TriangleMesh::memsize() const
 {
     size_t memsize = 8 + this->its.memsize() + sizeof(this->m_stats);
+    if (m_topology)
+        memsize += m_topology->memsize();
+    return memsize;
+}
+
+size_t TriangleMesh::release_optional()
+{
+    size_t released = m_topology ? m_topology->memsize() : 0;
+    // Copies of this mesh sharing the topology keep it.
+    this->invalidate_topology();
+    return released;
+}
+
+const std::vector<Vec3i>& TriangleMesh::face_neighbors() const
+{
+    assert(m_topology);
+    return m_topology->face_neighbors(this->its);
+}
+
+const std::vector<Vec3i>& TriangleMesh::face_edge_ids() const
+{
+    assert(m_topology);
+    return m_topology->face_edge_ids(this->its);
+}
+
+const VertexFaceIndex& TriangleMesh::vertex_faces() const
+{
+    assert(m_topology);
+    return m_topology->vertex_faces(this->its);
+}
+
+void TriangleMesh::invalidate_topology()
+{
+    m_topology = std::make_shared<TriangleMeshTopology>();
+}
+
+TriangleMeshTopology::TriangleMeshTopology(std::vector<Vec3i> &&face_neighbors)
+{
+    std::call_once(m_face_neighbors_once, [this, &face_neighbors]() {
+        m_face_neighbors = std::move(face_neighbors);
+        m_has_face_neighbors = true;
+    });
+}
+
+const std::vector<Vec3i>& TriangleMeshTopology::face_neighbors(const indexed_triangle_set &its) const
+{
+    std::call_once(m_face_neighbors_once, [this, &its]() {
+        m_face_neighbors = its_face_neighbors_par(its);
+        m_has_face_neighbors = true;
+    });
+    assert(m_face_neighbors.size() == its.indices.size());
+    return m_face_neighbors;
+}
+
+const std::vector<Vec3i>& TriangleMeshTopology::face_edge_ids(const indexed_triangle_set &its) const
+{
+    std::call_once(m_face_edge_ids_once, [this, &its]() {
+        m_face_edge_ids = its_face_edge_ids(its);
+        m_has_face_edge_ids = true;
+    });
+    assert(m_face_edge_ids.size() == its.indices.size());
+    return m_face_edge_ids;
+}
+
+const VertexFaceIndex& TriangleMeshTopology::vertex_faces(const indexed_triangle_set &its) const
+{
+    std::call_once(m_vertex_faces_once, [this, &its]() {
+        m_vertex_faces.create(its);
+        m_has_vertex_faces = true;
+    });
+    return m_vertex_faces;
+}
+
+size_t TriangleMeshTopology::memsize() const
+{
+    size_t memsize = sizeof(*this);
+    if (m_has_face_neighbors)
+        memsize += m_face_neighbors.capacity() * sizeof(Vec3i);
+    if (m_has_face_edge_ids)
+        memsize += m_face_edge_ids.capacity() * sizeof(Vec3i);
+    if (m_has_vertex_faces)
+        memsize += m_vertex_faces.memsize();
     return memsize;
 }
 
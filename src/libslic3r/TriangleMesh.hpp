@@ -3,7 +3,10 @@
 
 #include "libslic3r.h"
 #include <admesh/stl.h>
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include "BoundingBox.hpp"
 #include "Line.hpp"
@@ -15,6 +18,8 @@ namespace Slic3r {
 
 class TriangleMesh;
 class TriangleMeshSlicer;
+class TriangleMeshTopology;
+struct VertexFaceIndex;
 
 struct RepairedMeshErrors {
     // How many edges were united by merging their end points with some other end points in epsilon neighborhood?
@@ -92,7 +97,7 @@ public:
     TriangleMesh(std::vector<Vec3f> &&vertices, const std::vector<Vec3i> &&faces);
     explicit TriangleMesh(const indexed_triangle_set &M);
     explicit TriangleMesh(indexed_triangle_set &&M, const RepairedMeshErrors& repaired_errors = RepairedMeshErrors());
-    void clear() { this->its.clear(); this->m_stats.clear(); }
+    void clear() { this->its.clear(); this->m_stats.clear(); this->invalidate_topology(); }
     bool from_stl(stl_file& stl, bool repair = true);
     bool ReadSTLFile(const char* input_file, bool repair = true);
     bool write_ascii(const char* output_file);
@@ -143,19 +148,31 @@ public:
     // Estimate of the memory occupied by this structure, important for keeping an eye on the Undo / Redo stack allocation.
     size_t memsize() const;
 
-    // Used by the Undo / Redo stack, legacy interface. As of now there is nothing cached at TriangleMesh,
-    // but we may decide to cache some data in the future (for example normals), thus we keep the interface in place.
+    // Used by the Undo / Redo stack. The face topology cache is dropped, it will be rebuilt on demand.
     // Release optional data from the mesh if the object is on the Undo / Redo stack only. Returns the amount of memory released.
-    size_t release_optional() { return 0; }
+    size_t release_optional();
     // Restore optional data possibly released by release_optional().
     void   restore_optional() {}
 
     const TriangleMeshStats& stats() const { return m_stats; }
 
+    // Face topology of this->its, built on demand and shared by the copies of this mesh.
+    // Face neighbors as returned by its_face_neighbors().
+    const std::vector<Vec3i>&   face_neighbors() const;
+    // Unique edge identifiers as returned by its_face_edge_ids(its).
+    const std::vector<Vec3i>&   face_edge_ids() const;
+    // Faces incident to a vertex.
+    const VertexFaceIndex&      vertex_faces() const;
+    // To be called after this->its.indices were modified directly, not through the TriangleMesh methods.
+    void                        invalidate_topology();
+
     indexed_triangle_set its;
 
 private:
-    TriangleMeshStats m_stats;
+    TriangleMeshStats                       m_stats;
+    // Replaced, not modified, when the faces change, so that the copies of this mesh are not affected.
+    // Only null in a moved from mesh.
+    std::shared_ptr<TriangleMeshTopology>   m_topology { std::make_shared<TriangleMeshTopology>() };
 };
 
 // Index of face indices incident with a vertex index.
@@ -178,11 +195,42 @@ public:
 
     const Range<iterator> operator[](size_t vertex_id) const { return {begin(vertex_id), end(vertex_id)}; }
 
+    size_t   memsize() const { return (m_vertex_to_face_start.capacity() + m_vertex_faces_all.capacity()) * sizeof(size_t); }
+
 private:
     std::vector<size_t>     m_vertex_to_face_start;
     std::vector<size_t>     m_vertex_faces_all;
 };
 
+// Face topology of an indexed_triangle_set, which depends on the faces only, not on the vertex positions.
+// Each index is calculated on the first request and it is immutable afterwards, thus the topology may be shared
+// between threads and between copies of a TriangleMesh, for example by the meshes of ModelVolumes shared
+// between the Model, the Print and the Undo / Redo stack.
+class TriangleMeshTopology
+{
+public:
+    TriangleMeshTopology() = default;
+    // Seeded with the face neighbors calculated together with the mesh statistics.
+    explicit TriangleMeshTopology(std::vector<Vec3i> &&face_neighbors);
+
+    const std::vector<Vec3i>&   face_neighbors(const indexed_triangle_set &its) const;
+    const std::vector<Vec3i>&   face_edge_ids(const indexed_triangle_set &its) const;
+    const VertexFaceIndex&      vertex_faces(const indexed_triangle_set &its) const;
+    // Memory occupied by the indices calculated so far.
+    size_t                      memsize() const;
+
+private:
+    mutable std::once_flag      m_face_neighbors_once;
+    mutable std::once_flag      m_face_edge_ids_once;
+    mutable std::once_flag      m_vertex_faces_once;
+    mutable std::atomic<bool>   m_has_face_neighbors { false };
+    mutable std::atomic<bool>   m_has_face_edge_ids { false };
+    mutable std::atomic<bool>   m_has_vertex_faces { false };
+    mutable std::vector<Vec3i>  m_face_neighbors;
+    mutable std::vector<Vec3i>  m_face_edge_ids;
+    mutable VertexFaceIndex     m_vertex_faces;
+};
+
 // Map from a face edge to a unique edge identifier or -1 if no neighbor exists.
 // Two neighbor faces share a unique edge identifier even if they are flipped.
 // Used for chaining slice lines into polygons.
@@ -376,6 +424,7 @@ namespace cereal {
     template<class Archive> void load(Archive &archive, Slic3r::TriangleMesh &mesh) {
         archive.loadBinary(reinterpret_cast<char*>(const_cast<Slic3r::TriangleMeshStats*>(&mesh.stats())), sizeof(Slic3r::TriangleMeshStats));
         archive(mesh.its.indices, mesh.its.vertices);
+        mesh.invalidate_topology();
     }
     template<class Archive> void save(Archive &archive, const Slic3r::TriangleMesh &mesh) {
         archive.saveBinary(reinterpret_cast<const char*>(&mesh.stats()), sizeof(Slic3r::TriangleMeshStats));
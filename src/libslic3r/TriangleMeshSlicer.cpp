@@ -1710,7 +1710,11 @@ std::vector<Polygons> slice_mesh(
         // Instead of edge identifiers, one shall use a sorted pair of edge vertex indices.
         // However facets_edges assigns a single edge ID to two triangles only, thus when factoring facets_edges out, one will have
         // to make sure that no code relies on it.
-        std::vector<Vec3i> face_edge_ids = its_face_edge_ids(mesh);
+        std::vector<Vec3i>        face_edge_ids_local;
+        if (params.face_edge_ids == nullptr)
+            face_edge_ids_local = its_face_edge_ids(mesh);
+        const std::vector<Vec3i> &face_edge_ids = params.face_edge_ids ? *params.face_edge_ids : face_edge_ids_local;
+        assert(face_edge_ids.size() == mesh.indices.size());
         if (zs.size() <= 1) {
             // It likely is not worthwile to copy the vertices. Apply the transformation in place.
             if (is_identity(params.trafo)) {
@@ -33,6 +33,9 @@ struct MeshSlicingParams
     SlicingMode   mode_below { SlicingMode::Regular };
     // Transforming faces during the slicing.
     Transform3d   trafo { Transform3d::Identity() };
+    // Optional its_face_edge_ids() of the sliced mesh, for example cached by TriangleMesh::face_edge_ids().
+    // Calculated by slice_mesh() if not provided.
+    const std::vector<Vec3i> *face_edge_ids { nullptr };
 };
 
 struct MeshSlicingParamsEx : public MeshSlicingParams
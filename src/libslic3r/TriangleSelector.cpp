@@ -1254,7 +1254,7 @@ void TriangleSelector::garbage_collect()
 }
 
 TriangleSelector::TriangleSelector(const TriangleMesh& mesh, float edge_limit)
-    : m_mesh{mesh}, m_neighbors(its_face_neighbors(mesh.its)), m_face_normals(its_face_normals(mesh.its)), m_edge_limit(edge_limit)
+    : m_mesh{mesh}, m_neighbors(mesh.face_neighbors()), m_face_normals(its_face_normals(mesh.its)), m_edge_limit(edge_limit)
 {
     reset();
 }
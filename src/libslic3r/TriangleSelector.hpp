@@ -360,7 +360,8 @@ protected:
     std::vector<Vertex> m_vertices;
     std::vector<Triangle> m_triangles;
     const TriangleMesh &m_mesh;
-    const std::vector<Vec3i> m_neighbors;
+    // Face neighbors cached by m_mesh.
+    const std::vector<Vec3i> &m_neighbors;
     const std::vector<Vec3f> m_face_normals;
 
     // BBS
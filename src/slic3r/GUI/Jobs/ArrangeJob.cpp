@@ -765,6 +765,8 @@ arrangement::ArrangeParams get_arrange_params(Plater *p)
     params.is_seq_print = settings.is_seq_print;
     params.bed_shrink_x = settings.bed_shrink_x;
     params.bed_shrink_y = settings.bed_shrink_y;
+    // Projects often span many plates, try the items on all of them concurrently.
+    params.parallel_beds = true;
 
     return params;
 }
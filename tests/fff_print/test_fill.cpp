@@ -190,6 +190,113 @@ TEST_CASE("Fill: Pattern Path Length", "[Fill]") {
     }
 }
 
+TEST_CASE("Fill: honeycomb pattern shared by layers", "[Fill]") {
+    ExPolygons islands;
+    for (int i = 0; i < 4; ++ i) {
+        Polygon island = Polygon::new_scale({ { 0, 0 }, { 5, 0 }, { 5, 3 }, { 0, 3 } });
+        island.translate(Point::new_scale(i * 20 + 1, i * 15 + 2));
+        islands.emplace_back(island);
+    }
+    FillPatternCache pattern_cache;
+    for (size_t layer_id = 0; layer_id < 6; ++ layer_id) {
+        double length[2];
+        for (int shared = 0; shared < 2; ++ shared) {
+            std::unique_ptr<Fill> filler(Fill::new_from_type(ipHoneycomb));
+            filler->bounding_box  = BoundingBox(Point(0, 0), Point::new_scale(100, 100));
+            filler->spacing       = 0.45;
+            filler->layer_id      = layer_id;
+            filler->pattern_cache = shared ? &pattern_cache : nullptr;
+            FillParams fill_params;
+            fill_params.density           = 0.2f;
+            fill_params.anchor_length_max = 0.f;
+            length[shared] = 0.;
+            for (const ExPolygon &island : islands) {
+                Surface surface(stInternal, island);
+                for (const Polyline &polyline : filler->fill_surface(&surface, fill_params))
+                    length[shared] += unscale<double>(polyline.length());
+            }
+        }
+        REQUIRE(length[0] > 0.);
+        REQUIRE(length[1] == Approx(length[0]).epsilon(1e-3));
+    }
+}
+
+TEST_CASE("Fill: band spans of a region", "[Fill]") {
+    ExPolygon ring(Polygon::new_scale({ { 0, 0 }, { 40, 0 }, { 40, 30 }, { 0, 30 } }));
+    ring.holes.emplace_back(Polygon::new_scale({ { 5, 5 }, { 5, 25 }, { 35, 25 }, { 35, 5 } }));
+    ring.rotate(0.3);
+    Polygons polygons = to_polygons(ring);
+    polygons.emplace_back(Polygon::new_scale({ { 50, 0 }, { 60, 10 }, { 50, 20 } }));
+
+    const coord_t y_min     = - scaled<coord_t>(10.) + 17;
+    const coord_t step      = scaled<coord_t>(1.3);
+    const coord_t height    = scaled<coord_t>(2.1);
+    const size_t  num_bands = 40;
+    const coord_t min_gap   = scaled<coord_t>(0.5);
+    std::vector<Fill::Spans> spans = Fill::_band_spans(polygons, y_min, step, height, num_bands, min_gap);
+    REQUIRE(spans.size() == num_bands);
+
+    const BoundingBox bbox = get_extents(polygons);
+    for (size_t i = 0; i < num_bands; ++ i) {
+        // Project the parts of the polygons inside the band clipped by Clipper.
+        coord_t   lo = y_min + coord_t(i) * step;
+        Polygon   band({ { bbox.min.x() - 1000, lo }, { bbox.max.x() + 1000, lo }, { bbox.max.x() + 1000, lo + height }, { bbox.min.x() - 1000, lo + height } });
+        Fill::Spans expected;
+        for (const ExPolygon &expoly : intersection_ex(polygons, Polygons{ band })) {
+            BoundingBox bb = get_extents(expoly);
+            expected.emplace_back(bb.min.x(), bb.max.x());
+        }
+        std::sort(expected.begin(), expected.end());
+        Fill::Spans merged;
+        for (const std::pair<coord_t, coord_t> &span : expected)
+            if (! merged.empty() && span.first <= merged.back().second + min_gap)
+                merged.back().second = std::max(merged.back().second, span.second);
+            else
+                merged.emplace_back(span);
+        REQUIRE(spans[i].size() == merged.size());
+        for (size_t j = 0; j < merged.size(); ++ j) {
+            REQUIRE(std::abs(spans[i][j].first - merged[j].first) <= 2);
+            REQUIRE(std::abs(spans[i][j].second - merged[j].second) <= 2);
+        }
+    }
+}
+
+TEST_CASE("Fill: gyroid over an island with two spans narrower than a single period", "[Fill]") {
+    // U shaped island 9mm wide with a 6mm wide slot, narrower than a single period of the gyroid (2 PI * 1.84mm),
+    // thus the bands crossing the slot contain two spans covered by a single period of the wave.
+    Polygon u_shape = Polygon::new_scale({ { 0.1, 0.1 }, { 9.1, 0.1 }, { 9.1, 40 }, { 7.6, 40 }, { 7.6, 2 }, { 1.6, 2 }, { 1.6, 40 }, { 0.1, 40 } });
+    for (bool rotated : { false, true }) {
+        ExPolygon island(u_shape);
+        if (rotated) {
+            // Exchange x and y to test the waves in both directions.
+            for (Point &pt : island.contour.points)
+                std::swap(pt.x(), pt.y());
+            island.contour.reverse();
+        }
+        for (double z : { 0.2, 1.4 }) {
+            std::unique_ptr<Fill> filler(Fill::new_from_type(ipGyroid));
+            filler->bounding_box = get_extents(island);
+            filler->spacing      = 0.45;
+            filler->z            = z;
+            // Compensate the correction angle of the gyroid to keep the island axis aligned.
+            filler->angle        = float(M_PI / 4.);
+            FillParams fill_params;
+            fill_params.density           = 0.1f;
+            fill_params.anchor_length_max = 0.f;
+            Surface surface(stInternal, island);
+            Polylines polylines = filler->fill_surface(&surface, fill_params);
+            REQUIRE(! polylines.empty());
+            for (size_t i = 0; i < polylines.size(); ++ i)
+                for (size_t j = i + 1; j < polylines.size(); ++ j) {
+                    Polyline reversed = polylines[j];
+                    reversed.reverse();
+                    REQUIRE(polylines[i].points != polylines[j].points);
+                    REQUIRE(polylines[i].points != reversed.points);
+                }
+        }
+    }
+}
+
 /*
 {
     my $collection = Slic3r::Polyline::Collection->new(
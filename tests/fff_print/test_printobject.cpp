@@ -87,3 +87,256 @@ SCENARIO("PrintObject: object layer heights", "[PrintObject]") {
 #endif
     }
 }
+
+SCENARIO("PrintObject: changing the config of a layer height range", "[PrintObject]") {
+    GIVEN("20mm cube with 3 walls between 5mm and 10mm") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "layer_height",               0.2 },
+            { "initial_layer_print_height", 0.2 },
+            { "wall_loops",                 2 },
+            { "sparse_infill_density",      "20%" }
+        });
+        auto set_range = [](Model &model, int wall_loops) {
+            ModelConfig &range_config = model.objects.front()->layer_config_ranges[{ 5., 10. }];
+            range_config.set("layer_height", 0.2);
+            range_config.set("wall_loops", wall_loops);
+        };
+        auto wall_loops = [](const Layer &layer) {
+            size_t loops = 0;
+            for (const LayerRegion *layerm : layer.regions())
+                loops += layerm->perimeters.items_count();
+            return loops;
+        };
+        Print print;
+        Model model;
+        init_print({ TestMesh::cube_20x20x20 }, print, model, config);
+        set_range(model, 3);
+        print.apply(model, config);
+        print.process();
+        const PrintObject &object = *print.objects().front();
+        // Tag the perimeters of all layers with an empty collection, which is dropped if the perimeters of a layer are regenerated.
+        for (Layer *layer : print.get_object(0)->layers())
+            for (size_t region_id = 0; region_id < layer->region_count(); ++ region_id)
+                layer->get_region(int(region_id))->perimeters.entities.push_back(new ExtrusionEntityCollection());
+        auto perimeters_tagged = [](const LayerRegion &layerm) {
+            const auto *last = layerm.perimeters.empty() ? nullptr : dynamic_cast<const ExtrusionEntityCollection*>(layerm.perimeters.entities.back());
+            return last != nullptr && last->empty();
+        };
+
+        WHEN("the number of walls of the layer height range is changed to 4") {
+            set_range(model, 4);
+            print.apply(model, config);
+            print.process();
+            THEN("the layers inside the range have 4 walls, the other layers keep 2 walls") {
+                for (const Layer *layer : object.layers())
+                    REQUIRE(wall_loops(*layer) == (layer->slice_z > 5. && layer->slice_z < 10. ? 4 : 2));
+            }
+            THEN("only the perimeters of the layers inside the range are regenerated") {
+                for (const Layer *layer : object.layers())
+                    for (const LayerRegion *layerm : layer->regions())
+                        if (! layerm->slices.empty())
+                            REQUIRE(perimeters_tagged(*layerm) == (layer->slice_z < 5. || layer->slice_z > 10.));
+            }
+            THEN("the perimeters and infills match a print processed from scratch") {
+                Print print_scratch;
+                Model model_scratch;
+                init_print({ TestMesh::cube_20x20x20 }, print_scratch, model_scratch, config);
+                set_range(model_scratch, 4);
+                print_scratch.apply(model_scratch, config);
+                print_scratch.process();
+                const PrintObject &object_scratch = *print_scratch.objects().front();
+                REQUIRE(object.layers().size() == object_scratch.layers().size());
+                for (size_t i = 0; i < object.layers().size(); ++ i)
+                    for (size_t region_id = 0; region_id < object.layers()[i]->region_count(); ++ region_id) {
+                        const LayerRegion &layerm         = *object.layers()[i]->get_region(int(region_id));
+                        const LayerRegion &layerm_scratch = *object_scratch.layers()[i]->get_region(int(region_id));
+                        REQUIRE(layerm.perimeters.total_volume() == Approx(layerm_scratch.perimeters.total_volume()));
+                        REQUIRE(layerm.fills.total_volume() == Approx(layerm_scratch.fills.total_volume()));
+                    }
+            }
+        }
+    }
+}
+
+SCENARIO("PrintObject: changing the config of a layer height range crossing the shells", "[PrintObject]") {
+    GIVEN("20mm cube with combined infill, 5 top and bottom shell layers and 3 walls between 0.6mm and 19.4mm") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "layer_height",               0.2 },
+            { "initial_layer_print_height", 0.2 },
+            { "wall_loops",                 2 },
+            { "sparse_infill_density",      "20%" },
+            { "infill_combination",         1 },
+            { "top_shell_layers",           5 },
+            { "top_shell_thickness",        0 },
+            { "bottom_shell_layers",        5 },
+            { "bottom_shell_thickness",     0 }
+        });
+        // The top and bottom shells of the cube span the boundaries of the range.
+        auto set_range = [](Model &model, int wall_loops) {
+            ModelConfig &range_config = model.objects.front()->layer_config_ranges[{ 0.6, 19.4 }];
+            range_config.set("layer_height", 0.2);
+            range_config.set("wall_loops", wall_loops);
+        };
+        Print print;
+        Model model;
+        init_print({ TestMesh::cube_20x20x20 }, print, model, config);
+        set_range(model, 3);
+        print.apply(model, config);
+        print.process();
+        const PrintObject &object = *print.objects().front();
+
+        WHEN("the number of walls of the layer height range is changed to 4") {
+            set_range(model, 4);
+            print.apply(model, config);
+            print.process();
+            THEN("the fill surfaces, the perimeters and the infills match a print processed from scratch") {
+                Print print_scratch;
+                Model model_scratch;
+                init_print({ TestMesh::cube_20x20x20 }, print_scratch, model_scratch, config);
+                set_range(model_scratch, 4);
+                print_scratch.apply(model_scratch, config);
+                print_scratch.process();
+                const PrintObject &object_scratch = *print_scratch.objects().front();
+                REQUIRE(object.layers().size() == object_scratch.layers().size());
+                auto area_of_type = [](const LayerRegion &layerm, SurfaceType type) {
+                    double area = 0.;
+                    for (const Surface &surface : layerm.fill_surfaces.surfaces)
+                        if (surface.surface_type == type)
+                            area += surface.area();
+                    return area;
+                };
+                for (size_t i = 0; i < object.layers().size(); ++ i)
+                    for (size_t region_id = 0; region_id < object.layers()[i]->region_count(); ++ region_id) {
+                        const LayerRegion &layerm         = *object.layers()[i]->get_region(int(region_id));
+                        const LayerRegion &layerm_scratch = *object_scratch.layers()[i]->get_region(int(region_id));
+                        INFO("Layer " << i << ", region " << region_id);
+                        REQUIRE(layerm.fill_surfaces.size() == layerm_scratch.fill_surfaces.size());
+                        for (SurfaceType type : { stTop, stBottom, stBottomBridge, stInternal, stInternalSolid, stInternalBridge, stInternalVoid })
+                            REQUIRE(area_of_type(layerm, type) == Approx(area_of_type(layerm_scratch, type)));
+                        REQUIRE(layerm.perimeters.total_volume() == Approx(layerm_scratch.perimeters.total_volume()));
+                        REQUIRE(layerm.fills.total_volume() == Approx(layerm_scratch.fills.total_volume()));
+                    }
+            }
+        }
+    }
+}
+
+SCENARIO("PrintObject: reverting a config change", "[PrintObject]") {
+    GIVEN("20mm cube with 2 walls and ironed top surfaces") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "layer_height",               0.2 },
+            { "initial_layer_print_height", 0.2 },
+            { "wall_loops",                 2 },
+            { "sparse_infill_density",      "20%" },
+            { "ironing_type",               "top" }
+        });
+        auto ironing_count = [](const Layer &layer) {
+            size_t count = 0;
+            for (const LayerRegion *layerm : layer.regions())
+                for (const ExtrusionEntity *entity : layerm->fills.flatten().entities)
+                    if (entity->role() == erIroning)
+                        ++ count;
+            return count;
+        };
+        Print print;
+        Model model;
+        init_print({ TestMesh::cube_20x20x20 }, print, model, config);
+        print.process();
+        const PrintObject &object = *print.objects().front();
+        std::vector<size_t> ironing_before;
+        for (const Layer *layer : object.layers())
+            ironing_before.emplace_back(ironing_count(*layer));
+        REQUIRE(ironing_before.back() > 0);
+        // Tag the perimeters and the fills of all layers with an empty collection, which is dropped if they are regenerated.
+        for (Layer *layer : print.get_object(0)->layers())
+            for (size_t region_id = 0; region_id < layer->region_count(); ++ region_id) {
+                LayerRegion *layerm = layer->get_region(int(region_id));
+                layerm->perimeters.entities.push_back(new ExtrusionEntityCollection());
+                layerm->fills.entities.push_back(new ExtrusionEntityCollection());
+            }
+        auto tagged = [](const ExtrusionEntityCollection &extrusions) {
+            const auto *last = extrusions.empty() ? nullptr : dynamic_cast<const ExtrusionEntityCollection*>(extrusions.entities.back());
+            return last != nullptr && last->empty();
+        };
+
+        WHEN("the number of walls is changed to 3 and back to 2 before processing") {
+            config.set("wall_loops", 3);
+            print.apply(model, config);
+            config.set("wall_loops", 2);
+            print.apply(model, config);
+            print.process();
+            THEN("the perimeters and the fills of all layers are kept") {
+                for (const Layer *layer : object.layers())
+                    for (const LayerRegion *layerm : layer->regions()) {
+                        REQUIRE(tagged(layerm->perimeters));
+                        REQUIRE(tagged(layerm->fills));
+                    }
+            }
+            THEN("the ironing is not added twice") {
+                for (size_t i = 0; i < object.layers().size(); ++ i)
+                    REQUIRE(ironing_count(*object.layers()[i]) == ironing_before[i]);
+            }
+        }
+    }
+}
+
+SCENARIO("PrintObject: changing the number of top shell layers", "[PrintObject]") {
+    GIVEN("20mm cube with 5 top shell layers") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "layer_height",               0.2 },
+            { "initial_layer_print_height", 0.2 },
+            { "wall_loops",                 2 },
+            { "sparse_infill_density",      "20%" },
+            { "top_shell_layers",           5 },
+            { "top_shell_thickness",        0 }
+        });
+        Print print;
+        Model model;
+        init_print({ TestMesh::cube_20x20x20 }, print, model, config);
+        print.process();
+        const PrintObject &object = *print.objects().front();
+        // Tag the fills of all layers with an empty collection, which is dropped if the fills of a layer are regenerated.
+        for (Layer *layer : print.get_object(0)->layers())
+            for (size_t region_id = 0; region_id < layer->region_count(); ++ region_id)
+                layer->get_region(int(region_id))->fills.entities.push_back(new ExtrusionEntityCollection());
+        auto fills_tagged = [](const LayerRegion &layerm) {
+            const auto *last = layerm.fills.empty() ? nullptr : dynamic_cast<const ExtrusionEntityCollection*>(layerm.fills.entities.back());
+            return last != nullptr && last->empty();
+        };
+
+        WHEN("the number of top shell layers is changed to 4") {
+            config.set("top_shell_layers", 4);
+            print.apply(model, config);
+            print.process();
+            THEN("only the fills of the layers with modified fill surfaces are regenerated") {
+                size_t num_regenerated = 0;
+                for (const Layer *layer : object.layers())
+                    for (const LayerRegion *layerm : layer->regions())
+                        if (! layerm->slices.empty()) {
+                            // The fill surfaces below the top shells and the bridge over the sparse infill did not change.
+                            if (layer->print_z < 18.)
+                                REQUIRE(fills_tagged(*layerm));
+                            num_regenerated += ! fills_tagged(*layerm);
+                        }
+                REQUIRE(num_regenerated > 0);
+                REQUIRE(num_regenerated < 5);
+            }
+            THEN("the infills match a print processed from scratch") {
+                Print print_scratch;
+                Model model_scratch;
+                init_print({ TestMesh::cube_20x20x20 }, print_scratch, model_scratch, config);
+                print_scratch.process();
+                const PrintObject &object_scratch = *print_scratch.objects().front();
+                REQUIRE(object.layers().size() == object_scratch.layers().size());
+                for (size_t i = 0; i < object.layers().size(); ++ i)
+                    for (size_t region_id = 0; region_id < object.layers()[i]->region_count(); ++ region_id)
+                        REQUIRE(object.layers()[i]->get_region(int(region_id))->fills.total_volume() ==
+                            Approx(object_scratch.layers()[i]->get_region(int(region_id))->fills.total_volume()));
+            }
+        }
+    }
+}
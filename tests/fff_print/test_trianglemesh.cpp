@@ -274,6 +274,54 @@ SCENARIO( "TriangleMesh: Mesh merge functions") {
     }
 }
 
+SCENARIO( "TriangleMesh: cached face topology") {
+    GIVEN( "A sphere") {
+        TriangleMesh sphere = make_sphere(10., 2. * PI / 40.);
+        THEN( "Cached topology matches a freshly calculated one") {
+            REQUIRE(sphere.face_neighbors() == its_face_neighbors(sphere.its));
+            REQUIRE(sphere.face_edge_ids() == its_face_edge_ids(sphere.its));
+            VertexFaceIndex vertex_faces(sphere.its);
+            for (size_t i = 0; i < sphere.its.vertices.size(); ++ i)
+                REQUIRE(std::equal(vertex_faces.begin(i), vertex_faces.end(i), sphere.vertex_faces().begin(i), sphere.vertex_faces().end(i)));
+        }
+        WHEN( "The mesh is copied and translated") {
+            TriangleMesh copy(sphere);
+            copy.translate(5.f, 5.f, 5.f);
+            THEN( "The copy shares the topology") {
+                REQUIRE(&copy.face_neighbors() == &sphere.face_neighbors());
+                REQUIRE(&copy.face_edge_ids() == &sphere.face_edge_ids());
+            }
+        }
+        WHEN( "A copy is mirrored") {
+            TriangleMesh copy(sphere);
+            copy.mirror_x();
+            THEN( "The copy recalculates its topology, the source keeps its own") {
+                REQUIRE(&copy.face_edge_ids() != &sphere.face_edge_ids());
+                REQUIRE(copy.face_edge_ids() == its_face_edge_ids(copy.its));
+                REQUIRE(sphere.face_edge_ids() == its_face_edge_ids(sphere.its));
+            }
+        }
+        WHEN( "A cube is merged into a copy") {
+            TriangleMesh copy(sphere);
+            copy.merge(make_cube(5., 5., 5.));
+            THEN( "The topology covers the merged faces") {
+                REQUIRE(copy.face_neighbors().size() == copy.its.indices.size());
+                REQUIRE(copy.face_neighbors() == its_face_neighbors(copy.its));
+            }
+        }
+        WHEN( "The mesh is sliced with the cached edge ids") {
+            std::vector<float> z { -5.f, 0.f, 2.5f, 7.5f };
+            MeshSlicingParamsEx params;
+            std::vector<ExPolygons> slices = slice_mesh_ex(sphere.its, z, params);
+            params.face_edge_ids = &sphere.face_edge_ids();
+            std::vector<ExPolygons> slices_cached = slice_mesh_ex(sphere.its, z, params);
+            THEN( "Slices are the same") {
+                REQUIRE(slices == slices_cached);
+            }
+        }
+    }
+}
+
 SCENARIO( "TriangleMeshSlicer: Cut behavior.") {
     GIVEN( "A 20mm cube with one corner on the origin") {
 		auto cube = make_cube();
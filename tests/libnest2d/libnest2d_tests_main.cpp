@@ -195,6 +195,28 @@ TEST_CASE("ItemCreationAndDestruction", "[Nesting]")
     REQUIRE(sh3.vertexCount() == 4u);
 }
 
+TEST_CASE("ItemCopyDoesNotShareVertexCache", "[Nesting]")
+{
+    using namespace libnest2d;
+
+    Item sh = { {0, 0}, {10, 0}, {10, 10}, {0, 10} };
+    sh.translation({5, 5});
+    PointImpl rmt = sh.rightmostTopVertex();
+    PointImpl lmb = sh.leftmostBottomVertex();
+
+    // The copy gets the transformed shape of sh, but not its cached vertices.
+    Item copy = sh;
+    sh.translation({100, 100});
+    sh.rotation(Pi / 4);
+
+    REQUIRE(getX(sh.rightmostTopVertex()) != getX(rmt));
+    REQUIRE(copy.rightmostTopVertex() == rmt);
+    REQUIRE(copy.leftmostBottomVertex() == lmb);
+
+    sh = copy;
+    REQUIRE(sh.rightmostTopVertex() == rmt);
+}
+
 TEST_CASE("boundingCircle", "[Geometry]") {
     using namespace libnest2d;
     using placers::boundingCircle;
@@ -592,6 +614,10 @@ TEST_CASE("convexHull", "[Geometry]") {
 
 TEST_CASE("PrusaPartsShouldFitIntoTwoBins", "[Nesting]") {
 
+    // Try the items on the open bins one by one and concurrently.
+    NestConfig<> cfg;
+    cfg.placer_config.parallel_bins = GENERATE(false, true);
+
     // Get the input items and define the bin.
     std::vector<Item> input = prusaParts();
     auto bin = Box(250000000, 210000000);
@@ -600,7 +626,7 @@ TEST_CASE("PrusaPartsShouldFitIntoTwoBins", "[Nesting]") {
     // in the previous step. (Some algorithms can place more items in one step)
     size_t pcount = input.size();
 
-    size_t bins = libnest2d::nest(input, bin, 0, {},
+    size_t bins = libnest2d::nest(input, bin, 0, cfg,
                                   ProgressFunction{[&pcount](unsigned cnt) {
                                       REQUIRE(cnt < pcount);
                                       pcount = cnt;
@@ -722,6 +748,64 @@ TEST_CASE("Items can be preloaded", "[Nesting]") {
     }
 }
 
+TEST_CASE("Cached no-fit polygons give the same arrangement", "[Nesting]") {
+    auto bin = Box(250000000, 210000000);
+
+    std::vector<Item> parts = prusaParts();
+    if (parts.size() > 20)
+        parts.erase(parts.begin() + 20, parts.end());
+
+    SECTION("Shape hash ignores the translation") {
+        Item item = parts.front();
+        size_t hash = item.shapeHash();
+        item.translate({1000000, -500000});
+        REQUIRE(item.shapeHash() == hash);
+        item.rotation(Pi / 2);
+        REQUIRE(item.shapeHash() != hash);
+    }
+
+    SECTION("Colliding shape hashes do not return a foreign polygon") {
+        using Cache = placers::NfpCache<PolygonImpl>;
+        Cache cache;
+        Item a = parts[0], b = parts[1];
+        Cache::Key key{ a.shapeHash(), a.shapeHash() };
+        PolygonImpl nfp;
+
+        cache.insert(key, Cache::Fingerprint(a), Cache::Fingerprint(a), PolygonImpl(a.transformedShape()));
+        REQUIRE(cache.find(key, Cache::Fingerprint(a), Cache::Fingerprint(a), nfp));
+
+        // Same key, different shapes.
+        REQUIRE_FALSE(cache.find(key, Cache::Fingerprint(b), Cache::Fingerprint(a), nfp));
+        REQUIRE_FALSE(cache.find(key, Cache::Fingerprint(a), Cache::Fingerprint(b), nfp));
+
+        // The translation does not change the fingerprint.
+        a.translate({1000000, -500000});
+        REQUIRE(cache.find(key, Cache::Fingerprint(a), Cache::Fingerprint(a), nfp));
+    }
+
+    SECTION("Arrangement is not affected by the cache") {
+        std::vector<Item> reference = parts;
+        libnest2d::nest(reference, bin);
+
+        NestConfig<> cfg;
+        cfg.placer_config.nfp_cache = std::make_shared<placers::NfpCache<PolygonImpl>>();
+
+        // The first run fills the cache, the second one takes all the no-fit polygons from it.
+        for (int run = 0; run < 2; ++run) {
+            std::vector<Item> cached = parts;
+            libnest2d::nest(cached, bin, 0, cfg);
+
+            REQUIRE(cfg.placer_config.nfp_cache->size() > 0);
+            for (size_t i = 0; i < reference.size(); ++i) {
+                REQUIRE(cached[i].binId() == reference[i].binId());
+                REQUIRE(getX(cached[i].translation()) == getX(reference[i].translation()));
+                REQUIRE(getY(cached[i].translation()) == getY(reference[i].translation()));
+                REQUIRE(double(cached[i].rotation()) == Approx(double(reference[i].rotation())));
+            }
+        }
+    }
+}
+
 namespace {
 
 struct ItemPair {
@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#include <tbb/parallel_for.h>
+
+#include "libslic3r/ArcFitter.hpp"
+#include "libslic3r/Format/OBJ.hpp"
+#include "libslic3r/Polyline.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
+
+using namespace Slic3r;
+
+static Polyline arc_polyline(double radius, double angle, size_t num_points)
+{
+    Polyline out;
+    for (size_t i = 0; i < num_points; ++ i) {
+        double a = angle * double(i) / double(num_points - 1);
+        out.points.emplace_back(Point::new_scale(radius * cos(a), radius * sin(a)));
+    }
+    return out;
+}
+
+static void require_continuous(const Polyline &polyline)
+{
+    REQUIRE(! polyline.fitting_result.empty());
+    REQUIRE(polyline.fitting_result.front().start_point_index == 0);
+    REQUIRE(polyline.fitting_result.back().end_point_index == polyline.points.size() - 1);
+    for (size_t i = 1; i < polyline.fitting_result.size(); ++ i)
+        REQUIRE(polyline.fitting_result[i].start_point_index == polyline.fitting_result[i - 1].end_point_index);
+}
+
+TEST_CASE("Arc fitting of a sampled arc", "[ArcFitting]") {
+    Polyline polyline = arc_polyline(10., 1.5 * PI, 100);
+    polyline.points.emplace_back(Point::new_scale(20., -10.));
+    polyline.points.emplace_back(Point::new_scale(30., -10.));
+    polyline.points.emplace_back(Point::new_scale(40., -10.));
+    polyline.simplify_by_fitting_arc(scaled<double>(0.01));
+
+    require_continuous(polyline);
+    REQUIRE(polyline.points.size() < 103);
+    REQUIRE(polyline.fitting_result.front().is_arc_move());
+    REQUIRE(polyline.fitting_result.back().is_linear_move());
+    // The straight tail is reduced to its end points.
+    REQUIRE(polyline.points.back() == Point::new_scale(40., -10.));
+    REQUIRE(polyline.points[polyline.points.size() - 2] == Point::new_scale(10. * cos(1.5 * PI), 10. * sin(1.5 * PI)));
+
+    SECTION("reusing the scratch buffers gives the same result") {
+        Polyline again = arc_polyline(10., 1.5 * PI, 100);
+        again.points.emplace_back(Point::new_scale(20., -10.));
+        again.points.emplace_back(Point::new_scale(30., -10.));
+        again.points.emplace_back(Point::new_scale(40., -10.));
+        Polyline other = arc_polyline(5., PI, 30);
+        other.simplify_by_fitting_arc(scaled<double>(0.01));
+        again.simplify_by_fitting_arc(scaled<double>(0.01));
+        REQUIRE(again.points == polyline.points);
+        REQUIRE(again.fitting_result.size() == polyline.fitting_result.size());
+    }
+}
+
+// Run explicitly with "[ArcFitting][.benchmark]".
+TEST_CASE("Arc fitting benchmark on sliced test models", "[ArcFitting][.benchmark]") {
+    for (const char *name : { "20mm_cube.obj", "extruder_idler.obj", "frog_legs.obj", "ipadstand.obj", "bridge.obj", "sloping_hole.obj" }) {
+        TriangleMesh mesh;
+        REQUIRE(load_obj((std::string(TEST_DATA_DIR) + "/" + name).c_str(), &mesh));
+        BoundingBoxf3      bbox = mesh.bounding_box();
+        std::vector<float> zs;
+        for (double z = bbox.min.z() + 0.1; z < bbox.max.z(); z += 0.2)
+            zs.emplace_back(float(z));
+        Polylines polylines;
+        for (const ExPolygons &layer : slice_mesh_ex(mesh.its, zs, MeshSlicingParamsEx{}))
+            for (const Polygon &polygon : to_polygons(layer))
+                polylines.emplace_back(polygon.split_at_first_point());
+        size_t points_in = 0;
+        for (const Polyline &polyline : polylines)
+            points_in += polyline.points.size();
+
+        auto t_start = std::chrono::high_resolution_clock::now();
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, polylines.size()), [&polylines](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                polylines[i].simplify_by_fitting_arc(scaled<double>(0.01));
+        });
+        auto   t_end      = std::chrono::high_resolution_clock::now();
+        size_t points_out = 0;
+        size_t arcs       = 0;
+        for (const Polyline &polyline : polylines) {
+            points_out += polyline.points.size();
+            for (const PathFittingData &data : polyline.fitting_result)
+                arcs += data.path_type == EMovePathType::Arc_move_ccw || data.path_type == EMovePathType::Arc_move_cw;
+        }
+        double ms = std::chrono::duration<double, std::milli>(t_end - t_start).count();
+        std::cout << name << ": " << zs.size() << " layers, " << points_in << " points in, " << points_out << " points out, " << arcs << " arcs, " <<
+            ms << " ms, " << double(points_in) / std::max(ms, 1e-3) / 1000. << " Mpoints/s" << std::endl;
+        REQUIRE(points_out <= points_in);
+        for (const Polyline &polyline : polylines)
+            require_continuous(polyline);
+    }
+}
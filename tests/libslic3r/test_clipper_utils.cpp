@@ -299,3 +299,107 @@ TEST_CASE("Traversing Clipper PolyTree", "[ClipperUtils]") {
         REQUIRE(count_polys(output) == reference.size());
     }
 }
+
+TEST_CASE("Cached Clipper engines and batched offsets", "[ClipperUtils]") {
+    Slic3r::Polygon   square{ { 200, 100 }, { 200, 200 }, { 100, 200 }, { 100, 100 } };
+    Slic3r::Polygon   hole_in_square{ { 160, 140 }, { 140, 140 }, { 140, 160 }, { 160, 160 } };
+    ExPolygons islands;
+    for (int i = 0; i < 5; ++ i) {
+        ExPolygon island(square, hole_in_square);
+        island.scale(scale_(0.1));
+        island.translate(scale_(30.) * i, 0.);
+        islands.emplace_back(std::move(island));
+    }
+
+    SECTION("Reusing the cached engine gives the same results") {
+        ExPolygons first  = offset2_ex(islands, - scale_(0.5), scale_(0.3));
+        // Run some unrelated operations in between, leaving their buffers in the cached engines.
+        union_(to_polygons(offset_ex(islands, scale_(2.))));
+        diff_ex(islands, offset(islands, - scale_(0.2)));
+        ExPolygons second = offset2_ex(islands, - scale_(0.5), scale_(0.3));
+        REQUIRE(first.size() == second.size());
+        for (size_t i = 0; i < first.size(); ++ i)
+            REQUIRE(first[i] == second[i]);
+    }
+
+    SECTION("Batched offsets match offsetting the islands one by one") {
+        std::vector<ExPolygons> batch  = offset_ex_batch(islands, - scale_(0.3));
+        std::vector<ExPolygons> batch2 = offset2_ex_batch(islands, - scale_(0.5), scale_(0.3));
+        REQUIRE(batch.size() == islands.size());
+        REQUIRE(batch2.size() == islands.size());
+        for (size_t i = 0; i < islands.size(); ++ i) {
+            REQUIRE(batch[i] == offset_ex(islands[i], - scale_(0.3)));
+            REQUIRE(batch2[i] == offset2_ex(ExPolygons{ islands[i] }, - scale_(0.5), scale_(0.3)));
+        }
+    }
+}
+
+TEST_CASE("Bounding box prefiltered boolean operations on many islands", "[ClipperUtils]") {
+    // 12x12 islands with holes, clipped by small squares scattered over the bed and a single long bar.
+    Slic3r::Polygon square{ { 0, 0 }, { 1000, 0 }, { 1000, 1000 }, { 0, 1000 } };
+    Slic3r::Polygon hole  { { 300, 300 }, { 300, 700 }, { 700, 700 }, { 700, 300 } };
+    ExPolygons islands;
+    Polygons   clip;
+    for (int i = 0; i < 12; ++ i)
+        for (int j = 0; j < 12; ++ j) {
+            ExPolygon island(square, hole);
+            island.translate(1500. * i, 1500. * j);
+            islands.emplace_back(std::move(island));
+            Slic3r::Polygon c{ { 0, 0 }, { 400, 0 }, { 400, 400 }, { 0, 400 } };
+            c.translate(1500. * i + 100. * (i % 4) + 800., 1500. * j + 100. * (j % 3) - 200.);
+            clip.emplace_back(std::move(c));
+        }
+    clip.push_back({ { -100, 5800 }, { 18500, 5800 }, { 18500, 6200 }, { -100, 6200 } });
+    // Clip polygons far away from all the islands.
+    for (int i = 0; i < 20; ++ i) {
+        Slic3r::Polygon c{ { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 } };
+        c.translate(50000. + 200. * i, 0.);
+        clip.emplace_back(std::move(c));
+    }
+
+    auto reference = [&islands, &clip](ClipperLib::ClipType clip_type) {
+        ClipperLib::Clipper clipper;
+        clipper.AddPaths(ClipperUtils::ExPolygonsProvider(islands), ClipperLib::ptSubject, true);
+        clipper.AddPaths(ClipperUtils::PolygonsProvider(clip), ClipperLib::ptClip, true);
+        ClipperLib::Paths out;
+        clipper.Execute(clip_type, out, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        return ClipperPaths_to_Slic3rExPolygons(out);
+    };
+    auto total_area = [](const ExPolygons &expolys) {
+        double area = 0;
+        for (const ExPolygon &expoly : expolys)
+            area += expoly.area();
+        return area;
+    };
+    auto num_holes = [](const ExPolygons &expolys) {
+        size_t n = 0;
+        for (const ExPolygon &expoly : expolys)
+            n += expoly.holes.size();
+        return n;
+    };
+
+    SECTION("Difference matches the unfiltered Clipper result") {
+        ExPolygons ref = reference(ClipperLib::ctDifference);
+        ExPolygons res = diff_ex(islands, clip);
+        REQUIRE(res.size() == ref.size());
+        REQUIRE(num_holes(res) == num_holes(ref));
+        REQUIRE(total_area(res) == Approx(total_area(ref)));
+        REQUIRE(area(diff(islands, clip)) == Approx(total_area(ref)));
+    }
+    SECTION("Intersection matches the unfiltered Clipper result") {
+        ExPolygons ref = reference(ClipperLib::ctIntersection);
+        ExPolygons res = intersection_ex(islands, clip);
+        REQUIRE(res.size() == ref.size());
+        REQUIRE(total_area(res) == Approx(total_area(ref)));
+        REQUIRE(area(intersection(islands, clip)) == Approx(total_area(ref)));
+    }
+    SECTION("Nested islands stay in a single cluster") {
+        ExPolygon outer(Slic3r::Polygon{ { -1000, -1000 }, { 20000, -1000 }, { 20000, 20000 }, { -1000, 20000 } },
+                        Slic3r::Polygon{ { -500, -500 }, { -500, 19000 }, { 19000, 19000 }, { 19000, -500 } });
+        ExPolygons subject = islands;
+        subject.emplace_back(outer);
+        ExPolygons res = diff_ex(subject, clip);
+        REQUIRE(res.size() == reference(ClipperLib::ctDifference).size() + 1);
+        REQUIRE(total_area(res) == Approx(total_area(reference(ClipperLib::ctDifference)) + outer.area()));
+    }
+}
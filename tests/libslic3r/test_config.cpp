@@ -237,3 +237,28 @@ SCENARIO("DynamicPrintConfig serialization", "[Config]") {
         }
     }
 }
+
+SCENARIO("StaticPrintConfig diff against DynamicPrintConfig", "[Config]") {
+    GIVEN("A PrintObjectConfig with defaults and a full DynamicPrintConfig") {
+        PrintObjectConfig  object_config;
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        WHEN("Nothing is changed") {
+            THEN("No option differs") {
+                REQUIRE(object_config.diff_dynamic(config).empty());
+            }
+        }
+        WHEN("Some object options and a print option are changed") {
+            config.set_key_value("layer_height", new ConfigOptionFloat(0.13));
+            config.set_key_value("wall_loops", new ConfigOptionInt(7));
+            config.set_key_value("seam_position", new ConfigOptionEnum<SeamPosition>(spRear));
+            config.set_key_value("travel_speed", new ConfigOptionFloat(123.));
+            config.erase("support_angle");
+            THEN("The diff matches the generic ConfigBase::diff") {
+                t_config_option_keys diff = object_config.diff_dynamic(config);
+                REQUIRE(diff == object_config.diff(config));
+                REQUIRE(std::find(diff.begin(), diff.end(), "layer_height") != diff.end());
+                REQUIRE(std::find(diff.begin(), diff.end(), "travel_speed") == diff.end());
+            }
+        }
+    }
+}
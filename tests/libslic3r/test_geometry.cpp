@@ -17,6 +17,9 @@
 
 #include "../libnest2d/printer_parts.hpp"
 
+#include <chrono>
+#include <iostream>
+#include <random>
 #include <unordered_set>
 
 using namespace Slic3r;
@@ -357,6 +360,64 @@ SCENARIO("Path chaining", "[Geometry]") {
 	}
 }
 
+// Short random segments scattered over a 200x200mm bed, resembling dense gap fill.
+static Polylines random_short_segments(size_t num_segments)
+{
+	std::mt19937 rng(12345);
+	std::uniform_real_distribution<double> pos(0., 200.);
+	std::uniform_real_distribution<double> delta(-1., 1.);
+	Polylines out;
+	out.reserve(num_segments);
+	for (size_t i = 0; i < num_segments; ++ i) {
+		Vec2d a(pos(rng), pos(rng));
+		out.push_back({ Point::new_scale(a), Point::new_scale(Vec2d(a + Vec2d(delta(rng), delta(rng)))) });
+	}
+	return out;
+}
+
+static double chain_travel_length(const Polylines &chained)
+{
+	double length = 0.;
+	for (size_t i = 1; i < chained.size(); ++ i)
+		length += (chained[i].first_point() - chained[i - 1].last_point()).cast<double>().norm();
+	return length;
+}
+
+TEST_CASE("Partitioned chaining visits all the segments with a comparable travel", "[Geometry]") {
+	Polylines polylines = random_short_segments(6000);
+	Polylines greedy      = chain_polylines(polylines, nullptr, ChainingMode::Greedy);
+	Polylines partitioned = chain_polylines(polylines, nullptr, ChainingMode::Partitioned);
+	REQUIRE(partitioned.size() == polylines.size());
+	auto sorted_segments = [](Polylines pls) {
+		std::vector<std::pair<Point, Point>> out;
+		for (Polyline &pl : pls) {
+			if (pl.last_point() < pl.first_point())
+				pl.reverse();
+			out.emplace_back(pl.first_point(), pl.last_point());
+		}
+		std::sort(out.begin(), out.end(), [](const auto &l, const auto &r) { return l.first < r.first || (l.first == r.first && l.second < r.second); });
+		return out;
+	};
+	REQUIRE(sorted_segments(partitioned) == sorted_segments(polylines));
+	REQUIRE(chain_travel_length(partitioned) < 1.2 * chain_travel_length(greedy));
+}
+
+// Run explicitly with "[Geometry][.benchmark]".
+TEST_CASE("Chaining benchmark of greedy versus partitioned chaining", "[Geometry][.benchmark]") {
+	for (size_t num_segments : { 10000, 50000 }) {
+		Polylines polylines = random_short_segments(num_segments);
+		for (ChainingMode mode : { ChainingMode::Greedy, ChainingMode::Partitioned }) {
+			auto      t_start = std::chrono::high_resolution_clock::now();
+			Polylines chained = chain_polylines(polylines, nullptr, mode);
+			auto      t_end   = std::chrono::high_resolution_clock::now();
+			std::cout << (mode == ChainingMode::Greedy ? "Greedy" : "Partitioned") << " chaining of " << num_segments << " segments: " <<
+				std::chrono::duration_cast<std::chrono::milliseconds>(t_end - t_start).count() << " ms, travel " << 
+				unscale<double>(chain_travel_length(chained)) << " mm" << std::endl;
+			REQUIRE(chained.size() == num_segments);
+		}
+	}
+}
+
 SCENARIO("Line distances", "[Geometry]"){
     GIVEN("A line"){
         Line line(Point(0, 0), Point(20, 0));
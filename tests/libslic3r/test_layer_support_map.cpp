@@ -0,0 +1,70 @@
+#include <catch2/catch.hpp>
+
+#include <thread>
+
+#include "libslic3r/BoundingBox.hpp"
+#include "libslic3r/BridgeDetector.hpp"
+#include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/LayerSupportMap.hpp"
+
+using namespace Slic3r;
+
+SCENARIO("Lower slices support map", "[LayerSupportMap]") {
+    GIVEN("Two pillars, the left one with a hole") {
+        ExPolygon left(Polygon::new_scale({ { 0, 0 }, { 10, 0 }, { 10, 20 }, { 0, 20 } }));
+        left.holes.emplace_back(Polygon::new_scale({ { 3, 3 }, { 3, 7 }, { 7, 7 }, { 7, 3 } }));
+        ExPolygons lower_slices { left, ExPolygon(Polygon::new_scale({ { 30, 0 }, { 40, 0 }, { 40, 20 }, { 30, 20 } })) };
+        LayerSupportMap map(lower_slices);
+
+        THEN("the cached polygons describe the slices") {
+            // Two contours of 10x20mm and a hole of 4x4mm.
+            REQUIRE(map.polygons().size() == 3);
+            REQUIRE(area(map.polygons()) == Approx(scaled<double>(1.) * scaled<double>(1.) * (2. * 200. - 16.)));
+            REQUIRE(map.contours() == Polygons{ lower_slices[0].contour, lower_slices[1].contour });
+            REQUIRE(area(map.safety_offset()) == Approx(area(map.polygons())).epsilon(1e-4));
+        }
+        THEN("the grown polygons are offset by the requested delta and join type") {
+            // The contours grow to 11x21mm, the hole shrinks to 3x3mm.
+            const double    mitered_area = scaled<double>(1.) * scaled<double>(1.) * (2. * 231. - 9.);
+            const Polygons &mitered      = map.grown(scaled<float>(0.5));
+            REQUIRE(mitered.size() == 3);
+            REQUIRE(area(mitered) == Approx(mitered_area));
+            BoundingBox bbox = get_extents(mitered);
+            REQUIRE(bbox.min == Point::new_scale(-0.5, -0.5));
+            REQUIRE(bbox.max == Point::new_scale(40.5, 20.5));
+            // Squared corners cut off 4 * 0.043mm^2 of each grown contour.
+            const Polygons &squared = map.grown(scaled<float>(0.5), ClipperLib::jtSquare, 0.);
+            REQUIRE(&squared != &mitered);
+            REQUIRE(area(squared) == Approx(mitered_area - scaled<double>(1.) * scaled<double>(1.) * 8. * 0.0429).epsilon(1e-3));
+        }
+        THEN("a grown polygon set is calculated once and shared by the concurrent queries") {
+            std::vector<const Polygons*> results(4, nullptr);
+            std::vector<std::thread>     threads;
+            for (size_t i = 0; i < results.size(); ++ i)
+                threads.emplace_back([&map, &results, i]() { results[i] = &map.grown(scaled<float>(1.)); });
+            for (std::thread &thread : threads)
+                thread.join();
+            for (const Polygons *result : results)
+                REQUIRE(result == results.front());
+        }
+        THEN("the bridge detector finds the same direction with and without the support map") {
+            ExPolygons bridge { ExPolygon(Polygon::new_scale({ { 8, 5 }, { 32, 5 }, { 32, 15 }, { 8, 15 } })) };
+            BridgeDetector bd_slices(bridge, lower_slices, scaled<coord_t>(0.5));
+            BridgeDetector bd_map(bridge, map, scaled<coord_t>(0.5));
+            REQUIRE(bd_slices.detect_angle());
+            REQUIRE(bd_map.detect_angle());
+            REQUIRE(bd_map.angle == Approx(bd_slices.angle));
+            REQUIRE(bd_map.unsupported_edges() == bd_slices.unsupported_edges());
+        }
+        WHEN("the map is cleared after the slices changed") {
+            const Polygons grown_before = map.grown(scaled<float>(0.5));
+            lower_slices.pop_back();
+            map.clear();
+            THEN("the queries are recalculated from the new slices") {
+                REQUIRE(map.contours().size() == 1);
+                REQUIRE(map.grown(scaled<float>(0.5)) == offset(lower_slices, scaled<float>(0.5)));
+                REQUIRE(map.grown(scaled<float>(0.5)) != grown_before);
+            }
+        }
+    }
+}
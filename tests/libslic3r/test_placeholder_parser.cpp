@@ -1,5 +1,7 @@
 #include <catch2/catch.hpp>
 
+#include <chrono>
+
 #include "libslic3r/PlaceholderParser.hpp"
 #include "libslic3r/PrintConfig.hpp"
 
@@ -111,3 +113,152 @@ SCENARIO("Placeholder parser scripting", "[PlaceholderParser]") {
     SECTION("complex expression2") { REQUIRE(boolean_expression("printer_notes=~/.*PRINTER_VEwerfNDOR_PRUSA3D.*/ or printer_notes=~/.*PRINTertER_MODEL_MK2.*/ or (nozzle_diameter[0]==0.6 and num_extruders>1)")); }
     SECTION("complex expression3") { REQUIRE(! boolean_expression("printer_notes=~/.*PRINTER_VEwerfNDOR_PRUSA3D.*/ or printer_notes=~/.*PRINTertER_MODEL_MK2.*/ or (nozzle_diameter[0]==0.3 and num_extruders>1)")); }
 }
+
+SCENARIO("Placeholder parser template cache", "[PlaceholderParser]") {
+    PlaceholderParser parser;
+    parser.set("foo", 0);
+    parser.set("bar", 2);
+    parser.set("layer_z", 0.4);
+    parser.set("temperature", new ConfigOptionInts({ 200, 210, 220 }));
+    const std::string templ = "  G1 Z{layer_z} ; [bar]\n{if foo == 0}M104 S{temperature[bar]}{elsif foo == 1}M104 S[temperature_1]{else}M104 S{temperature[foo]}{endif}\n";
+
+    WHEN("the same template is processed repeatedly") {
+        std::string first  = parser.process(templ);
+        std::string second = parser.process(templ);
+        THEN("the results are equal") {
+            REQUIRE(first == "G1 Z0.4 ; 2\nM104 S220\n");
+            REQUIRE(second == first);
+        }
+    }
+    WHEN("the config changes between the invocations") {
+        parser.process(templ);
+        parser.set("foo", 1);
+        parser.set("layer_z", 0.6);
+        THEN("the cached template is evaluated against the new values") {
+            REQUIRE(parser.process(templ) == "G1 Z0.6 ; 2\nM104 S210\n");
+        }
+    }
+    WHEN("the template contains a closing brace inside a regular expression") {
+        parser.set("notes", std::string("a}b"));
+        THEN("it is processed correctly on each invocation") {
+            REQUIRE(parser.process("{if notes =~ /a}b/}match{endif}") == "match");
+            REQUIRE(parser.process("{if notes =~ /a}b/}match{endif}") == "match");
+        }
+    }
+    WHEN("a template has a syntax error") {
+        THEN("it throws on each invocation") {
+            REQUIRE_THROWS_AS(parser.process("{if foo == 0}x{else}y{else}z{endif}"), PlaceholderParserError);
+            REQUIRE_THROWS_AS(parser.process("{if foo == 0}x{else}y{else}z{endif}"), PlaceholderParserError);
+            REQUIRE_THROWS_AS(parser.process("[nonexistent]"), PlaceholderParserError);
+            REQUIRE_THROWS_AS(parser.process("G1 Z{layer_z}\nM104 S{temperature[5]}\n"), PlaceholderParserError);
+        }
+    }
+}
+
+SCENARIO("Placeholder parser compiled templates match the grammar", "[PlaceholderParser]") {
+    PlaceholderParser parser;
+    parser.set("foo", 0);
+    parser.set("bar", 2);
+    parser.set("layer_z", 0.4);
+    parser.set("flag", true);
+    parser.set("notes", std::string("PRINTER_MODEL_X1 a}b"));
+    parser.set("temperature", new ConfigOptionInts({ 200, 210, 220 }));
+    parser.set("nozzle_diameter", new ConfigOptionFloats({ 0.4, 0.6, 0.8 }));
+    parser.set("names", new ConfigOptionStrings({ "PLA", "PETG", "ABS" }));
+
+    // Each template is processed by the compiled segments and by the grammar over the whole template.
+    const std::vector<std::string> templates {
+        // Free-form text and legacy variable expansion.
+        "", "  \n G1 X10 ; comment\n", "žluťoučký kůň", "[bar]", "[ temperature_1 ]", "[temperature_[bar]]", "[ temperature [ foo ] ]",
+        // Literals.
+        "{1}", "{-1}", "{2.5}", "{.5}", "{1e3}", "{1.}", "{true}", "{false}", "{\"text\"}", "{\"a\\\"b\"}",
+        // Variables.
+        "{bar}", "{layer_z}", "{flag}", "{notes}", "{temperature[bar]}", "{temperature[bar - 1]}", "{nozzle_diameter[foo + 1]}", "{names[2]}",
+        // Arithmetic and precedence.
+        "{1 + 2 * 3}", "{(1 + 2) * 3}", "{10 / 4}", "{10. / 4}", "{10 % 3}", "{11 % 2.5}", "{-bar * 3}", "{+bar - -2}", "{2 * layer_z + 0.1}",
+        "{bar - 1 - 1}", "{12 / 3 / 2}", "{temperature[0] + temperature[2] / 2}", "{\"a\" + \"b\"}", "{notes + bar}",
+        // Functions.
+        "{min(bar, 1)}", "{max(layer_z, 0.3)}", "{int(layer_z * 10)}", "{round(-13.6)}", "{min(1, 2.5)}", "{max(\"a\", \"b\")}",
+        "{digits(layer_z, 0, 3)}", "{zdigits(layer_z, 4, 2)}",
+        // Comparisons, logical operators, regular expressions and the ternary operator.
+        "{if bar == 2}two{endif}", "{if bar != 2}not two{else}two{endif}", "{if layer_z < 0.5 and flag}low{endif}",
+        "{if bar >= 2 && foo <= 0}both{endif}", "{if bar > 3 or foo < 1}either{endif}", "{if bar > 3 || !flag}either{else}none{endif}",
+        "{if not flag}no{elsif bar == 2}two{else}other{endif}", "{if foo == 1}1{elsif foo == 0}0{elsif bar == 2}2{endif}",
+        "{if names[0] == \"PLA\"}pla{endif}", "{if notes =~ /.*MODEL_X1.*/}x1{endif}", "{if notes !~ /.*MODEL_P1.*/}not p1{endif}",
+        "{if notes =~ /a}b/}brace{endif}", "{if notes =~ /a\\/b/}slash{else}no slash{endif}", "{flag ? 1 : 2}", "{(bar > 1 ? \"big\" : \"small\")}",
+        "{if foo == 0}{if bar == 2}nested{else}inner else{endif}{else}outer else{endif}",
+        "M104 S{temperature[bar]}\n{if layer_z > 0.2}G1 Z{layer_z + 0.2}\n{endif}T[bar]\n",
+        // Errors.
+        "{nonexistent}", "[nonexistent]", "{temperature[5]}", "{1 +}", "{if foo == 0}x{else}y{else}z{endif}", "{endif}", "{if foo}x{endif}",
+        "{bar / 0}", "{\"a\" * 2}", "{min(1)}", "{1 <> 2}", "{if notes =~ /a}x{endif}", "{",
+    };
+    // Output of a template, or the type and the message of the exception thrown.
+    auto process = [](auto &&fn) {
+        try {
+            return fn();
+        } catch (const PlaceholderParserError &ex) {
+            return std::string("PlaceholderParserError: ") + ex.what();
+        } catch (const std::exception &ex) {
+            return std::string("std::exception: ") + ex.what();
+        }
+    };
+    for (const std::string &templ : templates) {
+        std::string compiled = process([&parser, &templ]() { return parser.process(templ); });
+        std::string uncached = process([&parser, &templ]() { return parser.process_uncached(templ); });
+        INFO("Template: " << templ);
+        // The errors of both paths are thrown as PlaceholderParserError with the same message.
+        REQUIRE(compiled == uncached);
+        // Once more with the cached compiled template.
+        REQUIRE(process([&parser, &templ]() { return parser.process(templ); }) == uncached);
+    }
+
+    WHEN("the template uses the random generator of the context") {
+        const std::string templ = "{random(0, 1000)} {if random(0, 10) > 5}a{else}b{endif} {random(0., 1.)}";
+        PlaceholderParser::ContextData context_compiled, context_uncached;
+        context_compiled.rng.seed(42);
+        context_uncached.rng.seed(42);
+        THEN("both paths draw the same random numbers") {
+            for (size_t i = 0; i < 5; ++ i)
+                REQUIRE(parser.process(templ, 0, nullptr, &context_compiled) == parser.process_uncached(templ, 0, nullptr, &context_uncached));
+        }
+    }
+}
+
+// Run explicitly with "[PlaceholderParser][.benchmark]".
+TEST_CASE("Placeholder parser benchmark of a tool change template", "[PlaceholderParser][.benchmark]") {
+    PlaceholderParser parser;
+    parser.set("next_extruder", 2);
+    parser.set("previous_extruder", 1);
+    parser.set("max_layer_z", 3.4);
+    parser.set("toolchange_count", 5);
+    parser.set("flush_length", 120.);
+    parser.set("nozzle_temperature", new ConfigOptionInts({ 220, 220, 230, 240 }));
+    const std::string templ =
+        "M620 S[next_extruder]A\n"
+        "M204 S9000\n"
+        "G1 Z{max_layer_z + 3.0} F1200\n"
+        "{if toolchange_count > 1}G17\nG2 Z{max_layer_z + 0.4} I0.86 J0.86 P1 F10000 ; spiral lift a little from second lift\n{endif}\n"
+        "M104 S[nozzle_temperature_[next_extruder]]\n"
+        "{if flush_length > 100}G1 E{flush_length * 0.5} F{nozzle_temperature[previous_extruder] * 2}\nG1 E{flush_length * 0.5} F300\n{else}G1 E{flush_length} F300\n{endif}\n"
+        "T[next_extruder]\n"
+        "M621 S[next_extruder]A\n";
+
+    const size_t num_runs = 10000;
+    std::string  expected = parser.process(templ);
+    REQUIRE(parser.process_uncached(templ) == expected);
+    size_t       num_equal = 0;
+    auto         t_start   = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < num_runs; ++ i)
+        if (parser.process(templ) == expected)
+            ++ num_equal;
+    auto         t_compiled = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < num_runs; ++ i)
+        if (parser.process_uncached(templ) == expected)
+            ++ num_equal;
+    auto         t_uncached = std::chrono::high_resolution_clock::now();
+    REQUIRE(num_equal == 2 * num_runs);
+    double us_compiled = std::chrono::duration<double, std::micro>(t_compiled - t_start).count() / double(num_runs);
+    double us_uncached = std::chrono::duration<double, std::micro>(t_uncached - t_compiled).count() / double(num_runs);
+    INFO("PlaceholderParser::process(): " << us_compiled << " us per call, PlaceholderParser::process_uncached(): " << us_uncached << " us per call");
+    REQUIRE(us_compiled < us_uncached);
+}
@@ -0,0 +1,60 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+
+#include "libslic3r/PresetBundle.hpp"
+
+using namespace Slic3r;
+
+SCENARIO("Vendor presets are resolved in the order of their inheritance", "[PresetBundle]") {
+    // Position of a preset in the resolution order.
+    auto position = [](const std::vector<size_t> &order, size_t idx) {
+        return size_t(std::find(order.begin(), order.end(), idx) - order.begin());
+    };
+
+    GIVEN("Presets listed in the order of their inheritance") {
+        std::vector<std::pair<std::string, std::string>> presets {
+            { "fdm_process_common", "" }, { "fdm_process_bbl", "fdm_process_common" }, { "0.20mm Standard", "fdm_process_bbl" }, { "0.12mm Fine", "fdm_process_bbl" }
+        };
+        THEN("the order of the vendor profile is kept") {
+            REQUIRE(PresetBundle::vendor_presets_dependency_order(presets) == std::vector<size_t>{ 0, 1, 2, 3 });
+        }
+    }
+    GIVEN("Presets listed before the presets they inherit from") {
+        std::vector<std::pair<std::string, std::string>> presets {
+            { "0.20mm Standard", "fdm_process_bbl" }, { "0.12mm Fine", "fdm_process_bbl" }, { "fdm_process_bbl", "fdm_process_common" }, { "fdm_process_common", "" }
+        };
+        std::vector<size_t> order = PresetBundle::vendor_presets_dependency_order(presets);
+        THEN("each preset is resolved after its parent") {
+            REQUIRE(order == std::vector<size_t>{ 3, 2, 0, 1 });
+            for (size_t i = 0; i < presets.size(); ++ i)
+                for (size_t j = 0; j < presets.size(); ++ j)
+                    if (presets[i].second == presets[j].first)
+                        REQUIRE(position(order, j) < position(order, i));
+        }
+    }
+    GIVEN("Presets inheriting from presets of another vendor or collection") {
+        std::vector<std::pair<std::string, std::string>> presets {
+            { "Generic PLA @printer", "Generic PLA" }, { "Generic PETG", "fdm_filament_pet" }, { "Generic PLA", "fdm_filament_pla" }
+        };
+        THEN("the missing parents are ignored") {
+            REQUIRE(PresetBundle::vendor_presets_dependency_order(presets) == std::vector<size_t>{ 2, 0, 1 });
+        }
+    }
+    GIVEN("Presets inheriting from each other in a cycle") {
+        std::vector<std::pair<std::string, std::string>> presets {
+            { "unrelated", "" }, { "a", "c" }, { "b", "a" }, { "c", "b" }, { "self", "self" }, { "d", "a" }
+        };
+        std::vector<size_t> order = PresetBundle::vendor_presets_dependency_order(presets);
+        THEN("each preset is still resolved exactly once") {
+            REQUIRE(order.size() == presets.size());
+            std::vector<size_t> sorted = order;
+            std::sort(sorted.begin(), sorted.end());
+            REQUIRE(sorted == std::vector<size_t>{ 0, 1, 2, 3, 4, 5 });
+        }
+        THEN("the cycle is broken where it was entered") {
+            // "a" enters the cycle, its ancestors "b" and "c" are resolved before it.
+            REQUIRE(order == std::vector<size_t>{ 0, 2, 3, 1, 4, 5 });
+        }
+    }
+}
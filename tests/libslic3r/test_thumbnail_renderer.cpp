@@ -0,0 +1,52 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Model.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/GCode/ThumbnailRenderer.hpp"
+
+using namespace Slic3r;
+
+static std::array<unsigned char, 4> pixel(const ThumbnailData &data, unsigned int col, unsigned int row)
+{
+    const unsigned char *p = data.pixels.data() + 4 * (row * data.width + col);
+    return { p[0], p[1], p[2], p[3] };
+}
+
+TEST_CASE("Software thumbnail of a plate", "[Thumbnail]") {
+    Model model;
+    ModelObject *object = model.add_object();
+    object->add_volume(TriangleMesh(its_make_cube(20., 20., 20.)));
+    object->add_instance()->set_offset(Vec3d(100., 100., 0.));
+    const std::vector<std::array<float, 4>> colors { { 1.f, 0.f, 0.f, 1.f } };
+    const BoundingBoxf3 plate_volume(Vec3d(0., 0., 0.), Vec3d(256., 256., 256.));
+
+    ThumbnailData data;
+    render_thumbnail_software(data, 128, 96, ThumbnailsParams{ {}, false, true, true, true, 0 }, model.objects, plate_volume, colors);
+    REQUIRE(data.is_valid());
+    REQUIRE(data.width == 128);
+    REQUIRE(data.height == 96);
+
+    SECTION("the object is in the middle, colored by its extruder") {
+        std::array<unsigned char, 4> center = pixel(data, 64, 48);
+        REQUIRE(center[0] > 100);
+        REQUIRE(center[1] < 50);
+        REQUIRE(center[2] < 50);
+        REQUIRE(center[3] == 255);
+    }
+    SECTION("the object is surrounded by the background") {
+        for (auto [col, row] : { std::make_pair(0u, 0u), std::make_pair(127u, 0u), std::make_pair(0u, 95u), std::make_pair(127u, 95u) }) {
+            std::array<unsigned char, 4> corner = pixel(data, col, row);
+            REQUIRE(corner[0] == corner[1]);
+            REQUIRE(corner[1] == corner[2]);
+        }
+    }
+    SECTION("an object outside of the plate is not rendered") {
+        ThumbnailData empty;
+        render_thumbnail_software(empty, 128, 96, ThumbnailsParams{ {}, false, true, true, true, 0 }, model.objects,
+            BoundingBoxf3(Vec3d(300., 0., 0.), Vec3d(556., 256., 256.)), colors);
+        REQUIRE(empty.is_valid());
+        for (unsigned int row = 0; row < empty.height; ++ row)
+            for (unsigned int col = 0; col < empty.width; ++ col)
+                REQUIRE(pixel(empty, col, row) == pixel(empty, 0, 0));
+    }
+}
@@ -9,6 +9,7 @@
 #include <libslic3r/TriangleMeshSlicer.hpp>
 #include <libslic3r/SLA/SupportTreeMesher.hpp>
 #include <libslic3r/SLA/Concurrency.hpp>
+#include <libslic3r/PNGReadWrite.hpp>
 
 namespace {
 
@@ -223,6 +224,52 @@ TEST_CASE("RasterizedPolygonAreaShouldMatch", "[SLARasterOutput]") {
 }
 
 
+TEST_CASE("RLERasterShouldMatchBitmapRaster", "[SLARasterOutput]") {
+    double disp_w = 120., disp_h = 68.;
+    sla::RasterBase::Resolution res{1280, 720};
+    sla::RasterBase::PixelDim pixdim{disp_w / res.width_px, disp_h / res.height_px};
+    sla::RasterBase::Trafo trafo{sla::RasterBase::roPortrait, sla::RasterBase::MirrorX};
+    
+    sla::RasterGrayscaleAAGammaPower raster(res, pixdim, trafo, 1.);
+    sla::RasterGrayscaleAARLE rle_raster(res, pixdim, trafo, agg::gamma_power(1.));
+    
+    auto bb = BoundingBox({0, 0}, {scaled(disp_w), scaled(disp_h)});
+    
+    // Overlapping shapes, some of them partially outside the display.
+    ExPolygons polys = {square_with_hole(10.), square_with_hole(25.),
+                        square_with_hole(60.)};
+    polys[0].translate(bb.center().x(), bb.center().y());
+    polys[1].translate(bb.center().x() + scaled(4.), bb.center().y() - scaled(3.));
+    polys[2].rotate(0.3);
+    
+    for (const ExPolygon &p : polys) {
+        raster.draw(p);
+        rle_raster.draw(p);
+    }
+    
+    size_t mismatches = 0;
+    long   pxsum      = 0;
+    for (size_t r = 0; r < res.height_px; ++r)
+        for (size_t c = 0; c < res.width_px; ++c) {
+            uint8_t px = raster.read_pixel(c, r);
+            mismatches += px != rle_raster.read_pixel(c, r);
+            pxsum += px;
+        }
+    
+    REQUIRE(pxsum > 0);
+    REQUIRE(mismatches == 0);
+    
+    SECTION("Row encoded PNG should decode to the same image") {
+        auto enc = rle_raster.encode_rows(sla::PNGRasterEncoder{});
+        
+        png::ImageGreyscale img;
+        REQUIRE(png::decode_png({enc.data(), enc.size()}, img));
+        REQUIRE(img.rows == res.height_px);
+        REQUIRE(img.cols == res.width_px);
+        REQUIRE(std::accumulate(img.buf.begin(), img.buf.end(), long(0)) == pxsum);
+    }
+}
+
 TEST_CASE("halfcone test", "[halfcone]") {
     sla::DiffBridge br{Vec3d{1., 1., 1.}, Vec3d{10., 10., 10.}, 0.25, 0.5};
 